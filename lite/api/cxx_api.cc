@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 #include "lite/api/paddle_use_passes.h"
+#include "lite/core/mir/pass_utils.h"
 #include "lite/utils/io.h"
 
 namespace paddle {
@@ -128,10 +129,7 @@ lite::Tensor *Predictor::GetInput(size_t offset) {
   CHECK(input_names_.size() > offset)
       << "The network has " << input_names_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto *in_var = exec_scope_->FindVar(input_names_[offset]);
-  CHECK(in_var) << "no fatch variable " << input_names_[offset]
-                << " in exec_scope";
-  return in_var->GetMutable<lite::Tensor>();
+  return input_tensors_[offset];
 }
 #else
 lite::Tensor *Predictor::GetInput(size_t offset) {
@@ -179,6 +177,24 @@ void Predictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+#ifndef LITE_WITH_FPGA
+  // Resolve the feed and fetch tensors once, Get{Input,Output} are called for
+  // every request.
+  input_tensors_.resize(input_names_.size());
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto *in_var = exec_scope_->FindVar(input_names_[i]);
+    CHECK(in_var) << "no fatch variable " << input_names_[i]
+                  << " in exec_scope";
+    input_tensors_[i] = in_var->GetMutable<lite::Tensor>();
+  }
+  output_tensors_.resize(output_names_.size());
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    auto *out_var = exec_scope_->FindVar(output_names_[i]);
+    CHECK(out_var) << "no fatch variable " << output_names_[i]
+                   << " in exec_scope";
+    output_tensors_[i] = out_var->GetMutable<lite::Tensor>();
+  }
+#endif
 }
 
 #ifndef LITE_WITH_FPGA
@@ -187,20 +203,11 @@ const lite::Tensor *Predictor::GetOutput(size_t offset) const {
   CHECK(output_names_.size() > offset)
       << "The network has " << output_names_.size() << " outputs"
       << ", the offset should be less than this.";
-  const std::string name = output_names_.at(offset);
-  auto *out_var = exec_scope_->FindVar(name);
-  CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
-  return out_var->GetMutable<lite::Tensor>();
+  return output_tensors_[offset];
 }
 
 std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
-  std::vector<const lite::Tensor *> outputs;
-  size_t out_size = output_names_.size();
-  for (size_t i = 0; i < out_size; i++) {
-    const std::string name = output_names_.at(i);
-    outputs.push_back(GetTensor(name));
-  }
-  return outputs;
+  return output_tensors_;
 }
 #else
 
@@ -236,10 +243,12 @@ void Predictor::Build(const lite_api::CxxConfig &config,
                       const std::vector<Place> &valid_places,
                       const std::vector<std::string> &passes,
                       lite_api::LiteModelType model_type) {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   const std::string &model_path = config.model_dir();
   const std::string &model_file = config.model_file();
   const std::string &param_file = config.param_file();
   const bool model_from_memory = config.model_from_memory();
+  embedding_quant_type_ = config.embedding_quant_type();
   if (model_from_memory) {
     LOG(INFO) << "Load model from memory.";
   } else {
@@ -261,6 +270,7 @@ void Predictor::Build(const std::string &model_path,
                       const std::vector<std::string> &passes,
                       lite_api::LiteModelType model_type,
                       bool model_from_memory) {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   switch (model_type) {
     case lite_api::LiteModelType::kProtobuf: {
       bool combined_param = false;
@@ -289,6 +299,7 @@ void Predictor::Build(const std::string &model_path,
 void Predictor::Build(const cpp::ProgramDesc &desc,
                       const std::vector<Place> &valid_places,
                       const std::vector<std::string> &passes) {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   program_desc_ = desc;
   // `inner_places` is used to optimize passes
   std::vector<Place> inner_places = valid_places;
@@ -325,7 +336,36 @@ void Predictor::Build(const cpp::ProgramDesc &desc,
                         Place{TARGET(kARM), PRECISION(kInt8)});
   }
 
-  Program program(desc, scope_, inner_places);
+  // Mark the lookup_table ops whose tables will be converted by
+  // lookup_table_quantize_pass, which drops the marks. Only the ops the pass
+  // will visit are marked, those of the main block when it is not skipped.
+  if (!embedding_quant_type_.empty()) {
+    CHECK(embedding_quant_type_ == "int8" || embedding_quant_type_ == "fp16")
+        << "Unsupported embedding quant type: " << embedding_quant_type_;
+    bool has_target = false;
+    for (auto &place : inner_places) {
+      has_target |=
+          place.target == TARGET(kX86) || place.target == TARGET(kARM);
+    }
+    if (!has_target || !KernelRegistered("lookup_table_dequant",
+                                         Place(TARGET(kAny),
+                                               PRECISION(kAny),
+                                               DATALAYOUT(kAny)))) {
+      LOG(WARNING) << "The embedding tables are kept in float32, the "
+                      "lookup_table_dequant kernels are not available";
+    } else {
+      auto *block_desc = program_desc_.GetBlock<cpp::BlockDesc>(0);
+      for (size_t i = 0; i < block_desc->OpsSize(); ++i) {
+        auto *op_desc = block_desc->GetOp<cpp::OpDesc>(i);
+        if (op_desc->Type() == "lookup_table") {
+          op_desc->SetAttr<std::string>("embedding_quant_type",
+                                        embedding_quant_type_);
+        }
+      }
+    }
+  }
+
+  Program program(program_desc_, scope_, inner_places);
 
   core::KernelPickFactor factor;
   factor.ConsiderTarget();
@@ -334,10 +374,48 @@ void Predictor::Build(const cpp::ProgramDesc &desc,
 
   optimizer_.Run(std::move(program), inner_places, factor, passes);
   exec_scope_ = optimizer_.exec_scope();
+  // The weights made by the passes, such as the outputs of
+  // constant_folding_pass, live in the exec scope. Clones run in other kid
+  // scopes of the root, so share them into the root now, before any clone
+  // runs and reads the root concurrently.
+  for (auto &name : exec_scope_->LocalVarNames()) {
+    auto *var = exec_scope_->FindLocalVar(name);
+    if (!var->IsType<lite::Tensor>() || scope_->FindLocalVar(name)) continue;
+    const auto &tensor = var->Get<lite::Tensor>();
+    if (!tensor.persistable()) continue;
+    auto *weight = scope_->Var(name)->GetMutable<lite::Tensor>();
+    weight->ShareDataWith(tensor);
+    weight->set_persistable(true);
+  }
   PrepareFeedFetch();
+  memory_usage_.Reset(scope_.get(), exec_scope_);
+  memory_usage_.Record();
+}
+
+std::unique_ptr<Predictor> Predictor::Clone() {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  // Record the picked kernels in the program desc, as SaveModel does.
+  program_->SaveOpInfosToProgram(&program_desc_);
+  program_->UpdateVarsOfProgram(&program_desc_);
+
+  std::unique_ptr<Predictor> predictor(new Predictor(scope_));
+  host::ScopedAllocatorStats stats_guard(predictor->allocator_stats_);
+  predictor->program_desc_ = program_desc_;
+  predictor->embedding_quant_type_ = embedding_quant_type_;
+  predictor->program_.reset(
+      new RuntimeProgram(predictor->program_desc_, scope_));
+  predictor->exec_scope_ = predictor->program_->exec_scope();
+  predictor->program_generated_ = true;
+  predictor->PrepareFeedFetch();
+  predictor->memory_usage_.Reset(scope_.get(), predictor->exec_scope_);
+  predictor->memory_usage_.Record();
+  return predictor;
 }
 
 void Predictor::GenRuntimeProgram() {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   program_ = optimizer_.GenRuntimeProgram();
   CHECK_EQ(exec_scope_, program_->exec_scope());
   program_generated_ = true;
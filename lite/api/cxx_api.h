@@ -19,7 +19,9 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/memory_usage.h"
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/allocator.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer.h"
 #include "lite/core/program.h"
@@ -70,12 +72,19 @@ class LITE_API Predictor {
 
   void GenRuntimeProgram();
 
+  // Create a predictor sharing the weights and the optimized program with
+  // this built one, with its own scope for the intermediate results.
+  std::unique_ptr<Predictor> Clone();
+
   // Run the predictor for a single batch of data.
   void Run() {
+    std::lock_guard<std::mutex> lock(memory_usage_.mutex());
+    host::ScopedAllocatorStats stats_guard(allocator_stats_);
     if (!program_generated_) {
       GenRuntimeProgram();
     }
     program_->Run();
+    memory_usage_.Record();
   }
 
   // Get offset-th col of feed inputs.
@@ -92,8 +101,18 @@ class LITE_API Predictor {
   std::vector<const lite::Tensor*> GetOutputs() const;
 
   const cpp::ProgramDesc& program_desc() const;
+  // The root scope, holding the weights.
+  Scope* scope() { return scope_.get(); }
   const lite::Tensor* GetTensor(const std::string& name) const;
   const RuntimeProgram& runtime_program() const;
+  // Host memory allocated while building and running this predictor.
+  const host::AllocatorStats& allocator_stats() const {
+    return *allocator_stats_;
+  }
+  // Memory held by this predictor, see lite_api::MemoryUsage.
+  lite_api::MemoryUsage GetMemoryUsage(bool per_tensor) const {
+    return memory_usage_.Get(*allocator_stats_, per_tensor);
+  }
 
   // This method is disabled in mobile, for unnecessary dependencies required.
   void SaveModel(
@@ -120,11 +139,19 @@ class LITE_API Predictor {
   bool program_generated_{false};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  std::vector<lite::Tensor*> input_tensors_;
+  std::vector<const lite::Tensor*> output_tensors_;
+  // The storage type of the lookup_table tables, see
+  // CxxConfig::set_embedding_quant_type.
+  std::string embedding_quant_type_;
+  std::shared_ptr<host::AllocatorStats> allocator_stats_{
+      std::make_shared<host::AllocatorStats>()};
+  MemoryUsageRecorder memory_usage_;
 };
 
 class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
  public:
-  CxxPaddleApiImpl() {}
+  CxxPaddleApiImpl() : raw_predictor_(new Predictor) {}
 
   /// Create a new predictor from a config.
   void Init(const lite_api::CxxConfig& config);
@@ -155,10 +182,16 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool record_info = false) override;
 
+  lite_api::MemoryUsage GetMemoryUsage(bool per_tensor = false) const override;
+
  private:
-  Predictor raw_predictor_;
+  std::unique_ptr<Predictor> raw_predictor_;
   lite_api::CxxConfig config_;
   std::mutex mutex_;
+#ifdef LITE_WITH_X86
+  // The CPUs the running threads are bound to, empty when not bound.
+  std::vector<int> x86_cpus_;
+#endif
 };
 
 /*
@@ -24,6 +24,10 @@
 #include "lite/api/paddle_use_passes.h"
 #endif
 
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/cpu_info.h"
+#endif
+
 #if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
     !(defined LITE_ON_MODEL_OPTIMIZE_TOOL) && !defined(__APPLE__)
 #include <omp.h>
@@ -68,7 +72,41 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     passes = {"type_layout_cast_preprocess_pass"};
     VLOG(1) << "add pass:" << passes[0];
   }
-  raw_predictor_.Build(config, places, passes);
+#ifdef LITE_WITH_X86
+  x86_cpus_ = config.x86_cpu_affinity();
+  if (x86_cpus_.empty() && config.x86_numa_node() >= 0) {
+    x86_cpus_ = x86::GetCpuTopology().CpusOfNode(config.x86_numa_node());
+  }
+  // Bound before building, so the weights are first touched by local CPUs.
+  // The caller's thread gets its CPUs back once the weights are in place.
+  std::vector<int> caller_cpus;
+  if (!x86_cpus_.empty()) {
+    caller_cpus = x86::ThreadCpus();
+    if (!x86::BindThreadsToCpus(x86_cpus_)) {
+      LOG(WARNING) << "Failed to bind the predictor threads to the given CPUs";
+    }
+  }
+#endif
+  raw_predictor_->Build(config, places, passes);
+#ifdef LITE_WITH_X86
+  // The weights may sit in blocks cached from other nodes, move them.
+  if (config.x86_numa_node() >= 0) {
+    auto *scope = raw_predictor_->scope();
+    for (const auto &name : scope->LocalVarNames()) {
+      auto *var = scope->FindLocalVar(name);
+      if (!var->IsType<lite::Tensor>()) continue;
+      const auto &tensor = var->Get<lite::Tensor>();
+      if (tensor.persistable() && (tensor.target() == TARGET(kHost) ||
+                                   tensor.target() == TARGET(kX86))) {
+        x86::BindMemoryToNode(
+            tensor.raw_data(), tensor.memory_size(), config.x86_numa_node());
+      }
+    }
+  }
+  if (!caller_cpus.empty() && !x86::BindThreadsToCpus(caller_cpus)) {
+    LOG(WARNING) << "Failed to restore the CPUs of the calling thread";
+  }
+#endif
   mode_ = config.power_mode();
   threads_ = config.threads();
 #if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
@@ -84,22 +122,22 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
-  auto *x = raw_predictor_.GetInput(i);
+  auto *x = raw_predictor_->GetInput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetOutput(
     int i) const {
-  const auto *x = raw_predictor_.GetOutput(i);
+  const auto *x = raw_predictor_->GetOutput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::vector<std::string> CxxPaddleApiImpl::GetInputNames() {
-  return raw_predictor_.GetInputNames();
+  return raw_predictor_->GetInputNames();
 }
 
 std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
-  return raw_predictor_.GetOutputNames();
+  return raw_predictor_->GetOutputNames();
 }
 
 void CxxPaddleApiImpl::Run() {
@@ -110,13 +148,38 @@ void CxxPaddleApiImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
-  raw_predictor_.Run();
+#ifdef LITE_WITH_X86
+  if (!x86_cpus_.empty()) {
+    // Predictors may run on other threads than the one building them.
+    thread_local std::vector<int> bound_cpus;
+    if (bound_cpus != x86_cpus_ && x86::BindThreadsToCpus(x86_cpus_)) {
+      bound_cpus = x86_cpus_;
+    }
+  }
+#endif
+  raw_predictor_->Run();
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor = std::make_shared<lite::CxxPaddleApiImpl>();
-  predictor->Init(config_);
+  predictor->raw_predictor_ = raw_predictor_->Clone();
+  predictor->config_ = config_;
+  predictor->mode_ = mode_;
+  predictor->threads_ = threads_;
+#ifdef LITE_WITH_MLU
+  lite::TargetWrapperMlu::SetMLURunMode(
+      reinterpret_cast<int64_t>(predictor.get()),
+      config_.mlu_core_version(),
+      config_.mlu_core_number(),
+      config_.mlu_use_first_conv(),
+      config_.mlu_first_conv_mean(),
+      config_.mlu_first_conv_std(),
+      config_.mlu_input_layout());
+#endif  // LITE_WITH_MLU
+#ifdef LITE_WITH_X86
+  predictor->x86_cpus_ = x86_cpus_;
+#endif
   return predictor;
 }
 
@@ -124,20 +187,24 @@ std::string CxxPaddleApiImpl::GetVersion() const { return version(); }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
     const std::string &name) const {
-  auto *x = raw_predictor_.GetTensor(name);
+  auto *x = raw_predictor_->GetTensor(name);
   return std::unique_ptr<const lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
     const std::string &name) {
   return std::unique_ptr<lite_api::Tensor>(
-      new lite_api::Tensor(raw_predictor_.GetInputByName(name)));
+      new lite_api::Tensor(raw_predictor_->GetInputByName(name)));
 }
 
 void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
                                           lite_api::LiteModelType model_type,
                                           bool record_info) {
-  raw_predictor_.SaveModel(model_dir, model_type, record_info);
+  raw_predictor_->SaveModel(model_dir, model_type, record_info);
+}
+
+lite_api::MemoryUsage CxxPaddleApiImpl::GetMemoryUsage(bool per_tensor) const {
+  return raw_predictor_->GetMemoryUsage(per_tensor);
 }
 
 }  // namespace lite
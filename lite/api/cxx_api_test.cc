@@ -15,6 +15,9 @@
 #include "lite/api/cxx_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>  // NOLINT
 #include <vector>
 #include "lite/api/lite_api_test_helper.h"
 #include "lite/api/paddle_use_kernels.h"
@@ -86,6 +89,168 @@ TEST(CXXApi, save_model) {
 }*/
 #endif  // LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
 
+#ifdef LITE_WITH_X86
+// out = x + w, `w_alias` shares the buffer of w.
+TEST(CXXApi, memory_usage) {
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "w", "out"}) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var->SetDataType(VarDescAPI::Type::FP32);
+    var->SetPersistable(std::string(name) == "w");
+  }
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  auto* add = block->AddOp<cpp::OpDesc>();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"x"});
+  add->SetInput("Y", {"w"});
+  add->SetOutput("Out", {"out"});
+  add->SetAttr<int>("axis", -1);
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+
+  const int64_t n = 16;
+  auto scope = std::make_shared<Scope>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize(std::vector<int64_t>({n}));
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < n; i++) w_data[i] = i;
+  w->set_persistable(true);
+  scope->Var("w_alias")->GetMutable<Tensor>()->ShareDataWith(*w);
+
+  Predictor predictor(scope);
+  predictor.Build(desc, {Place{TARGET(kX86), PRECISION(kFloat)}});
+  auto usage = predictor.GetMemoryUsage(false);
+  EXPECT_EQ(usage.weight_bytes, n * sizeof(float));
+  EXPECT_EQ(usage.activation_bytes, 0);
+
+  auto run = [&](int64_t batch) {
+    auto* x = predictor.GetInput(0);
+    x->Resize(std::vector<int64_t>({batch, n}));
+    auto* x_data = x->mutable_data<float>();
+    for (int i = 0; i < batch * n; i++) x_data[i] = 1.f;
+    predictor.Run();
+  };
+  run(1);
+  EXPECT_EQ(predictor.GetOutput(0)->data<float>()[3], 4.f);
+  usage = predictor.GetMemoryUsage(true);
+  EXPECT_EQ(usage.weight_bytes, n * sizeof(float));
+  EXPECT_EQ(usage.peak_weight_bytes, n * sizeof(float));
+  EXPECT_EQ(usage.activation_bytes, 2 * n * sizeof(float));
+  bool has_alias = false;
+  for (auto& tensor : usage.tensors) {
+    if (tensor.first == "w_alias") {
+      has_alias = true;
+      EXPECT_EQ(tensor.second, n * sizeof(float));
+    }
+  }
+  EXPECT_TRUE(has_alias);
+
+  // Polled from another thread while running, it sees the totals of a whole
+  // run, never those of a run in progress.
+  std::atomic<bool> done{false};
+  std::atomic<int> bad{0};
+  std::thread poller([&] {
+    while (!done) {
+      auto u = predictor.GetMemoryUsage(false);
+      bad += u.weight_bytes != n * sizeof(float);
+      bad += u.activation_bytes % (2 * n * sizeof(float)) != 0;
+    }
+  });
+  for (int k = 0; k < 200; k++) run(k % 2 + 1);
+  done = true;
+  poller.join();
+  EXPECT_EQ(bad, 0);
+
+  // A smaller input shrinks the activations, their peak stays.
+  run(1);
+  usage = predictor.GetMemoryUsage(false);
+  EXPECT_EQ(usage.activation_bytes, 2 * n * sizeof(float));
+  EXPECT_EQ(usage.peak_activation_bytes, 4 * n * sizeof(float));
+  EXPECT_GE(usage.peak_workspace_bytes, usage.workspace_bytes);
+}
+
+// out = x + (2 * w + 1), the scale of the weight is folded by
+// constant_folding_pass into a new weight shared with the clones.
+TEST(CXXApi, clone_folded_weights) {
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "w", "w2", "out"}) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var->SetDataType(VarDescAPI::Type::FP32);
+    var->SetPersistable(std::string(name) == "w");
+  }
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  auto* scale = block->AddOp<cpp::OpDesc>();
+  scale->SetType("scale");
+  scale->SetInput("X", {"w"});
+  scale->SetOutput("Out", {"w2"});
+  scale->SetAttr<float>("scale", 2.f);
+  scale->SetAttr<float>("bias", 1.f);
+  scale->SetAttr<bool>("bias_after_scale", true);
+  auto* add = block->AddOp<cpp::OpDesc>();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"x"});
+  add->SetInput("Y", {"w2"});
+  add->SetOutput("Out", {"out"});
+  add->SetAttr<int>("axis", -1);
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+
+  const int64_t n = 16;
+  auto scope = std::make_shared<Scope>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize(std::vector<int64_t>({n}));
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < n; i++) w_data[i] = i;
+  w->set_persistable(true);
+
+  Predictor predictor(scope);
+  predictor.Build(desc, {Place{TARGET(kX86), PRECISION(kFloat)}});
+  for (auto& inst : predictor.runtime_program().instructions()) {
+    EXPECT_NE(inst.op()->op_info()->Type(), "scale");
+  }
+  auto clone = predictor.Clone();
+
+  auto run = [&](Predictor* p, float value) {
+    auto* x = p->GetInput(0);
+    x->Resize(std::vector<int64_t>({1, n}));
+    auto* x_data = x->mutable_data<float>();
+    for (int i = 0; i < n; i++) x_data[i] = value;
+    p->Run();
+    auto* out = p->GetOutput(0)->data<float>();
+    int wrong = 0;
+    for (int i = 0; i < n; i++) wrong += out[i] != value + 2 * i + 1;
+    return wrong;
+  };
+  std::atomic<int> wrong{0};
+  std::thread other([&] {
+    for (int k = 0; k < 50; k++) wrong += run(clone.get(), 10.f);
+  });
+  for (int k = 0; k < 50; k++) wrong += run(&predictor, 1.f);
+  other.join();
+  EXPECT_EQ(wrong, 0);
+}
+#endif  // LITE_WITH_X86
+
 #ifdef LITE_WITH_ARM
 TEST(CXXApi, save_model) {
   lite::Predictor predictor;
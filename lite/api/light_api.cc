@@ -23,6 +23,7 @@ namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
                            bool model_from_memory) {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   if (model_from_memory) {
     LoadModelNaiveFromMemory(lite_model_file, scope_.get(), &cpp_program_desc_);
   } else {
@@ -42,6 +43,7 @@ void LightPredictor::Build(const std::string& model_dir,
                            const std::string& param_buffer,
                            lite_api::LiteModelType model_type,
                            bool model_from_memory) {
+  host::ScopedAllocatorStats stats_guard(allocator_stats_);
   switch (model_type) {
 #ifndef LITE_ON_TINY_PUBLISH
     case lite_api::LiteModelType::kProtobuf:
@@ -70,10 +72,7 @@ Tensor* LightPredictor::GetInput(size_t offset) {
   CHECK(input_names_.size() > offset)
       << "The network has " << input_names_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto* in_var = program_->exec_scope()->FindVar(input_names_[offset]);
-  CHECK(in_var) << "no fatch variable " << input_names_[offset]
-                << " in exec_scope";
-  return in_var->GetMutable<lite::Tensor>();
+  return input_tensors_[offset];
 }
 
 // get input by name
@@ -96,10 +95,7 @@ const Tensor* LightPredictor::GetOutput(size_t offset) {
   CHECK(output_names_.size() > offset)
       << "The network has " << output_names_.size() << " outputs"
       << ", the offset should be less than this.";
-  auto* out_var = program_->exec_scope()->FindVar(output_names_.at(offset));
-  CHECK(out_var) << "no fatch variable " << output_names_.at(offset)
-                 << " in exec_scope";
-  return out_var->GetMutable<lite::Tensor>();
+  return output_tensors_[offset];
 }
 // get inputs names
 std::vector<std::string> LightPredictor::GetInputNames() {
@@ -132,53 +128,29 @@ void LightPredictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+  // Resolve the feed and fetch tensors once, Get{Input,Output} are called for
+  // every request.
+  auto* exec_scope = program_->exec_scope();
+  input_tensors_.resize(input_names_.size());
+  for (size_t i = 0; i < input_names_.size(); i++) {
+    auto* in_var = exec_scope->FindVar(input_names_[i]);
+    CHECK(in_var) << "no fatch variable " << input_names_[i]
+                  << " in exec_scope";
+    input_tensors_[i] = in_var->GetMutable<lite::Tensor>();
+  }
+  output_tensors_.resize(output_names_.size());
+  for (size_t i = 0; i < output_names_.size(); i++) {
+    auto* out_var = exec_scope->FindVar(output_names_[i]);
+    CHECK(out_var) << "no fatch variable " << output_names_[i]
+                   << " in exec_scope";
+    output_tensors_[i] = out_var->GetMutable<lite::Tensor>();
+  }
 }
 
 void LightPredictor::BuildRuntimeProgram(const cpp::ProgramDesc& prog) {
-  std::vector<Instruction> insts;
-  // 1. Create op first
-  Program program(prog, scope_, {});
-
-// 2. Create Instructs
-#ifdef LITE_WITH_OPENCL
-  using OpenCLContext = Context<TargetType::kOpenCL>;
-  std::unique_ptr<KernelContext> local_ctx(new KernelContext());
-  local_ctx->As<OpenCLContext>().InitOnce();
-#endif
-
-  // Create the kernels of the target places, and filter out the specific
-  // kernel with the target alias.
-  for (auto& op : program.ops()) {
-    auto kernel_type = op->op_info()->GetAttr<std::string>(kKernelTypeAttr);
-    std::string op_type, alias;
-    Place place;
-    KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
-    auto kernels = op->CreateKernels({place});
-    // filter out a kernel
-    auto it = std::find_if(
-        kernels.begin(), kernels.end(), [&](std::unique_ptr<KernelBase>& it) {
-          return it->alias() == alias;
-        });
-    CHECK(it != kernels.end());
-
-#ifdef LITE_WITH_OPENCL
-    if ((*it)->target() == TARGET(kOpenCL)) {
-      std::unique_ptr<KernelContext> ctx(new KernelContext());
-      (*local_ctx).As<OpenCLContext>().CopySharedTo(&ctx->As<OpenCLContext>());
-      (*it)->SetContext(std::move(ctx));
-    } else {
-      (*it)->SetContext(ContextScheduler::Global().NewContext((*it)->target()));
-    }
-#else
-    (*it)->SetContext(ContextScheduler::Global().NewContext((*it)->target()));
-#endif
-
-    insts.emplace_back(op, std::move(*it));
-  }
-  program_.reset(new RuntimeProgram(std::move(insts)));
-
-  CHECK(program.exec_scope());
-  program_->set_exec_scope(program.exec_scope());
+  program_.reset(new RuntimeProgram(prog, scope_));
+  memory_usage_.Reset(scope_.get(), program_->exec_scope());
+  memory_usage_.Record();
 }
 
 void LightPredictor::DequantizeWeight() {
@@ -24,7 +24,9 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/memory_usage.h"
 #include "lite/api/paddle_api.h"
+#include "lite/backends/host/allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
@@ -60,7 +62,19 @@ class LITE_API LightPredictor {
     Build(model_dir, model_buffer, param_buffer, model_type, model_from_memory);
   }
 
-  void Run() { program_->Run(); }
+  // Create a predictor sharing the weights with this one, with its own scope
+  // for the intermediate results.
+  std::unique_ptr<LightPredictor> Clone() const {
+    return std::unique_ptr<LightPredictor>(
+        new LightPredictor(scope_, cpp_program_desc_));
+  }
+
+  void Run() {
+    std::lock_guard<std::mutex> lock(memory_usage_.mutex());
+    host::ScopedAllocatorStats stats_guard(allocator_stats_);
+    program_->Run();
+    memory_usage_.Record();
+  }
 
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
@@ -79,6 +93,15 @@ class LITE_API LightPredictor {
   std::vector<std::string> GetOutputNames();
   void PrepareFeedFetch();
 
+  // Host memory allocated while building and running this predictor.
+  const host::AllocatorStats& allocator_stats() const {
+    return *allocator_stats_;
+  }
+  // Memory held by this predictor, see lite_api::MemoryUsage.
+  lite_api::MemoryUsage GetMemoryUsage(bool per_tensor) const {
+    return memory_usage_.Get(*allocator_stats_, per_tensor);
+  }
+
  private:
   void Build(const std::string& lite_model_file,
              bool model_from_memory = false);
@@ -91,6 +114,15 @@ class LITE_API LightPredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool model_from_memory = false);
 
+  // Used by Clone, the weights in `scope` are ready.
+  LightPredictor(const std::shared_ptr<Scope>& scope,
+                 const cpp::ProgramDesc& desc)
+      : scope_(scope), cpp_program_desc_(desc) {
+    host::ScopedAllocatorStats stats_guard(allocator_stats_);
+    BuildRuntimeProgram(cpp_program_desc_);
+    PrepareFeedFetch();
+  }
+
   void BuildRuntimeProgram(const cpp::ProgramDesc& prog);
 
   void DequantizeWeight();
@@ -101,6 +133,11 @@ class LITE_API LightPredictor {
   cpp::ProgramDesc cpp_program_desc_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  std::vector<Tensor*> input_tensors_;
+  std::vector<const Tensor*> output_tensors_;
+  std::shared_ptr<host::AllocatorStats> allocator_stats_{
+      std::make_shared<host::AllocatorStats>()};
+  MemoryUsageRecorder memory_usage_;
 };
 
 class LightPredictorImpl : public lite_api::PaddlePredictor {
@@ -125,6 +162,8 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   std::unique_ptr<lite_api::Tensor> GetInputByName(
       const std::string& name) override;
 
+  lite_api::MemoryUsage GetMemoryUsage(bool per_tensor = false) const override;
+
   void Init(const lite_api::MobileConfig& config);
 
  private:
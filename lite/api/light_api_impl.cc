@@ -57,8 +57,11 @@ void LightPredictorImpl::Run() {
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone() {
-  LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
-  return nullptr;
+  auto predictor = std::make_shared<LightPredictorImpl>();
+  predictor->raw_predictor_ = raw_predictor_->Clone();
+  predictor->mode_ = mode_;
+  predictor->threads_ = threads_;
+  return predictor;
 }
 
 std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
@@ -82,6 +85,11 @@ std::vector<std::string> LightPredictorImpl::GetOutputNames() {
   return raw_predictor_->GetOutputNames();
 }
 
+lite_api::MemoryUsage LightPredictorImpl::GetMemoryUsage(
+    bool per_tensor) const {
+  return raw_predictor_->GetMemoryUsage(per_tensor);
+}
+
 }  // namespace lite
 
 namespace lite_api {
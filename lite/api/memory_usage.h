@@ -0,0 +1,195 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>  //NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/backends/host/allocator.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+
+// Bytes of the buffers, keyed by their beginning so that a buffer shared by
+// several tensors is counted once.
+using BufferBytes = std::map<const void*, int64_t>;
+
+inline void CollectTensorBytes(
+    const std::string& name,
+    const Tensor& tensor,
+    BufferBytes* bytes,
+    std::vector<std::pair<std::string, int64_t>>* tensors) {
+  if (!tensor.IsInitialized()) return;
+  auto* begin = static_cast<const char*>(tensor.raw_data()) - tensor.offset();
+  int64_t end = tensor.offset() + tensor.memory_size();
+  auto& size = (*bytes)[begin];
+  size = std::max(size, end);
+  if (tensors) tensors->emplace_back(name, tensor.memory_size());
+}
+
+// Collects the tensors of `scope` to `tensor_bytes`, and the tensor lists,
+// such as feed and fetch, to `list_bytes`.
+inline void CollectScopeBytes(
+    const Scope& scope,
+    BufferBytes* tensor_bytes,
+    BufferBytes* list_bytes,
+    std::vector<std::pair<std::string, int64_t>>* tensors) {
+  for (auto& name : scope.LocalVarNames()) {
+    auto* var = scope.FindLocalVar(name);
+    if (var->IsType<Tensor>()) {
+      CollectTensorBytes(name, var->Get<Tensor>(), tensor_bytes, tensors);
+    } else if (var->IsType<std::vector<Tensor>>()) {
+      auto& list = var->Get<std::vector<Tensor>>();
+      for (size_t i = 0; i < list.size(); i++) {
+        CollectTensorBytes(
+            name + "[" + std::to_string(i) + "]", list[i], list_bytes, tensors);
+      }
+    }
+  }
+}
+
+// Records the memory held by a predictor so that it can be read from any
+// thread while the predictor runs. The thread running the predictor holds
+// mutex() during a run and records the totals after it.
+class MemoryUsageRecorder {
+ public:
+  std::mutex& mutex() const { return mutex_; }
+
+  // Takes the tensors of a built predictor whose weights live in
+  // `root_scope` and whose intermediate results live in `exec_scope`. The
+  // variables of a built program do not change, so they are looked up once.
+  void Reset(const Scope* root_scope, const Scope* exec_scope) {
+    root_scope_ = root_scope;
+    exec_scope_ = exec_scope != root_scope ? exec_scope : nullptr;
+    weights_.Clear();
+    activations_.Clear();
+    TakeScope(*root_scope_, true, &weights_, &activations_);
+    if (exec_scope_) {
+      TakeScope(*exec_scope_, false, &weights_, &activations_);
+    }
+  }
+
+  // Records the current sizes, called after building and, with mutex() held,
+  // after every run.
+  void Record() {
+    weights_.Record();
+    activations_.Record();
+  }
+
+  // The totals are those of the last record. Listing the tensors waits for
+  // the running predictor to finish its run.
+  lite_api::MemoryUsage Get(const host::AllocatorStats& stats,
+                            bool per_tensor) const {
+    lite_api::MemoryUsage usage;
+    if (per_tensor && root_scope_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      BufferBytes weights;
+      BufferBytes activations;
+      CollectScopeBytes(
+          *root_scope_, &weights, &activations, &usage.tensors);
+      if (exec_scope_) {
+        CollectScopeBytes(
+            *exec_scope_, &activations, &activations, &usage.tensors);
+      }
+    }
+    usage.weight_bytes = weights_.bytes;
+    usage.peak_weight_bytes = weights_.peak_bytes;
+    usage.activation_bytes = activations_.bytes;
+    usage.peak_activation_bytes = activations_.peak_bytes;
+    usage.workspace_bytes = WorkSpace::host_bytes();
+    usage.peak_workspace_bytes = WorkSpace::peak_host_bytes();
+    usage.allocated_bytes = stats.bytes_in_use;
+    usage.peak_allocated_bytes = stats.peak_bytes_in_use;
+    return usage;
+  }
+
+ private:
+  struct Category {
+    std::vector<const Tensor*> tensors;
+    std::vector<const std::vector<Tensor>*> lists;
+    // Beginning and end of the buffers, kept to save allocations per run.
+    std::vector<std::pair<const char*, int64_t>> buffers;
+    std::atomic<int64_t> bytes{0};
+    std::atomic<int64_t> peak_bytes{0};
+
+    void Clear() {
+      tensors.clear();
+      lists.clear();
+    }
+
+    void Add(const Tensor& tensor) {
+      if (!tensor.IsInitialized()) return;
+      buffers.emplace_back(
+          static_cast<const char*>(tensor.raw_data()) - tensor.offset(),
+          tensor.offset() + tensor.memory_size());
+    }
+
+    void Record() {
+      buffers.clear();
+      for (auto* tensor : tensors) Add(*tensor);
+      for (auto* list : lists) {
+        for (auto& tensor : *list) Add(tensor);
+      }
+      // A buffer shared by several tensors is counted once, by the tensor
+      // reaching the farthest into it.
+      std::sort(buffers.begin(), buffers.end());
+      int64_t sum = 0;
+      for (size_t i = 0; i < buffers.size(); i++) {
+        if (i + 1 < buffers.size() &&
+            buffers[i + 1].first == buffers[i].first) {
+          continue;
+        }
+        sum += buffers[i].second;
+      }
+      bytes = sum;
+      if (sum > peak_bytes) peak_bytes = sum;
+    }
+  };
+
+  // The tensors of the root scope are weights, and so are the persistable
+  // ones made in the exec scope by the passes, e.g. constant_folding_pass.
+  static void TakeScope(const Scope& scope,
+                        bool is_root,
+                        Category* weights,
+                        Category* activations) {
+    for (auto& name : scope.LocalVarNames()) {
+      auto* var = scope.FindLocalVar(name);
+      if (var->IsType<Tensor>()) {
+        auto& tensor = var->Get<Tensor>();
+        auto* category =
+            is_root || tensor.persistable() ? weights : activations;
+        category->tensors.push_back(&tensor);
+      } else if (var->IsType<std::vector<Tensor>>()) {
+        activations->lists.push_back(&var->Get<std::vector<Tensor>>());
+      }
+    }
+  }
+
+  mutable std::mutex mutex_;
+  const Scope* root_scope_{nullptr};
+  const Scope* exec_scope_{nullptr};
+  Category weights_;
+  Category activations_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -68,6 +68,10 @@ DEFINE_string(valid_targets,
               "arm",
               "The targets this model optimized for, should be one of (arm, "
               "opencl, x86), splitted by space");
+DEFINE_string(quant_embedding,
+              "",
+              "Store the tables of lookup_table in the optimized model as "
+              "int8 (row-wise min/max) or fp16, empty to keep float32");
 DEFINE_bool(print_supported_ops,
             false,
             "Print supported operators on the inputed target");
@@ -147,6 +151,7 @@ void RunOptimize(const std::string& model_dir,
   config.set_model_file(model_file);
   config.set_param_file(param_file);
   config.set_valid_places(valid_places);
+  config.set_embedding_quant_type(FLAGS_quant_embedding);
   auto predictor = lite_api::CreatePaddlePredictor(config);
 
   LiteModelType model_type;
@@ -258,6 +263,7 @@ void PrintHelpInfo() {
       "        `--optimize_out=<output_optimize_model_dir>`\n"
       "        `--valid_targets=(arm|opencl|x86|npu|xpu|rknpu)`\n"
       "        `--record_tailoring_info=(true|false)`\n"
+      "        `--quant_embedding=(int8|fp16)`\n"
       "  Arguments of model checking and ops information:\n"
       "        `--print_all_ops=true`   Display all the valid operators of "
       "Paddle-Lite\n"
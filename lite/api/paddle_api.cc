@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "lite/api/paddle_api.h"
+#include <thread>  // NOLINT
 
+#include "lite/backends/host/allocator.h"
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
 #include "lite/core/target_wrapper.h"
@@ -198,6 +200,65 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+MemoryUsage PaddlePredictor::GetMemoryUsage(bool per_tensor) const {
+  LOG(FATAL) << "The GetMemoryUsage API is not supported by this predictor.";
+  return MemoryUsage();
+}
+
+PredictorPool::PredictorPool(const std::shared_ptr<PaddlePredictor> &predictor,
+                             int size)
+    : slots_(std::make_shared<Slots>()) {
+  CHECK(predictor);
+  CHECK_GT(size, 0);
+  slots_->predictors.push_back(predictor);
+  for (int i = 1; i < size; i++) {
+    slots_->predictors.push_back(predictor->Clone());
+  }
+  slots_->busy.reset(new std::atomic<bool>[size]);
+  for (int i = 0; i < size; i++) {
+    slots_->busy[i].store(false);
+  }
+}
+
+void PredictorPool::WarmUp(
+    const std::function<void(PaddlePredictor *)> &feed) {
+  for (auto &predictor : slots_->predictors) {
+    feed(predictor.get());
+    predictor->Run();
+  }
+}
+
+std::shared_ptr<PaddlePredictor> PredictorPool::Acquire() {
+  // The pool and the slot this thread took last.
+  thread_local std::pair<const Slots *, size_t> last{nullptr, 0};
+  const size_t num = slots_->predictors.size();
+  size_t start = last.first == slots_.get()
+                     ? last.second
+                     : std::hash<std::thread::id>()(std::this_thread::get_id());
+  for (;;) {
+    for (size_t k = 0; k < num; k++) {
+      size_t i = (start + k) % num;
+      auto &busy = slots_->busy[i];
+      bool expected = false;
+      if (!busy.load(std::memory_order_relaxed) &&
+          busy.compare_exchange_strong(expected, true,
+                                       std::memory_order_acquire)) {
+        last = std::make_pair(slots_.get(), i);
+        auto slots = slots_;
+        return std::shared_ptr<PaddlePredictor>(
+            slots->predictors[i].get(), [slots, i](PaddlePredictor *) {
+              slots->busy[i].store(false, std::memory_order_release);
+            });
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+int PredictorPool::size() const {
+  return static_cast<int>(slots_->predictors.size());
+}
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
@@ -228,6 +289,28 @@ void ConfigBase::set_threads(int threads) {
 #endif
 }
 
+void ConfigBase::set_huge_pages(HugePageMode mode) {
+  switch (mode) {
+    case LITE_HUGE_PAGES_NONE:
+      lite::host::SetHugePages(lite::host::HugePages::kNone);
+      break;
+    case LITE_HUGE_PAGES_TRANSPARENT:
+      lite::host::SetHugePages(lite::host::HugePages::kTransparent);
+      break;
+    case LITE_HUGE_PAGES_EXPLICIT:
+      lite::host::SetHugePages(lite::host::HugePages::kExplicit);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported huge page mode " << static_cast<int>(mode);
+  }
+  huge_pages_ = mode;
+}
+
+void ConfigBase::set_zero_host_memory(bool zero) {
+  lite::host::SetZeroOnMalloc(zero);
+  zero_host_memory_ = zero;
+}
+
 #ifdef LITE_WITH_MLU
 void CxxConfig::set_mlu_core_version(lite_api::MLUCoreVersion core_version) {
   mlu_core_version_ = core_version;
@@ -19,8 +19,11 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "paddle_place.h"  // NOLINT
 
@@ -65,6 +68,27 @@ struct LITE_API Tensor {
   void* raw_tensor_;
 };
 
+/// Memory held by a predictor, in bytes, each with its peak. A buffer shared by
+/// several tensors is counted once.
+struct LITE_API MemoryUsage {
+  // Weights, the tensors of the root scope, as of the last run.
+  int64_t weight_bytes{0};
+  int64_t peak_weight_bytes{0};
+  // Intermediate results, the inputs and the outputs, as of the last run.
+  int64_t activation_bytes{0};
+  int64_t peak_activation_bytes{0};
+  // Kernel scratch memory of all the threads in this process, it is shared by
+  // all the predictors.
+  int64_t workspace_bytes{0};
+  int64_t peak_workspace_bytes{0};
+  // Host memory allocated while building and running the predictor that is
+  // still in use, and the peak of it.
+  int64_t allocated_bytes{0};
+  int64_t peak_allocated_bytes{0};
+  // Name and size of every tensor, only filled on request.
+  std::vector<std::pair<std::string, int64_t>> tensors;
+};
+
 /// The PaddlePredictor defines the basic interfaces for different kinds of
 /// predictors.
 class LITE_API PaddlePredictor {
@@ -101,6 +125,12 @@ class LITE_API PaddlePredictor {
       LiteModelType model_type = LiteModelType::kProtobuf,
       bool record_info = false);
 
+  /// Get the memory held by this predictor, with the size of every tensor if
+  /// `per_tensor` is set. The sizes are recorded after building and after
+  /// every run, so it can be polled from any thread. Listing the tensors waits
+  /// for the current run to finish.
+  virtual MemoryUsage GetMemoryUsage(bool per_tensor = false) const;
+
   virtual ~PaddlePredictor() = default;
 
  protected:
@@ -108,11 +138,41 @@ class LITE_API PaddlePredictor {
   lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
 };
 
+/// A fixed set of predictors sharing the weights of one, to serve requests
+/// from many threads. A thread gets back the predictor it used last when that
+/// one is free, whose intermediate results are likely still in its caches.
+class LITE_API PredictorPool {
+ public:
+  /// Hold `predictor` and `size - 1` clones of it.
+  PredictorPool(const std::shared_ptr<PaddlePredictor>& predictor, int size);
+
+  /// Run every predictor once on the inputs set by `feed`, so the first
+  /// requests do not pay for the memory taken by the first run. Call it with
+  /// the largest shapes expected, before any predictor is acquired.
+  void WarmUp(const std::function<void(PaddlePredictor*)>& feed);
+
+  /// Take a free predictor, spinning while all of them are in use. It goes
+  /// back to the pool when the last copy of the returned pointer is dropped.
+  std::shared_ptr<PaddlePredictor> Acquire();
+
+  int size() const;
+
+ private:
+  struct Slots {
+    std::vector<std::shared_ptr<PaddlePredictor>> predictors;
+    std::unique_ptr<std::atomic<bool>[]> busy;
+  };
+  // Shared with the acquired pointers, which may outlive the pool.
+  std::shared_ptr<Slots> slots_;
+};
+
 /// Base class for all the configs.
 class LITE_API ConfigBase {
   std::string model_dir_;
   int threads_{1};
   PowerMode mode_{LITE_POWER_NO_BIND};
+  HugePageMode huge_pages_{LITE_HUGE_PAGES_NONE};
+  bool zero_host_memory_{true};
 
  public:
   explicit ConfigBase(PowerMode mode = LITE_POWER_NO_BIND, int threads = 1);
@@ -125,6 +185,20 @@ class LITE_API ConfigBase {
   // set Thread
   void set_threads(int threads);
   int threads() const { return threads_; }
+  // Back the host memory blocks of at least 2MB, such as large weights and
+  // activations, with huge pages to save TLB misses. LITE_HUGE_PAGES_EXPLICIT
+  // takes the pages reserved in /proc/sys/vm/nr_hugepages, and falls back to
+  // transparent huge pages when they run out. Only supported on Linux, it
+  // applies to the whole process and should be set before the predictor is
+  // created.
+  void set_huge_pages(HugePageMode mode);
+  HugePageMode huge_pages() const { return huge_pages_; }
+  // Whether the host buffers of tensors are cleared when they are allocated,
+  // on by default. Turning it off saves a memset per allocation, but only
+  // suits models whose kernels all write their outputs in full. It applies to
+  // the whole process.
+  void set_zero_host_memory(bool zero);
+  bool zero_host_memory() const { return zero_host_memory_; }
 };
 
 /// CxxConfig is the config for the Full feature predictor.
@@ -135,6 +209,8 @@ class LITE_API CxxConfig : public ConfigBase {
   bool model_from_memory_{false};
 #ifdef LITE_WITH_X86
   int x86_math_library_math_threads_ = 1;
+  int x86_numa_node_{-1};
+  std::vector<int> x86_cpu_affinity_;
 #endif
 #ifdef LITE_WITH_CUDA
   bool multi_stream_{false};
@@ -147,6 +223,7 @@ class LITE_API CxxConfig : public ConfigBase {
   std::vector<float> mlu_first_conv_mean_;
   std::vector<float> mlu_first_conv_std_;
 #endif
+  std::string embedding_quant_type_;
 
  public:
   void set_valid_places(const std::vector<Place>& x) { valid_places_ = x; }
@@ -166,6 +243,15 @@ class LITE_API CxxConfig : public ConfigBase {
   std::string param_file() const { return param_file_; }
   bool model_from_memory() const { return model_from_memory_; }
 
+  // Store the tables of lookup_table as "int8" (row-wise min/max) or "fp16"
+  // after optimization, empty to keep them in float32.
+  void set_embedding_quant_type(const std::string& type) {
+    embedding_quant_type_ = type;
+  }
+  const std::string& embedding_quant_type() const {
+    return embedding_quant_type_;
+  }
+
 #ifdef LITE_WITH_X86
   void set_x86_math_library_num_threads(int threads) {
     x86_math_library_math_threads_ = threads;
@@ -173,6 +259,20 @@ class LITE_API CxxConfig : public ConfigBase {
   int x86_math_library_num_threads() const {
     return x86_math_library_math_threads_;
   }
+  // Keep the predictor on a NUMA node: the threads building and running it
+  // are bound to the CPUs of the node, and its weights are moved there.
+  // -1 leaves the placement to the OS.
+  void set_x86_numa_node(int node) { x86_numa_node_ = node; }
+  int x86_numa_node() const { return x86_numa_node_; }
+  // The CPUs the threads building and running the predictor are bound to,
+  // the CPUs of x86_numa_node when empty. The thread creating the predictor
+  // gets its own CPUs back once it is built, the ones running it stay bound.
+  void set_x86_cpu_affinity(const std::vector<int>& cpus) {
+    x86_cpu_affinity_ = cpus;
+  }
+  const std::vector<int>& x86_cpu_affinity() const {
+    return x86_cpu_affinity_;
+  }
 #endif
 #ifdef LITE_WITH_CUDA
   void set_multi_stream(bool multi_stream) { multi_stream_ = multi_stream; }
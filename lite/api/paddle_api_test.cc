@@ -15,6 +15,8 @@
 #include "lite/api/paddle_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <thread>  // NOLINT
+#include <vector>
 #include "lite/utils/cp_logging.h"
 #include "lite/utils/io.h"
 DEFINE_string(model_dir, "", "");
@@ -65,6 +67,45 @@ TEST(CxxApi, run) {
       FLAGS_model_dir + ".opt2.naive", LiteModelType::kNaiveBuffer, true);
 }
 
+TEST(CxxApi, predictor_pool) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  const int num = 4;
+  PredictorPool pool(lite_api::CreatePaddlePredictor(config), num);
+  ASSERT_EQ(pool.size(), num);
+  auto feed = [](PaddlePredictor* predictor) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+  };
+  pool.WarmUp(feed);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2 * num; t++) {
+    threads.emplace_back([&] {
+      for (int k = 0; k < 10; k++) {
+        auto predictor = pool.Acquire();
+        feed(predictor.get());
+        predictor->Run();
+        auto* out = predictor->GetOutput(0)->data<float>();
+        EXPECT_NEAR(out[0], 50.2132, 1e-3);
+        EXPECT_NEAR(out[1], -28.8729, 1e-3);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 // Demo1 for Mobile Devices :Load model from file and run
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
 TEST(LightApi, run) {
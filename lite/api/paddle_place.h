@@ -92,6 +92,12 @@ typedef enum {
 
 typedef enum { MLU_220 = 0, MLU_270 = 1 } MLUCoreVersion;
 
+typedef enum {
+  LITE_HUGE_PAGES_NONE = 0,
+  LITE_HUGE_PAGES_TRANSPARENT = 1,
+  LITE_HUGE_PAGES_EXPLICIT = 2
+} HugePageMode;
+
 enum class ActivationType : int {
   kIndentity = 0,
   kRelu = 1,
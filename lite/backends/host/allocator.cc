@@ -0,0 +1,505 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/allocator.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>  // NOLINT
+#include <new>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace host {
+
+namespace {
+
+// Size classes: 256B, then four classes per power of two up to 64MB, so a
+// block wastes at most a quarter of its size.
+const int kMinClassShift = 8;
+const int kMaxClassShift = 26;
+const size_t kMinClassSize = static_cast<size_t>(1) << kMinClassShift;
+const size_t kMaxClassSize = static_cast<size_t>(1) << kMaxClassShift;
+const int kNumClasses = 1 + (kMaxClassShift - kMinClassShift) * 4;
+
+// A thread cache is only trimmed when its thread allocates or exits, so it
+// keeps a few small blocks and leaves the large ones to the pool.
+const size_t kThreadCacheBlocks = 4;
+#ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
+const size_t kMaxThreadCacheClassSize = static_cast<size_t>(256) << 10;
+const size_t kMaxThreadCacheBytes = static_cast<size_t>(1) << 20;
+const size_t kDefaultMaxCachedBytes = static_cast<size_t>(32) << 20;
+#else
+const size_t kMaxThreadCacheClassSize = static_cast<size_t>(1) << 20;
+const size_t kMaxThreadCacheBytes = static_cast<size_t>(4) << 20;
+const size_t kDefaultMaxCachedBytes = static_cast<size_t>(256) << 20;
+#endif
+
+const size_t kHugePageSize = static_cast<size_t>(2) << 20;
+const size_t kGigaPageSize = static_cast<size_t>(1) << 30;
+
+// Lives in the first kMallocAlign bytes of every block, the caller gets the
+// memory right after it.
+struct BlockHeader {
+  Allocator* allocator;
+  size_t size;
+  int size_class;
+  // Pool::generation when the block was allocated.
+  uint64_t generation;
+  std::shared_ptr<AllocatorStats> stats;
+};
+static_assert(sizeof(BlockHeader) <= kMallocAlign,
+              "BlockHeader must fit in the alignment padding");
+
+// Written by SystemAllocator right before the malloc'ed blocks it returns.
+// The mapped ones are page aligned and kept in a side table instead, so a
+// block of whole huge pages does not spill into one more.
+struct SystemPrefix {
+  void* raw;
+};
+
+int SizeClass(size_t size, size_t* class_size) {
+  if (size <= kMinClassSize) {
+    *class_size = kMinClassSize;
+    return 0;
+  }
+  int shift = kMinClassShift;
+  while ((static_cast<size_t>(2) << shift) < size) {
+    ++shift;
+  }
+  const size_t base = static_cast<size_t>(1) << shift;
+  const size_t step = base / 4;
+  *class_size = (size + step - 1) / step * step;
+  return (shift - kMinClassShift) * 4 +
+         static_cast<int>((*class_size - base) / step);
+}
+
+struct Pool {
+  std::mutex mutex;
+  std::shared_ptr<Allocator> allocator{new SystemAllocator()};
+  // Set by SetHugePages, the allocator may have been replaced since.
+  HugePages huge_pages{HugePages::kNone};
+  // Replaced allocators still own live blocks, keep them around.
+  std::vector<std::shared_ptr<Allocator>> retired;
+  std::vector<void*> blocks[kNumClasses];
+  size_t bytes{0};
+  size_t max_bytes{kDefaultMaxCachedBytes};
+  std::atomic<size_t> cached_bytes{0};
+  // Bumped by SetAllocator, blocks of an older one are not cached anymore.
+  std::atomic<uint64_t> generation{0};
+  // Bumped by ReleaseCachedMemory, each thread drops its cache when it sees
+  // the change.
+  std::atomic<uint64_t> epoch{0};
+};
+
+// Never destroyed, blocks may be freed by static destructors at exit.
+Pool& GetPool() {
+  static Pool* pool = new Pool;
+  return *pool;
+}
+
+void Release(void* block) {
+  auto* header = static_cast<BlockHeader*>(block);
+  Allocator* allocator = header->allocator;
+  const size_t size = header->size;
+  header->~BlockHeader();
+  allocator->Deallocate(block, size);
+}
+
+bool PutPool(void* block, int size_class, size_t size) {
+  auto& pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  if (pool.bytes + size > pool.max_bytes ||
+      static_cast<BlockHeader*>(block)->generation != pool.generation) {
+    return false;
+  }
+  pool.blocks[size_class].push_back(block);
+  pool.bytes += size;
+  pool.cached_bytes += size;
+  return true;
+}
+
+void* TakePool(int size_class, size_t size) {
+  auto& pool = GetPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  auto& blocks = pool.blocks[size_class];
+  if (blocks.empty()) {
+    return nullptr;
+  }
+  void* block = blocks.back();
+  blocks.pop_back();
+  pool.bytes -= size;
+  pool.cached_bytes -= size;
+  return block;
+}
+
+std::atomic<bool> zero_on_malloc{true};
+
+thread_local bool tls_cache_dead = false;
+thread_local const std::shared_ptr<AllocatorStats>* tls_stats = nullptr;
+
+struct ThreadCache {
+  std::vector<void*> blocks[kNumClasses];
+  size_t bytes{0};
+  uint64_t epoch{0};
+
+  // Hands the blocks over to the pool, or back to the allocator when the
+  // pool is full.
+  void Flush() {
+    auto& pool = GetPool();
+    for (int c = 0; c < kNumClasses; ++c) {
+      for (void* block : blocks[c]) {
+        const size_t size = static_cast<BlockHeader*>(block)->size;
+        pool.cached_bytes -= size;
+        if (!PutPool(block, c, size)) {
+          Release(block);
+        }
+      }
+      blocks[c].clear();
+    }
+    bytes = 0;
+  }
+
+  // Returns the blocks to their allocators.
+  void ReleaseAll() {
+    auto& pool = GetPool();
+    for (int c = 0; c < kNumClasses; ++c) {
+      for (void* block : blocks[c]) {
+        pool.cached_bytes -= static_cast<BlockHeader*>(block)->size;
+        Release(block);
+      }
+      blocks[c].clear();
+    }
+    bytes = 0;
+  }
+
+  // Drops the blocks cached before the last ReleaseCachedMemory.
+  void Sync() {
+    const uint64_t current = GetPool().epoch.load(std::memory_order_relaxed);
+    if (epoch != current) {
+      ReleaseAll();
+      epoch = current;
+    }
+  }
+
+  ~ThreadCache() {
+    Flush();
+    tls_cache_dead = true;
+  }
+};
+
+// nullptr once the thread is tearing down its thread_local objects.
+ThreadCache* LocalCache() {
+  if (tls_cache_dead) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+void* TakeCached(int size_class, size_t size) {
+  auto* cache = LocalCache();
+  if (cache) {
+    cache->Sync();
+  }
+  if (cache && !cache->blocks[size_class].empty()) {
+    void* block = cache->blocks[size_class].back();
+    cache->blocks[size_class].pop_back();
+    cache->bytes -= size;
+    GetPool().cached_bytes -= size;
+    return block;
+  }
+  return TakePool(size_class, size);
+}
+
+bool PutCached(void* block, int size_class, size_t size) {
+  auto* cache = LocalCache();
+  if (cache) {
+    cache->Sync();
+  }
+  if (cache && size <= kMaxThreadCacheClassSize &&
+      cache->blocks[size_class].size() < kThreadCacheBlocks &&
+      cache->bytes + size <= kMaxThreadCacheBytes) {
+    cache->blocks[size_class].push_back(block);
+    cache->bytes += size;
+    GetPool().cached_bytes += size;
+    return true;
+  }
+  return PutPool(block, size_class, size);
+}
+
+#ifdef __linux__
+void* Map(size_t length, int flags) {
+  void* p = mmap(nullptr,
+                 length,
+                 PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | flags,
+                 -1,
+                 0);
+  return p == MAP_FAILED ? nullptr : p;
+}
+
+// Maps `size` bytes, nullptr if the OS refuses. Sets `mapped` to the length
+// to unmap, a whole number of huge pages when they back the block.
+void* MapHugePages(size_t size, HugePages huge_pages, size_t* mapped) {
+  void* p = nullptr;
+#ifdef MAP_HUGETLB
+  if (huge_pages == HugePages::kExplicit) {
+#ifdef MAP_HUGE_SHIFT
+    *mapped = (size + kGigaPageSize - 1) / kGigaPageSize * kGigaPageSize;
+    if (*mapped - size <= size / 4) {
+      p = Map(*mapped, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT));
+    }
+#endif
+    if (!p) {
+      // The default huge page size, 2MB on x86.
+      *mapped = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+      p = Map(*mapped, MAP_HUGETLB);
+    }
+  }
+#endif
+  if (!p) {
+    *mapped = size;
+    p = Map(size, 0);
+    if (!p) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+  }
+  return p;
+}
+#endif
+
+}  // namespace
+
+void AllocatorStats::OnAlloc(int64_t bytes) {
+  ++num_allocs;
+  const int64_t in_use = bytes_in_use.fetch_add(bytes) + bytes;
+  int64_t peak = peak_bytes_in_use.load();
+  while (in_use > peak &&
+         !peak_bytes_in_use.compare_exchange_weak(peak, in_use)) {
+  }
+}
+
+void AllocatorStats::OnFree(int64_t bytes) {
+  ++num_frees;
+  bytes_in_use -= bytes;
+}
+
+AllocatorStats& GlobalAllocatorStats() {
+  static AllocatorStats* stats = new AllocatorStats;
+  return *stats;
+}
+
+ScopedAllocatorStats::ScopedAllocatorStats(
+    const std::shared_ptr<AllocatorStats>& stats)
+    : stats_(stats), prev_(tls_stats) {
+  tls_stats = &stats_;
+}
+
+ScopedAllocatorStats::~ScopedAllocatorStats() { tls_stats = prev_; }
+
+void* SystemAllocator::Allocate(size_t size) {
+#ifdef __linux__
+  if (huge_pages_ != HugePages::kNone && size >= kHugePageSize) {
+    size_t mapped = 0;
+    void* p = MapHugePages(size, huge_pages_, &mapped);
+    if (p) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      mapped_[p] = mapped;
+      mapped_bytes_ += mapped;
+      return p;
+    }
+  }
+#endif
+  const size_t offset = sizeof(SystemPrefix) + kMallocAlign - 1;
+  char* p = static_cast<char*>(malloc(offset + size));
+  if (!p) {
+    return nullptr;
+  }
+  void* r = reinterpret_cast<void*>(reinterpret_cast<size_t>(p + offset) &
+                                    (~(kMallocAlign - 1)));
+  static_cast<SystemPrefix*>(r)[-1] = {p};
+  return r;
+}
+
+void SystemAllocator::Deallocate(void* ptr, size_t size) {
+#ifdef __linux__
+  if (huge_pages_ != HugePages::kNone && size >= kHugePageSize) {
+    size_t mapped = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = mapped_.find(ptr);
+      if (it != mapped_.end()) {
+        mapped = it->second;
+        mapped_bytes_ -= mapped;
+        mapped_.erase(it);
+      }
+    }
+    if (mapped) {
+      munmap(ptr, mapped);
+      return;
+    }
+  }
+#endif
+  free(static_cast<SystemPrefix*>(ptr)[-1].raw);
+}
+
+size_t SystemAllocator::MappedBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return mapped_bytes_;
+}
+
+void SetAllocator(const std::shared_ptr<Allocator>& allocator) {
+  auto& pool = GetPool();
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.retired.push_back(pool.allocator);
+    pool.allocator = allocator;
+    pool.huge_pages = HugePages::kNone;
+    ++pool.generation;
+  }
+  ReleaseCachedMemory();
+}
+
+void SetHugePages(HugePages huge_pages) {
+  auto& pool = GetPool();
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.huge_pages == huge_pages) {
+      return;
+    }
+  }
+  SetAllocator(std::make_shared<SystemAllocator>(huge_pages));
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.huge_pages = huge_pages;
+}
+
+void SetMaxCachedBytes(size_t bytes) {
+  auto& pool = GetPool();
+  bool trim = false;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.max_bytes = bytes;
+    trim = pool.bytes > bytes;
+  }
+  if (trim) {
+    ReleaseCachedMemory();
+  }
+}
+
+void ReleaseCachedMemory() {
+  auto& pool = GetPool();
+  ++pool.epoch;
+  auto* cache = LocalCache();
+  if (cache) {
+    cache->Sync();
+  }
+  std::vector<void*> blocks;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    for (int c = 0; c < kNumClasses; ++c) {
+      blocks.insert(blocks.end(), pool.blocks[c].begin(), pool.blocks[c].end());
+      pool.blocks[c].clear();
+    }
+    pool.cached_bytes -= pool.bytes;
+    pool.bytes = 0;
+  }
+  for (void* block : blocks) {
+    Release(block);
+  }
+}
+
+size_t CachedBytes() { return GetPool().cached_bytes.load(); }
+
+size_t RoundUpSize(size_t size) {
+  if (size + kMallocAlign > kMaxClassSize) {
+    return size;
+  }
+  size_t class_size;
+  SizeClass(size + kMallocAlign, &class_size);
+  return class_size - kMallocAlign;
+}
+
+void SetZeroOnMalloc(bool zero) { zero_on_malloc.store(zero); }
+
+bool ZeroOnMalloc() { return zero_on_malloc.load(std::memory_order_relaxed); }
+
+void* Malloc(size_t size, bool zero) {
+  const size_t total = size + kMallocAlign;
+  size_t block_size = total;
+  int size_class = -1;
+  void* block = nullptr;
+  if (total <= kMaxClassSize) {
+    size_class = SizeClass(total, &block_size);
+    block = TakeCached(size_class, block_size);
+  }
+  auto* header = static_cast<BlockHeader*>(block);
+  if (!block) {
+    auto& pool = GetPool();
+    std::shared_ptr<Allocator> allocator;
+    uint64_t generation = 0;
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      allocator = pool.allocator;
+      generation = pool.generation;
+    }
+    block = allocator->Allocate(block_size);
+    if (!block) {
+      return nullptr;
+    }
+    header = new (block)
+        BlockHeader{allocator.get(), block_size, size_class, generation};
+  }
+  if (tls_stats) {
+    header->stats = *tls_stats;
+    header->stats->OnAlloc(block_size);
+  }
+  GlobalAllocatorStats().OnAlloc(block_size);
+
+  void* r = static_cast<char*>(block) + kMallocAlign;
+  if (zero) {
+    memset(r, 0, size);
+  }
+  return r;
+}
+
+void Free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  void* block = static_cast<char*>(ptr) - kMallocAlign;
+  auto* header = static_cast<BlockHeader*>(block);
+  GlobalAllocatorStats().OnFree(header->size);
+  if (header->stats) {
+    header->stats->OnFree(header->size);
+    header->stats.reset();
+  }
+  if (header->size_class >= 0 &&
+      header->generation ==
+          GetPool().generation.load(std::memory_order_relaxed) &&
+      PutCached(block, header->size_class, header->size)) {
+    return;
+  }
+  Release(block);
+}
+
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,140 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+namespace paddle {
+namespace lite {
+namespace host {
+
+// Alignment of every block returned by Malloc.
+const size_t kMallocAlign = 64;
+
+// Byte counters of the host memory charged to one owner, usually a
+// predictor. A block holds a reference to the stats it was charged to, so a
+// free is credited back even when it happens after the owner is gone.
+struct AllocatorStats {
+  std::atomic<int64_t> bytes_in_use{0};
+  std::atomic<int64_t> peak_bytes_in_use{0};
+  std::atomic<int64_t> num_allocs{0};
+  std::atomic<int64_t> num_frees{0};
+
+  void OnAlloc(int64_t bytes);
+  void OnFree(int64_t bytes);
+};
+
+// Stats of all the host memory handed out in this process.
+AllocatorStats& GlobalAllocatorStats();
+
+// Charges the host allocations made by the current thread to `stats` for the
+// lifetime of this object, in addition to the global stats.
+class ScopedAllocatorStats {
+ public:
+  explicit ScopedAllocatorStats(const std::shared_ptr<AllocatorStats>& stats);
+  ~ScopedAllocatorStats();
+
+ private:
+  std::shared_ptr<AllocatorStats> stats_;
+  const std::shared_ptr<AllocatorStats>* prev_{nullptr};
+};
+
+// Source of the raw memory behind the host size-class cache. Allocate must
+// return `size` bytes aligned to kMallocAlign; Deallocate receives the same
+// size back.
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+  virtual void* Allocate(size_t size) = 0;
+  virtual void Deallocate(void* ptr, size_t size) = 0;
+};
+
+// How SystemAllocator backs the blocks of at least 2MB.
+enum class HugePages {
+  kNone,
+  // mmap'ed and advised as transparent huge pages where the OS supports it.
+  kTransparent,
+  // Taken from the huge pages reserved in /proc/sys/vm/nr_hugepages, 1GB
+  // pages when they waste at most a quarter of the block and the OS has them.
+  // Falls back to kTransparent when the reserved pages run out.
+  kExplicit,
+};
+
+// malloc based allocator, the large blocks can be backed by huge pages to
+// save TLB misses.
+class SystemAllocator : public Allocator {
+ public:
+  explicit SystemAllocator(HugePages huge_pages = HugePages::kNone)
+      : huge_pages_(huge_pages) {}
+  void* Allocate(size_t size) override;
+  void Deallocate(void* ptr, size_t size) override;
+
+  // Bytes of the blocks currently mmap'ed, in whole huge pages when they are
+  // backed by reserved ones.
+  size_t MappedBytes();
+
+ private:
+  HugePages huge_pages_;
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> mapped_;
+  size_t mapped_bytes_{0};
+};
+
+// Replaces the allocator used for new blocks and drops the cached ones, in
+// every thread. Blocks that are alive go back to the allocator they came
+// from when freed instead of being cached.
+void SetAllocator(const std::shared_ptr<Allocator>& allocator);
+
+// Backs the new blocks as `huge_pages` says by installing a SystemAllocator,
+// unless the current allocator already does. An allocator installed by
+// SetAllocator counts as kNone.
+void SetHugePages(HugePages huge_pages);
+
+// Upper bound of the bytes kept in the process-wide cache of freed blocks.
+void SetMaxCachedBytes(size_t bytes);
+
+// Returns the cached blocks of the process-wide pool and of the calling
+// thread to the allocator. The other threads drop theirs the next time they
+// allocate or free, a thread that stays idle holds on to at most a few MB of
+// small blocks until then or until it exits.
+void ReleaseCachedMemory();
+
+// Bytes currently held in the caches and not handed out.
+size_t CachedBytes();
+
+// Whether the blocks TargetMalloc hands out for the host targets are cleared,
+// on by default since kernels may accumulate into freshly resized outputs.
+// Turning it off saves a memset per allocation for the whole process.
+void SetZeroOnMalloc(bool zero);
+bool ZeroOnMalloc();
+
+// The usable size of the block Malloc returns for a request of `size` bytes,
+// growing a buffer up to it never needs a new block.
+size_t RoundUpSize(size_t size);
+
+// Blocks up to a few tens of MB are served from per-thread and process-wide
+// caches of size classes, larger ones go straight to the allocator. The
+// memory is not cleared unless `zero` is set.
+void* Malloc(size_t size, bool zero = false);
+void Free(void* ptr);
+
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -29,8 +29,24 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
 #include <gflags/gflags.h>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
 
 #include "lite/utils/env.h"
 
@@ -165,6 +181,232 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
 }
 #endif
 
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) end = list.size();
+    std::string range = list.substr(pos, end - pos);
+    size_t dash = range.find('-');
+    if (!range.empty()) {
+      int first = std::atoi(range.c_str());
+      int last = dash == std::string::npos
+                     ? first
+                     : std::atoi(range.c_str() + dash + 1);
+      for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+
+size_t ParseCacheSize(const std::string& size) {
+  size_t bytes = std::strtoul(size.c_str(), nullptr, 10);
+  if (size.find('K') != std::string::npos) bytes <<= 10;
+  if (size.find('M') != std::string::npos) bytes <<= 20;
+  return bytes;
+}
+
+namespace {
+
+#ifdef __linux__
+const char kSysCpuPath[] = "/sys/devices/system/cpu/";
+const char kSysNodePath[] = "/sys/devices/system/node/";
+
+bool ReadLine(const std::string& path, std::string* line) {
+  std::ifstream in(path);
+  return in && std::getline(in, *line);
+}
+
+int ReadInt(const std::string& path, int default_value) {
+  std::string line;
+  if (!ReadLine(path, &line) || line.empty()) return default_value;
+  return std::atoi(line.c_str());
+}
+
+void ProbeCaches(CpuTopology* topo) {
+  for (int index = 0;; ++index) {
+    std::string dir =
+        std::string(kSysCpuPath) + "cpu0/cache/index" + std::to_string(index);
+    std::string type, size;
+    if (!ReadLine(dir + "/type", &type) || !ReadLine(dir + "/size", &size)) {
+      break;
+    }
+    if (type == "Instruction") continue;
+    switch (ReadInt(dir + "/level", 0)) {
+      case 1:
+        topo->l1_cache_size = ParseCacheSize(size);
+        break;
+      case 2:
+        topo->l2_cache_size = ParseCacheSize(size);
+        break;
+      case 3:
+        topo->l3_cache_size = ParseCacheSize(size);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void ProbeNodes(CpuTopology* topo) {
+  DIR* dir = opendir(kSysNodePath);
+  if (!dir) return;
+  while (auto* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+        !isdigit(name[4])) {
+      continue;
+    }
+    int node = std::atoi(name.c_str() + 4);
+    std::string list;
+    if (!ReadLine(std::string(kSysNodePath) + name + "/cpulist", &list)) {
+      continue;
+    }
+    for (int cpu : ParseCpuList(list)) {
+      if (cpu < topo->num_cpus) topo->node_of_cpu[cpu] = node;
+    }
+    topo->num_nodes = std::max(topo->num_nodes, node + 1);
+  }
+  closedir(dir);
+}
+#endif  // __linux__
+
+CpuTopology ProbeCpuTopology() {
+  CpuTopology topo;
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  topo.num_cpus = info.dwNumberOfProcessors;
+#elif defined(__APPLE__)
+  topo.num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  topo.num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+#endif
+  topo.num_cpus = std::max(topo.num_cpus, 1);
+  topo.socket_of_cpu.assign(topo.num_cpus, 0);
+  topo.node_of_cpu.assign(topo.num_cpus, 0);
+  topo.core_of_cpu.resize(topo.num_cpus);
+  for (int cpu = 0; cpu < topo.num_cpus; ++cpu) {
+    topo.core_of_cpu[cpu] = cpu;
+  }
+  topo.num_sockets = 1;
+  topo.num_cores = topo.num_cpus;
+  topo.num_nodes = 1;
+
+#ifdef __linux__
+  std::map<std::pair<int, int>, int> cores;
+  int num_sockets = 0;
+  for (int cpu = 0; cpu < topo.num_cpus; ++cpu) {
+    std::string dir =
+        std::string(kSysCpuPath) + "cpu" + std::to_string(cpu) + "/topology/";
+    int socket = std::max(ReadInt(dir + "physical_package_id", 0), 0);
+    int core = ReadInt(dir + "core_id", cpu);
+    auto it = cores.emplace(std::make_pair(socket, core),
+                            static_cast<int>(cores.size()));
+    topo.socket_of_cpu[cpu] = socket;
+    topo.core_of_cpu[cpu] = it.first->second;
+    num_sockets = std::max(num_sockets, socket + 1);
+  }
+  topo.num_sockets = num_sockets;
+  topo.num_cores = cores.size();
+  topo.num_nodes = 0;
+  ProbeNodes(&topo);
+  topo.num_nodes = std::max(topo.num_nodes, 1);
+  ProbeCaches(&topo);
+#elif !defined(_WIN32) && defined(_SC_LEVEL1_DCACHE_SIZE)
+  topo.l1_cache_size = std::max<long>(sysconf(_SC_LEVEL1_DCACHE_SIZE), 0);
+  topo.l2_cache_size = std::max<long>(sysconf(_SC_LEVEL2_CACHE_SIZE), 0);
+  topo.l3_cache_size = std::max<long>(sysconf(_SC_LEVEL3_CACHE_SIZE), 0);
+#endif
+  return topo;
+}
+
+}  // namespace
+
+std::vector<int> CpuTopology::CpusOfNode(int node) const {
+  std::vector<int> cpus;
+  std::vector<int> siblings;
+  std::vector<bool> seen(num_cores, false);
+  for (int cpu = 0; cpu < num_cpus; ++cpu) {
+    if (node_of_cpu[cpu] != node) continue;
+    if (seen[core_of_cpu[cpu]]) {
+      siblings.push_back(cpu);
+    } else {
+      seen[core_of_cpu[cpu]] = true;
+      cpus.push_back(cpu);
+    }
+  }
+  cpus.insert(cpus.end(), siblings.begin(), siblings.end());
+  return cpus;
+}
+
+const CpuTopology& GetCpuTopology() {
+  static const CpuTopology topo = ProbeCpuTopology();
+  return topo;
+}
+
+bool BindThreadsToCpus(const std::vector<int>& cpus) {
+#ifdef __linux__
+  if (cpus.empty()) return false;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) return false;
+#ifdef PADDLE_WITH_MKLML
+  // The OpenMP threads keep the mask of the thread starting them only when
+  // they are created, the ones alive already are moved one by one.
+  bool ok = true;
+#pragma omp parallel reduction(&& : ok)
+  { ok = sched_setaffinity(0, sizeof(mask), &mask) == 0; }
+  return ok;
+#else
+  return true;
+#endif
+#else
+  return false;
+#endif
+}
+
+std::vector<int> ThreadCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+  }
+#endif
+  return cpus;
+}
+
+bool BindMemoryToNode(const void* ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // From <numaif.h>, which comes with libnuma and is not always installed.
+  const int kMpolPreferred = 1;
+  const unsigned kMpolMfMove = 1 << 1;
+  if (!ptr || node < 0 || node >= 64) return false;
+  const size_t page = sysconf(_SC_PAGESIZE);
+  size_t begin = (reinterpret_cast<size_t>(ptr) + page - 1) / page * page;
+  size_t end = (reinterpret_cast<size_t>(ptr) + size) / page * page;
+  if (end <= begin) return true;
+  unsigned long node_mask = 1UL << node;  // NOLINT
+  return syscall(SYS_mbind,
+                 begin,
+                 end - begin,
+                 kMpolPreferred,
+                 &node_mask,
+                 sizeof(node_mask) * 8,
+                 kMpolMfMove) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
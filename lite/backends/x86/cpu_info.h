@@ -15,6 +15,8 @@
 #pragma once
 
 #include <stddef.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #if defined(__AVX2__)
@@ -75,6 +77,45 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+//! Sockets, cores and NUMA nodes of the logical CPUs, read from sysfs on
+//! Linux. Elsewhere every CPU is a core of socket 0 and node 0.
+struct CpuTopology {
+  int num_cpus{0};
+  int num_sockets{0};
+  int num_cores{0};
+  int num_nodes{0};
+  // Indexed by the logical CPU id, core ids are unique across sockets.
+  std::vector<int> socket_of_cpu;
+  std::vector<int> core_of_cpu;
+  std::vector<int> node_of_cpu;
+  // Data and unified cache sizes in bytes seen by CPU 0, 0 when unknown.
+  size_t l1_cache_size{0};
+  size_t l2_cache_size{0};
+  size_t l3_cache_size{0};
+
+  //! The logical CPUs of a NUMA node, one per core first, then their SMT
+  //! siblings.
+  std::vector<int> CpusOfNode(int node) const;
+};
+
+const CpuTopology& GetCpuTopology();
+
+//! Parses a sysfs cpu list such as "0-15,32-47".
+std::vector<int> ParseCpuList(const std::string& list);
+
+//! Parses a sysfs cache size such as "32K" into bytes.
+size_t ParseCacheSize(const std::string& size);
+
+//! The CPUs the calling thread may run on, empty when unknown.
+std::vector<int> ThreadCpus();
+
+//! Restricts the calling thread and its OpenMP threads to `cpus`.
+bool BindThreadsToCpus(const std::vector<int>& cpus);
+
+//! Moves the pages inside [ptr, ptr + size) to NUMA node `node` and prefers
+//! the node when they fault in again. Only whole pages are moved.
+bool BindMemoryToNode(const void* ptr, size_t size, int node);
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,69 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/cpu_info.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+
+TEST(CpuInfo, ParseCpuList) {
+  EXPECT_EQ(ParseCpuList("0-3,8,10-11"),
+            std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(ParseCpuList("5"), std::vector<int>({5}));
+  EXPECT_TRUE(ParseCpuList("").empty());
+}
+
+TEST(CpuInfo, ParseCacheSize) {
+  EXPECT_EQ(ParseCacheSize("32K"), 32u << 10);
+  EXPECT_EQ(ParseCacheSize("1024K"), 1u << 20);
+  EXPECT_EQ(ParseCacheSize("36M"), 36u << 20);
+  EXPECT_EQ(ParseCacheSize("512"), 512u);
+}
+
+TEST(CpuInfo, CpusOfNode) {
+  // Two nodes of two cores each, the SMT siblings numbered after all the
+  // cores as Linux does on x86.
+  CpuTopology topo;
+  topo.num_cpus = 8;
+  topo.num_cores = 4;
+  topo.num_nodes = 2;
+  topo.core_of_cpu = {0, 1, 2, 3, 0, 1, 2, 3};
+  topo.node_of_cpu = {0, 0, 1, 1, 0, 0, 1, 1};
+  EXPECT_EQ(topo.CpusOfNode(0), std::vector<int>({0, 1, 4, 5}));
+  EXPECT_EQ(topo.CpusOfNode(1), std::vector<int>({2, 3, 6, 7}));
+  // Siblings next to each other still come after one CPU per core.
+  topo.core_of_cpu = {0, 0, 1, 1, 2, 2, 3, 3};
+  topo.node_of_cpu = {0, 0, 0, 0, 1, 1, 1, 1};
+  EXPECT_EQ(topo.CpusOfNode(0), std::vector<int>({0, 2, 1, 3}));
+  EXPECT_EQ(topo.CpusOfNode(1), std::vector<int>({4, 6, 5, 7}));
+  EXPECT_TRUE(topo.CpusOfNode(2).empty());
+}
+
+#ifdef __linux__
+TEST(CpuInfo, BindThreadsToCpus) {
+  auto cpus = ThreadCpus();
+  ASSERT_FALSE(cpus.empty());
+  ASSERT_TRUE(BindThreadsToCpus({cpus.back()}));
+  EXPECT_EQ(ThreadCpus(), std::vector<int>({cpus.back()}));
+  ASSERT_TRUE(BindThreadsToCpus(cpus));
+  EXPECT_EQ(ThreadCpus(), cpus);
+}
+#endif
+
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
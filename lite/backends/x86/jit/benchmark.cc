@@ -498,6 +498,7 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVExp BenchKernelXYN
 #define BenchKernelVSigmoid BenchKernelXYN
 #define BenchKernelVTanh BenchKernelXYN
+#define BenchKernelVGelu BenchKernelXYN
 #define BenchKernelVCopy BenchKernelXYN
 
 #define BenchKernelHMax BenchKernelXRN
@@ -534,6 +535,7 @@ BENCH_FP32_CPU(VSquare);
 BENCH_FP32_CPU(VExp);
 BENCH_FP32_CPU(VSigmoid);
 BENCH_FP32_CPU(VTanh);
+BENCH_FP32_CPU(VGelu);
 BENCH_FP32_CPU(VCopy);
 
 // xrn
@@ -44,6 +44,7 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kVSquare);
     ONE_CASE(kVSigmoid);
     ONE_CASE(kVTanh);
+    ONE_CASE(kVGelu);
     ONE_CASE(kLSTMCtHt);
     ONE_CASE(kLSTMC1H1);
     ONE_CASE(kGRUH1);
@@ -94,6 +95,8 @@ KernelType to_kerneltype(const std::string& act) {
     return kVSigmoid;
   } else if (lower == "tanh" || lower == "vtanh") {
     return kVTanh;
+  } else if (lower == "gelu" || lower == "vgelu") {
+    return kVGelu;
   }
   LOG(FATAL) << "Not support type: %s, or forget to add this case";
   return kNone;
@@ -45,6 +45,7 @@ typedef enum {
   kVBroadcast,
   kVCopy,
   kVExp,
+  kVGelu,
   kVIdentity,
   kVMul,
   kVRelu,
@@ -126,6 +127,7 @@ DECLARE_KERNELTUPLE(XYNTuple, VSquare);
 DECLARE_KERNELTUPLE(XYNTuple, VExp);
 DECLARE_KERNELTUPLE(XYNTuple, VSigmoid);
 DECLARE_KERNELTUPLE(XYNTuple, VTanh);
+DECLARE_KERNELTUPLE(XYNTuple, VGelu);
 DECLARE_KERNELTUPLE(XYNTuple, VCopy);
 
 DECLARE_KERNELTUPLE(XRNTuple, HMax);
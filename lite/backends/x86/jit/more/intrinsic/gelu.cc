@@ -0,0 +1,182 @@
+/* Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lite/backends/x86/jit/more/intrinsic/gelu.h"
+#include <cmath>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/jit/registry.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+namespace more {
+namespace intrinsic {
+// Note: intrinsic code is not runtime build.
+// For example, if you build code on AVX, and run on AVX512 it can only use AVX
+
+// gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+// erf is evaluated with the Abramowitz-Stegun 7.1.26 rational approximation
+// (max abs error 1.5e-7) and exp with the cephes polynomial, so one lane costs
+// a division and a handful of multiply-adds instead of a libm call.
+#define GELU_EXP_HI 88.3762626647949f
+#define GELU_EXP_LO -88.3762626647949f
+#define GELU_LOG2EF 1.44269504088896341f
+#define GELU_EXP_C1 0.693359375f
+#define GELU_EXP_C2 -2.12194440e-4f
+#define GELU_EXP_P0 1.9875691500E-4f
+#define GELU_EXP_P1 1.3981999507E-3f
+#define GELU_EXP_P2 8.3334519073E-3f
+#define GELU_EXP_P3 4.1665795894E-2f
+#define GELU_EXP_P4 1.6666665459E-1f
+#define GELU_EXP_P5 5.0000001201E-1f
+#define GELU_ERF_P 0.3275911f
+#define GELU_ERF_A1 0.254829592f
+#define GELU_ERF_A2 -0.284496736f
+#define GELU_ERF_A3 1.421413741f
+#define GELU_ERF_A4 -1.453152027f
+#define GELU_ERF_A5 1.061405429f
+
+#ifdef __AVX512F__
+static inline __m512 Exp(__m512 x) {
+  x = _mm512_min_ps(x, _mm512_set1_ps(GELU_EXP_HI));
+  x = _mm512_max_ps(x, _mm512_set1_ps(GELU_EXP_LO));
+  __m512 fx = _mm512_add_ps(_mm512_mul_ps(x, _mm512_set1_ps(GELU_LOG2EF)),
+                            _mm512_set1_ps(0.5f));
+  fx = _mm512_roundscale_ps(fx, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  x = _mm512_sub_ps(x, _mm512_mul_ps(fx, _mm512_set1_ps(GELU_EXP_C1)));
+  x = _mm512_sub_ps(x, _mm512_mul_ps(fx, _mm512_set1_ps(GELU_EXP_C2)));
+  __m512 y = _mm512_set1_ps(GELU_EXP_P0);
+  y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(GELU_EXP_P1));
+  y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(GELU_EXP_P2));
+  y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(GELU_EXP_P3));
+  y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(GELU_EXP_P4));
+  y = _mm512_add_ps(_mm512_mul_ps(y, x), _mm512_set1_ps(GELU_EXP_P5));
+  y = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(y, x), x), x);
+  y = _mm512_add_ps(y, _mm512_set1_ps(1.f));
+  __m512i n = _mm512_cvttps_epi32(fx);
+  n = _mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(0x7f)), 23);
+  return _mm512_mul_ps(y, _mm512_castsi512_ps(n));
+}
+
+static inline __m512 Gelu(__m512 x) {
+  const __m512i sign_mask = _mm512_set1_epi32(0x80000000);
+  __m512 z = _mm512_mul_ps(x, _mm512_set1_ps(static_cast<float>(M_SQRT1_2)));
+  __m512i sign = _mm512_and_epi32(_mm512_castps_si512(z), sign_mask);
+  __m512 a = _mm512_castsi512_ps(
+      _mm512_andnot_epi32(sign_mask, _mm512_castps_si512(z)));
+  __m512 t = _mm512_div_ps(
+      _mm512_set1_ps(1.f),
+      _mm512_add_ps(_mm512_mul_ps(a, _mm512_set1_ps(GELU_ERF_P)),
+                    _mm512_set1_ps(1.f)));
+  __m512 p = _mm512_set1_ps(GELU_ERF_A5);
+  p = _mm512_add_ps(_mm512_mul_ps(p, t), _mm512_set1_ps(GELU_ERF_A4));
+  p = _mm512_add_ps(_mm512_mul_ps(p, t), _mm512_set1_ps(GELU_ERF_A3));
+  p = _mm512_add_ps(_mm512_mul_ps(p, t), _mm512_set1_ps(GELU_ERF_A2));
+  p = _mm512_add_ps(_mm512_mul_ps(p, t), _mm512_set1_ps(GELU_ERF_A1));
+  p = _mm512_mul_ps(p, t);
+  __m512 e = Exp(_mm512_sub_ps(_mm512_setzero_ps(), _mm512_mul_ps(a, a)));
+  __m512 erf = _mm512_sub_ps(_mm512_set1_ps(1.f), _mm512_mul_ps(p, e));
+  erf = _mm512_castsi512_ps(_mm512_xor_epi32(_mm512_castps_si512(erf), sign));
+  return _mm512_mul_ps(_mm512_mul_ps(x, _mm512_set1_ps(0.5f)),
+                       _mm512_add_ps(erf, _mm512_set1_ps(1.f)));
+}
+#else
+static inline __m256 Exp(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(GELU_EXP_HI));
+  x = _mm256_max_ps(x, _mm256_set1_ps(GELU_EXP_LO));
+  __m256 fx = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(GELU_LOG2EF)),
+                            _mm256_set1_ps(0.5f));
+  fx = _mm256_floor_ps(fx);
+  x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(GELU_EXP_C1)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(GELU_EXP_C2)));
+  __m256 y = _mm256_set1_ps(GELU_EXP_P0);
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(GELU_EXP_P1));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(GELU_EXP_P2));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(GELU_EXP_P3));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(GELU_EXP_P4));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(GELU_EXP_P5));
+  y = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(y, x), x), x);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.f));
+  __m256i n = _mm256_cvttps_epi32(fx);
+#ifdef __AVX2__
+  n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(0x7f)), 23);
+#else
+  // AVX1 has no 256-bit integer ops, build 2^n on the two 128-bit halves.
+  const __m128i bias = _mm_set1_epi32(0x7f);
+  __m128i lo = _mm256_castsi256_si128(n);
+  __m128i hi = _mm256_extractf128_si256(n, 1);
+  lo = _mm_slli_epi32(_mm_add_epi32(lo, bias), 23);
+  hi = _mm_slli_epi32(_mm_add_epi32(hi, bias), 23);
+  n = _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+#endif
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+}
+
+static inline __m256 Gelu(__m256 x) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 z = _mm256_mul_ps(x, _mm256_set1_ps(static_cast<float>(M_SQRT1_2)));
+  __m256 sign = _mm256_and_ps(z, sign_mask);
+  __m256 a = _mm256_andnot_ps(sign_mask, z);
+  __m256 t = _mm256_div_ps(
+      _mm256_set1_ps(1.f),
+      _mm256_add_ps(_mm256_mul_ps(a, _mm256_set1_ps(GELU_ERF_P)),
+                    _mm256_set1_ps(1.f)));
+  __m256 p = _mm256_set1_ps(GELU_ERF_A5);
+  p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(GELU_ERF_A4));
+  p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(GELU_ERF_A3));
+  p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(GELU_ERF_A2));
+  p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(GELU_ERF_A1));
+  p = _mm256_mul_ps(p, t);
+  __m256 e = Exp(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(a, a)));
+  __m256 erf = _mm256_sub_ps(_mm256_set1_ps(1.f), _mm256_mul_ps(p, e));
+  erf = _mm256_xor_ps(erf, sign);
+  return _mm256_mul_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.5f)),
+                       _mm256_add_ps(erf, _mm256_set1_ps(1.f)));
+}
+#endif
+
+void VGelu(const float* x, float* y, int n) {
+#ifdef __AVX512F__
+  const int block = ZMM_FLOAT_BLOCK;
+#else
+  const int block = YMM_FLOAT_BLOCK;
+#endif
+  const int end = n - n % block;
+  int i = 0;
+  for (; i < end; i += block) {
+#ifdef __AVX512F__
+    _mm512_storeu_ps(y + i, Gelu(_mm512_loadu_ps(x + i)));
+#else
+    _mm256_storeu_ps(y + i, Gelu(_mm256_loadu_ps(x + i)));
+#endif
+  }
+  for (; i < n; ++i) {
+    y[i] = 0.5f * x[i] *
+           (1.f + std::erf(x[i] * static_cast<float>(M_SQRT1_2)));
+  }
+}
+
+bool VGeluKernel::CanBeUsed(const int& d) const {
+  return x86::MayIUse(x86::avx);
+}
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
+
+namespace intrinsic = paddle::lite::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kVGelu, intrinsic, intrinsic::VGeluKernel);
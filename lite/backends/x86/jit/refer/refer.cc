@@ -37,6 +37,7 @@ REGISTER_REFER_KERNEL(VSquare);
 REGISTER_REFER_KERNEL(VExp);
 REGISTER_REFER_KERNEL(VSigmoid);
 REGISTER_REFER_KERNEL(VTanh);
+REGISTER_REFER_KERNEL(VGelu);
 
 REGISTER_REFER_KERNEL(LSTMCtHt);
 REGISTER_REFER_KERNEL(LSTMC1H1);
@@ -138,6 +138,15 @@ void VTanh(const T* x, T* y, int n) {
   }
 }
 
+template <typename T>
+void VGelu(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + erf(x / sqrt(2)))
+  for (int i = 0; i < n; ++i) {
+    y[i] = static_cast<T>(0.5) * x[i] *
+           (static_cast<T>(1) + std::erf(x[i] * static_cast<T>(M_SQRT1_2)));
+  }
+}
+
 template <typename T>
 void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
   if (type == kVSigmoid) {
@@ -567,6 +576,7 @@ DECLARE_REFER_KERNEL(VIdentity);
 DECLARE_REFER_KERNEL(VExp);
 DECLARE_REFER_KERNEL(VSigmoid);
 DECLARE_REFER_KERNEL(VTanh);
+DECLARE_REFER_KERNEL(VGelu);
 DECLARE_REFER_KERNEL(VSquare);
 DECLARE_REFER_KERNEL(VCopy);
 
@@ -1388,6 +1388,7 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVExp TestKernelXYN
 #define TestKernelVSigmoid TestKernelXYN
 #define TestKernelVTanh TestKernelXYN
+#define TestKernelVGelu TestKernelXYN
 #define TestKernelVCopy TestKernelXYN
 
 #define TestKernelHMax TestKernelXRN
@@ -1420,6 +1421,7 @@ TEST_CPU_KERNEL(VSquare);
 TEST_CPU_KERNEL(VExp);
 TEST_CPU_KERNEL(VSigmoid);
 TEST_CPU_KERNEL(VTanh);
+TEST_CPU_KERNEL(VGelu);
 TEST_CPU_KERNEL(VCopy);
 
 TEST_CPU_KERNEL(HMax);
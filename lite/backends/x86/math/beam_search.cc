@@ -15,7 +15,8 @@ limitations under the License. */
 #include "lite/backends/x86/math/beam_search.h"
 #include <algorithm>
 #include <cmath>
-#include <map>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/fluid/lod.h"
 
 namespace paddle {
@@ -23,6 +24,127 @@ namespace lite {
 namespace x86 {
 namespace math {
 
+namespace {
+
+/*
+ * The basic items help to sort.
+ */
+struct Item {
+  // offset in the higher lod level.
+  size_t offset;
+  // the candidate id
+  int64_t id;
+  // the corresponding score
+  float score;
+
+  inline bool operator<(const Item &in) const {
+    return (score < in.score) || ((score == in.score) && (offset < in.offset));
+  }
+};
+
+// Inserts item into top_beam[0, *num_beams), which is sorted in descending
+// order and holds at most beam_size items.
+inline void Insert(Item *top_beam,
+                   size_t *num_beams,
+                   const Item &item,
+                   size_t beam_size) {
+  size_t num = *num_beams;
+  if (num < beam_size) {
+    num++;
+    *num_beams = num;
+  } else if (item < top_beam[beam_size - 1]) {
+    return;
+  }
+
+  for (int k = static_cast<int>(num) - 2; k >= 0; --k) {
+    if (top_beam[k] < item) {
+      top_beam[k + 1] = top_beam[k];
+    } else {
+      top_beam[k + 1] = item;
+      return;
+    }
+  }
+  top_beam[0] = item;
+}
+
+// The candidates of a row are checked in blocks, a block is skipped at once
+// when all of its values are below the threshold of the full beam.
+constexpr size_t kBlockSize = 16;
+
+inline float BlockMax(const float *data, size_t size) {
+  float max = data[0];
+  for (size_t i = 1; i < size; ++i) {
+    max = data[i] > max ? data[i] : max;
+  }
+  return max;
+}
+
+/*
+ * Select the top beam_size items of the source whose prefixes are the rows
+ * [seq_offset_start, seq_offset_end) of scores, returns the number of items.
+ */
+size_t SelectTopBeamSizeItems(const int64_t *pre_ids_data,
+                              const float *pre_scores_data,
+                              const int64_t *ids_data,
+                              const float *scores_data,
+                              size_t seq_width,
+                              size_t seq_offset_start,
+                              size_t seq_offset_end,
+                              size_t beam_size,
+                              int end_id,
+                              bool is_accumulated,
+                              Item *top_beam) {
+  size_t num_beams = 0;
+  for (size_t offset = seq_offset_start; offset < seq_offset_end; ++offset) {
+    auto pre_id = pre_ids_data[offset];
+    auto pre_score = pre_scores_data[offset];
+    if (pre_id == end_id) {
+      // Allocate all probability mass to end_id for finished branchs and
+      // the other candidate ids can be ignored.
+      Item item{offset, end_id, pre_score};
+      Insert(top_beam, &num_beams, item, beam_size);
+      continue;
+    }
+    const float *row = scores_data + offset * seq_width;
+    // The raw score below which a candidate can not enter the full beam.
+    // For the scores not accumulated, the threshold is moved down by a
+    // margin so that the rounding of log never drops a candidate, the
+    // candidates passing the filter are compared exactly by Insert.
+    float threshold = 0.f;
+    auto update_threshold = [&]() {
+      if (num_beams < beam_size) return;
+      float last = top_beam[beam_size - 1].score;
+      if (is_accumulated) {
+        threshold = last;
+      } else {
+        float margin = 1e-4f * (1.f + std::fabs(last));
+        threshold = std::exp(last - pre_score - margin);
+      }
+    };
+    update_threshold();
+    for (size_t begin = 0; begin < seq_width; begin += kBlockSize) {
+      size_t end = std::min(begin + kBlockSize, seq_width);
+      if (num_beams == beam_size &&
+          BlockMax(row + begin, end - begin) < threshold) {
+        continue;
+      }
+      for (size_t d = begin; d < end; d++) {
+        if (num_beams == beam_size && row[d] < threshold) continue;
+        size_t index = offset * seq_width + d;
+        int64_t id = ids_data ? ids_data[index] : static_cast<int64_t>(d);
+        float score =
+            is_accumulated ? row[d] : pre_score + std::log(row[d]);
+        Item item{offset, id, score};
+        Insert(top_beam, &num_beams, item, beam_size);
+        update_threshold();
+      }
+    }
+  }
+  return num_beams;
+}
+
+}  // namespace
+
 template <typename T>
 class BeamSearchFunctor<TARGET(kX86), T> {
  public:
@@ -40,278 +162,119 @@ class BeamSearchFunctor<TARGET(kX86), T> {
                   bool is_accumulated) {
     auto abs_lod = lite::fluid::ToAbsOffset(scores->lod());
     auto &high_level = abs_lod[level];
+    size_t num_seqs = high_level.size() - 1;
+    size_t seq_width = 1;
+    for (size_t i = 1; i < scores->dims().size(); i++) {
+      seq_width *= scores->dims()[i];
+    }
 
-    auto items = SelectTopBeamSizeItems(pre_ids,
-                                        pre_scores,
-                                        ids,
-                                        scores,
-                                        level,
-                                        beam_size,
-                                        end_id,
-                                        is_accumulated);
-    auto selected_items = ToMap(items, high_level.back());
-    /*
-    if (FLAGS_v == 3) {
-      VLOG(3) << "selected_items:";
-      for (size_t i = 0; i < selected_items.size(); ++i) {
-        VLOG(3) << "offset: " << i;
-        for (auto &item : selected_items[i]) {
-          VLOG(3) << item.ToString();
+    auto *pre_ids_data = pre_ids->data<int64_t>();
+    auto *pre_scores_data = pre_scores->data<float>();
+    auto *ids_data = ids ? ids->data<int64_t>() : nullptr;
+    auto *scores_data = scores->data<float>();
+
+    // The selected items of every source, reused across the steps.
+    static thread_local std::vector<Item> items;
+    static thread_local std::vector<size_t> items_num;
+    items.resize(num_seqs * beam_size);
+    items_num.resize(num_seqs);
+    // The scratch is thread local, the workers use it through pointers.
+    Item *items_data = items.data();
+    size_t *items_num_data = items_num.data();
+
+    // The sources are independent of each other.
+    lite::x86::RunParallelFor(0, num_seqs, [&](int64_t begin, int64_t end) {
+      for (int64_t seq_id = begin; seq_id < end; ++seq_id) {
+        Item *top_beam = items_data + seq_id * beam_size;
+        size_t num = SelectTopBeamSizeItems(pre_ids_data,
+                                            pre_scores_data,
+                                            ids_data,
+                                            scores_data,
+                                            seq_width,
+                                            high_level[seq_id],
+                                            high_level[seq_id + 1],
+                                            beam_size,
+                                            end_id,
+                                            is_accumulated,
+                                            top_beam);
+        // Group the items by their prefixes, the items of a prefix keep
+        // the descending order.
+        std::stable_sort(top_beam,
+                         top_beam + num,
+                         [](const Item &a, const Item &b) {
+                           return a.offset < b.offset;
+                         });
+        if (PruneEndBeam(pre_ids_data, top_beam, num, end_id)) {
+          num = 0;
         }
+        items_num_data[seq_id] = num;
       }
-    }
-    */
+    });
 
-    PruneEndBeams(pre_ids, abs_lod, &selected_items, level, end_id);
     // calculate the output tensor's height
-    size_t num_instances = std::accumulate(
-        std::begin(selected_items),
-        std::end(selected_items),
-        0,
-        [](size_t a, std::vector<Item> &b) { return a + b.size(); });
+    size_t num_instances = 0;
+    for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+      num_instances += items_num[seq_id];
+    }
     // the output tensor shape should be [num_instances, 1]
-    // auto dims = framework::make_ddim(
-    //     std::vector<int64_t>({static_cast<int>(num_instances), 1}));
     lite::DDim dims(
-        std::vector<int64_t>({static_cast<int>(num_instances), 1L}));
-
+        std::vector<int64_t>({static_cast<int64_t>(num_instances), 1L}));
     selected_ids->Resize(dims);
     auto *selected_ids_data = selected_ids->mutable_data<int64_t>(TARGET(kX86));
-
     selected_scores->Resize(dims);
     auto *selected_scores_data =
-        selected_scores->mutable_data<int64_t>(TARGET(kX86));
-
-    // auto *selected_ids_data =
-    //    selected_ids->mutable_data<int64_t>(dims, platform::CPUPlace());
-    // auto *selected_scores_data =
-    //    selected_scores->mutable_data<float>(dims, platform::CPUPlace());
-    parent_idx->Resize({static_cast<int64_t>(num_instances)});
-    auto *parent_idx_data =
-        parent_idx ? parent_idx->mutable_data<int>(TARGET(kX86)) : nullptr;
-    // auto *parent_idx_data =
-    //    parent_idx
-    //        ? parent_idx->mutable_data<int>(
-    //              {static_cast<int64_t>(num_instances)}, platform::CPUPlace())
-    //        : nullptr;
+        selected_scores->mutable_data<float>(TARGET(kX86));
+    int *parent_idx_data = nullptr;
+    if (parent_idx) {
+      parent_idx->Resize({static_cast<int64_t>(num_instances)});
+      parent_idx_data = parent_idx->mutable_data<int>(TARGET(kX86));
+    }
 
-    // fill in data
-    std::vector<uint64_t> low_level;
+    // fill in data, the items are already ordered by their prefixes
+    std::vector<uint64_t> low_level(high_level.back() + 1, 0);
     uint64_t low_offset = 0;
-    for (auto &items : selected_items) {
-      low_level.push_back(low_offset);
-      for (auto &item : items) {
-        if (parent_idx) {
-          parent_idx_data[low_offset] = static_cast<int>(low_level.size() - 1);
+    for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+      const Item *top_beam = items.data() + seq_id * beam_size;
+      for (size_t i = 0; i < items_num[seq_id]; ++i) {
+        const Item &item = top_beam[i];
+        low_level[item.offset + 1]++;
+        if (parent_idx_data) {
+          parent_idx_data[low_offset] = static_cast<int>(item.offset);
         }
         selected_ids_data[low_offset] = item.id;
         selected_scores_data[low_offset] = item.score;
         low_offset++;
       }
     }
-    low_level.push_back(low_offset);
+    for (size_t i = 1; i < low_level.size(); ++i) {
+      low_level[i] += low_level[i - 1];
+    }
 
     // fill lod
     lite::LoD lod(2);
     lod[0].assign(high_level.begin(), high_level.end());
-    lod[1].assign(low_level.begin(), low_level.end());
-    // if (!lite::fluid::CheckLoD(lod)) {
-    //  //PADDLE_THROW("lod %s is not right", framework::LoDToString(lod));
-    //}
+    lod[1] = std::move(low_level);
     selected_ids->set_lod(lod);
     selected_scores->set_lod(lod);
   }
 
-  /*
-   * The basic items help to sort.
-   */
-  struct Item {
-    Item() {}
-    Item(size_t offset, size_t id, float score)
-        : offset(offset), id(id), score(score) {}
-    // offset in the higher lod level.
-    size_t offset;
-    // prefix id in the lower lod level.
-    // size_t prefix;
-    // the candidate id
-    size_t id;
-    // the corresponding score
-    float score;
-
-    inline bool operator<(const Item &in) const {
-      return (score < in.score) ||
-             ((score == in.score) && (offset < in.offset));
-    }
-
-    inline void operator=(const Item &in) {
-      offset = in.offset;
-      id = in.id;
-      score = in.score;
-    }
-
-    std::string ToString() {
-      std::ostringstream os;
-      os << "{";
-      os << "offset: " << offset << ", ";
-      os << "id: " << id << ", ";
-      os << "score: " << score << "";
-      os << "}";
-      return os.str();
-    }
-  };
-
  protected:
   /*
-   * Prune the source sentences all branchs finished, and it is optional.
-   * Pruning must one step later than finishing (thus pre_ids is needed here),
-   * since the end tokens must be writed out.
+   * Whether all branchs of the source sentence end, in which case the source
+   * is pruned. Pruning must one step later than finishing (thus pre_ids is
+   * needed here), since the end tokens must be writed out.
    */
-  void PruneEndBeams(const lite::Tensor *pre_ids,
-                     const lite::LoD &abs_lod,
-                     std::vector<std::vector<Item>> *items,
-                     size_t lod_level,
-                     int end_id) {
-    auto *pre_ids_data = pre_ids->data<int64_t>();
-    auto &high_level = abs_lod[lod_level];
-    for (size_t src_idx = 0; src_idx < high_level.size() - 1; ++src_idx) {
-      size_t src_prefix_start = high_level[src_idx];
-      size_t src_prefix_end = high_level[src_idx + 1];
-      bool finish_flag = true;
-      for (size_t offset = src_prefix_start; offset < src_prefix_end;
-           offset++) {
-        for (auto &item : items->at(offset)) {
-          if (item.id != static_cast<size_t>(end_id) ||
-              pre_ids_data[offset] != end_id) {
-            finish_flag = false;
-            break;
-          }
-        }
-        if (!finish_flag) break;
-      }
-      if (finish_flag) {  // all branchs of the beam (source sentence) end and
-                          // prune this beam
-        for (size_t offset = src_prefix_start; offset < src_prefix_end;
-             offset++)
-          items->at(offset).clear();
-      }
-    }
-  }
-
-  /*
-   * Transform the items into a map whose key is offset, value is the items.
-   * NOTE low performance.
-   */
-  std::vector<std::vector<Item>> ToMap(
-      const std::vector<std::vector<Item>> &items, size_t element_num) {
-    std::vector<std::vector<Item>> result;
-    result.resize(element_num);
-    for (auto &entries : items) {
-      for (const auto &item : entries) {
-        result[item.offset].push_back(item);
-      }
-    }
-    return result;
-  }
-
-  void Insert(std::vector<Item> *top_beam_ptr,
-              const Item &item,
-              size_t beam_size) {
-    std::vector<Item> &top_beam = *top_beam_ptr;
-
-    size_t num_beams = top_beam.size();
-    if (num_beams < beam_size) {
-      top_beam.resize(num_beams + 1);
-      num_beams++;
-    } else {
-      if (item < top_beam[beam_size - 1]) {
-        return;
-      }
-    }
-
-    for (int k = static_cast<int>(num_beams) - 2; k >= 0; --k) {
-      if (top_beam[k] < item) {
-        top_beam[k + 1] = top_beam[k];
-      } else {
-        top_beam[k + 1] = item;
-        return;
-      }
-    }
-    top_beam[0] = item;
-  }
-
-  /*
-   * For each source, select top beam_size records.
-   */
-  std::vector<std::vector<Item>> SelectTopBeamSizeItems(
-      const lite::Tensor *pre_ids,
-      const lite::Tensor *pre_scores,
-      const lite::Tensor *ids,
-      const lite::Tensor *scores,
-      size_t lod_level,
-      size_t beam_size,
-      int end_id,
-      bool is_accumulated) {
-    std::vector<std::vector<Item>> result;
-
-    // find the current candidates
-    auto abs_lod = lite::fluid::ToAbsOffset(scores->lod());
-
-    auto *pre_ids_data = pre_ids->data<int64_t>();
-    auto *pre_scores_data = pre_scores->data<float>();
-
-    auto *ids_data = ids ? ids->data<int64_t>() : nullptr;
-    auto *scores_data = scores->data<float>();
-
-    // size_t num_seqs = scores->NumElements(lod_level);
-    size_t num_seqs = scores->lod()[lod_level].size() - 1;
-    size_t seq_width = 1;
-    for (int i = 1; i < scores->dims().size(); i++) {
-      seq_width *= scores->dims()[i];
-    }
-
-    for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
-      size_t seq_offset_start = abs_lod[lod_level][seq_id];
-      size_t seq_offset_end = abs_lod[lod_level][seq_id + 1];
-
-      std::vector<Item> top_beam;
-      top_beam.reserve(beam_size);
-
-      for (size_t offset = seq_offset_start; offset < seq_offset_end;
-           ++offset) {
-        auto pre_id = pre_ids_data[offset];
-        auto pre_score = pre_scores_data[offset];
-        if (pre_id == end_id) {
-          // Allocate all probability mass to end_id for finished branchs and
-          // the other candidate ids can be ignored.
-          Item item(offset, end_id, pre_score);
-          Insert(&top_beam, item, beam_size);
-        } else {
-          size_t index = offset * seq_width;
-          for (size_t d = 0; d < seq_width; d++, index++) {
-            int64_t id = ids_data ? ids_data[index] : static_cast<int64_t>(d);
-            float score = is_accumulated
-                              ? scores_data[index]
-                              : pre_score + std::log(scores_data[index]);
-            Item item(offset, id, score);
-            Insert(&top_beam, item, beam_size);
-          }
-        }
-      }
-
-      result.emplace_back(top_beam);
-    }
-    /*
-    if (FLAGS_v == 3) {
-      VLOG(3) << "SelectTopBeamSizeItems result size " << result.size();
-      for (auto &items : result) {
-        VLOG(3) << "item set:";
-        for (auto &item : items) {
-          VLOG(3) << item.ToString();
-        }
+  static bool PruneEndBeam(const int64_t *pre_ids_data,
+                           const Item *top_beam,
+                           size_t num,
+                           int end_id) {
+    for (size_t i = 0; i < num; ++i) {
+      if (top_beam[i].id != end_id ||
+          pre_ids_data[top_beam[i].offset] != end_id) {
+        return false;
       }
     }
-    */
-    return result;
+    return true;
   }
 };
 
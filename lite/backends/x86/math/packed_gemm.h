@@ -0,0 +1,116 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/x86/math/blas.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The right-hand matrix W[K, N] of the GEMMs C[M, N] += A[M, K] * W, packed
+// once and reused by every call. It is used for the recurrent weights of the
+// RNN kernels, which are multiplied once per time step. Without MKL the
+// weight is used in place.
+template <typename T>
+class PackedGemmWeight {
+ public:
+  PackedGemmWeight() = default;
+  PackedGemmWeight(const PackedGemmWeight&) = delete;
+  PackedGemmWeight& operator=(const PackedGemmWeight&) = delete;
+
+  ~PackedGemmWeight() { Reset(); }
+
+  bool packed() const { return weight_ != nullptr; }
+
+  void Pack(const lite::Context<TARGET(kX86)>& context,
+            const T* weight,
+            int k,
+            int n) {
+    Reset();
+    k_ = k;
+    n_ = n;
+#ifdef PADDLE_WITH_MKLML
+    auto blas = GetBlas<TARGET(kX86), T>(context);
+    packed_ = blas.GEMM_ALLOC(CblasBMatrix, 1, n, k);
+    CHECK(packed_);
+    blas.GEMM_PACK(
+        CblasBMatrix, CblasNoTrans, 1, n, k, T(1), weight, n, packed_);
+#endif
+    weight_ = weight;
+  }
+
+  void Compute(const lite::Context<TARGET(kX86)>& context,
+               int m,
+               const T* a,
+               int lda,
+               T* c,
+               int ldc) const {
+    CHECK(packed());
+    auto blas = GetBlas<TARGET(kX86), T>(context);
+#ifdef PADDLE_WITH_MKLML
+    blas.GEMM_COMPUTE(CblasNoTrans,
+                      CblasPacked,
+                      m,
+                      n_,
+                      k_,
+                      a,
+                      lda,
+                      packed_,
+                      n_,
+                      T(1),
+                      c,
+                      ldc);
+#else
+    blas.GEMM(CblasNoTrans,
+              CblasNoTrans,
+              m,
+              n_,
+              k_,
+              T(1),
+              a,
+              lda,
+              weight_,
+              n_,
+              T(1),
+              c,
+              ldc);
+#endif
+  }
+
+ private:
+  void Reset() {
+#ifdef PADDLE_WITH_MKLML
+    if (packed_) {
+      CBlas<T>::GEMM_FREE(packed_);
+      packed_ = nullptr;
+    }
+#endif
+    weight_ = nullptr;
+  }
+
+  const T* weight_{nullptr};
+#ifdef PADDLE_WITH_MKLML
+  T* packed_{nullptr};
+#endif
+  int k_{0};
+  int n_{0};
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -13,12 +13,75 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/x86/math/sequence2batch.h"
+#include <list>
+#include <utility>
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
 
+namespace {
+
+std::shared_ptr<const SeqPackedLayout> ComputeSeqPackedLayout(
+    const std::vector<uint64_t>& lod, bool is_reverse) {
+  PADDLE_ENFORCE_GT(lod.size(), 1UL, "The LoD should not be empty.");
+  size_t seq_num = lod.size() - 1;
+  std::shared_ptr<SeqPackedLayout> layout(new SeqPackedLayout);
+  auto& seq_order = layout->seq_order;
+  seq_order.resize(seq_num);
+  for (size_t i = 0; i < seq_num; ++i) {
+    seq_order[i] = i;
+  }
+  std::stable_sort(
+      seq_order.begin(), seq_order.end(), [&lod](uint64_t a, uint64_t b) {
+        return lod[a + 1] - lod[a] > lod[b + 1] - lod[b];
+      });
+
+  size_t max_seqlen = lod[seq_order[0] + 1] - lod[seq_order[0]];
+  auto& batch_starts = layout->batch_starts;
+  auto& seq2batch_idx = layout->seq2batch_idx;
+  batch_starts.resize(max_seqlen + 1);
+  seq2batch_idx.resize(lod.back() - lod.front());
+  batch_starts[0] = 0;
+  size_t batch_id = 0;
+  for (size_t n = 0; n < max_seqlen; ++n) {
+    for (size_t i = 0; i < seq_num; ++i) {
+      uint64_t start = lod[seq_order[i]];
+      uint64_t seq_len = lod[seq_order[i] + 1] - start;
+      if (n >= seq_len) break;
+      seq2batch_idx[batch_id++] =
+          is_reverse ? start + seq_len - 1 - n : start + n;
+    }
+    batch_starts[n + 1] = batch_id;
+  }
+  return layout;
+}
+
+}  // namespace
+
+std::shared_ptr<const SeqPackedLayout> GetSeqPackedLayout(
+    const std::vector<uint64_t>& lod, bool is_reverse) {
+  // A few entries are enough for the forward and reverse layouts of the
+  // LoDs alive in one request.
+  static constexpr size_t kCacheSize = 4;
+  using Entry = std::pair<std::pair<std::vector<uint64_t>, bool>,
+                          std::shared_ptr<const SeqPackedLayout>>;
+  static thread_local std::list<Entry> cache;
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    if (it->first.second == is_reverse && it->first.first == lod) {
+      cache.splice(cache.begin(), cache, it);
+      return cache.front().second;
+    }
+  }
+  auto layout = ComputeSeqPackedLayout(lod, is_reverse);
+  cache.emplace_front(std::make_pair(lod, is_reverse), layout);
+  if (cache.size() > kCacheSize) {
+    cache.pop_back();
+  }
+  return layout;
+}
+
 template <typename T>
 class CopyMatrixRowsFunctor<lite::TargetType::kX86, T> {
  public:
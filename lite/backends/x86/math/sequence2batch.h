@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "lite/core/context.h"
@@ -41,23 +42,49 @@ class CopyMatrixRowsFunctor {
                   bool is_src_index);
 };
 
+// The time-major packed layout of a batch of sequences, the rows of the
+// sequences sorted by length (descending) are interleaved step by step.
+// example:  sequences = {s0, s1, s2}
+//           s0: 0 0 0 0, s1: 1 1 1 1 1, s2: 2 2 2
+//           max_seqlen = 5,
+//           batchIndex = {b0, b1, b2, b3, b4}
+//           b0: 1 0 2, b1: 1 0 2, b2: 1 0 2, b3: 1 0, b4: 1
+//           batch_starts[6] = {0, 3, 6, 9, 11, 12}
+//              batch_starts[0] = len(b0)
+//              batch_starts[1] = len(b0) + len(b1)
+//              batch_starts[2] = len(b0) + len(b1) + len(b2)
+//              ...
+//           seq2batch_idx[12] = {4, 0, 9,
+//                                5, 1, 10,
+//                                6, 2, 11,
+//                                7, 3,
+//                                8}
+//           seq_order = {1, 0, 2}, the sort order.
+//               where 1 is the second sequence,
+//                     0 is the first sequence,
+//                     2 is the third sequence.
+// The max_seqlen represents batch size after rearranging the
+// input LodTensor. It is also the maximum length of input sequence.
+// If is_reverse is true, the rows of every sequence are visited from the
+// last one, the steps are still filled from the longest sequence.
+struct SeqPackedLayout {
+  // The start positions of the steps in the packed rows.
+  std::vector<uint64_t> batch_starts;
+  // The raw index in the input LoDTensor of every packed row.
+  std::vector<uint64_t> seq2batch_idx;
+  // The sequences sorted by length, which is also the order of the rows in
+  // every step.
+  std::vector<uint64_t> seq_order;
+};
+
+// Returns the packed layout of the level-0 LoD `lod`. The layouts of the
+// recently seen LoDs are cached per thread, so the sequence kernels running
+// on the same LoD within a request compute it only once.
+std::shared_ptr<const SeqPackedLayout> GetSeqPackedLayout(
+    const std::vector<uint64_t>& lod, bool is_reverse);
+
 template <lite::TargetType Target, typename T>
 class LoDTensor2BatchFunctor {
-  // Calculate the length of each sequence and
-  // sort sequence index by the length.
-  // example:  sequences = {s0, s1, s2}
-  //           s0: 0 0 0 0, s1: 1 1 1 1 1, s2: 2 2 2
-  //           seq_info[3] = {(4, 5, 1), (0, 4, 0), (9, 3, 2)}
-  //
-  struct SeqInfo {
-    SeqInfo() = default;
-    SeqInfo(int start, int length, int seq_idx)
-        : start(start), length(length), seq_idx(seq_idx) {}
-    int start;
-    int length;
-    int seq_idx;
-  };
-
  public:
   void operator()(const lite::Context<Target>& context,
                   const lite::Tensor& lod_tensor,
@@ -82,79 +109,15 @@ class LoDTensor2BatchFunctor {
     auto lods = lod_tensor.lod();
     PADDLE_ENFORCE_EQ(lods.size(), 1UL, "Only support one level sequence now.");
 
-    const auto& lod = lods[0];
-
-    std::vector<SeqInfo> seq_info(lod.size() - 1);
-    for (size_t seq_id = 0; seq_id < lod.size() - 1; ++seq_id) {
-      int length = lod[seq_id + 1] - lod[seq_id];
-      seq_info[seq_id].start = lod[seq_id];
-      seq_info[seq_id].length = length;
-      seq_info[seq_id].seq_idx = seq_id;
-    }
-
-    std::sort(seq_info.begin(), seq_info.end(), [](SeqInfo a, SeqInfo b) {
-      return a.length > b.length;
-    });
-
-    // Calculate the start position of each batch.
-    // example:  sequences = {s0, s1, s2}
-    //           s0: 0 0 0 0, s1: 1 1 1 1 1, s2: 2 2 2
-    //           max_seqlen = 5,
-    //           batchIndex = {b0, b1, b2, b3, b4}
-    //           b0: 1 0 2, b1: 1 0 2, b2: 1 0 2, b3: 1 0, b4: 1
-    //           batch_start_positions[6] = {0, 3, 6, 9, 11, 12}
-    //              batch_start_positions[0] = len(b0)
-    //              batch_start_positions[1] = len(b0) + len(b1)
-    //              batch_start_positions[2] = len(b0) + len(b1) + len(b2)
-    //              ...
-    //           seq2batch_idx[12] = {4, 0, 9,
-    //                                5, 1, 10,
-    //                                6, 2, 11,
-    //                                7, 3,
-    //                                8}
-    //           seq_order = {1, 0, 2}, the sort order.
-    //               where 1 is the second sequence,
-    //                     0 is the first sequence,
-    //                     2 is the third sequence.
-    // The max_seqlen represents batch size after rearranging the
-    // input LodTensor. It is also the maximum length of input sequence.
-
-    LoD* batch_lods = batch->mutable_lod();
-    batch_lods->resize(3);
-
+    auto layout = GetSeqPackedLayout(lods[0], is_reverse);
     // batch_lods[0] is the start positions for batch LoDTensor
-    int max_seqlen = seq_info[0].length;
-    batch_lods->at(0).resize(static_cast<size_t>(max_seqlen + 1));
     // batch_lods[1] is the raw index in the input LoDTensor
-    batch_lods->at(1).resize(static_cast<size_t>(lod_tensor.dims()[0]));
     // batch_lods[2] is the sort order for the input LoDTensor.
-    batch_lods->at(2).resize(seq_info.size());
-
-    auto* batch_starts = batch_lods->at(0).data();
-    auto* seq2batch_idx = batch_lods->at(1).data();
-    batch_starts[0] = 0;
-    for (int n = 0; n < max_seqlen; n++) {
-      auto batch_id = static_cast<int>(batch_starts[n]);
-      for (size_t i = 0; i < seq_info.size(); ++i) {
-        int seq_len = seq_info[i].length;
-        int start = seq_info[i].start;
-        if (n < seq_len) {
-          seq2batch_idx[batch_id] =
-              is_reverse ? start + seq_len - 1 - n : start + n;
-          batch_id++;
-        } else {
-          break;
-        }
-      }
-      batch_starts[n + 1] = static_cast<size_t>(batch_id);
-    }
-    auto* seq_order = batch_lods->at(2).data();
-    for (size_t i = 0; i < seq_info.size(); ++i) {
-      seq_order[i] = seq_info[i].seq_idx;
-    }
+    batch->set_lod(
+        {layout->batch_starts, layout->seq2batch_idx, layout->seq_order});
 
     CopyMatrixRowsFunctor<Target, T> to_batch;
-    to_batch(context, lod_tensor, batch_lods->at(1), batch, true);
+    to_batch(context, lod_tensor, layout->seq2batch_idx, batch, true);
   }
 };
 
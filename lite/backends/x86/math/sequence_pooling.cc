@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <cstring>
 #include <string>
 
 #include "lite/backends/x86/jit/kernels.h"
@@ -19,6 +20,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/math_function.h"
 #include "lite/backends/x86/math/sequence_pooling.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/fluid/eigen.h"
 
 namespace paddle {
@@ -35,6 +37,13 @@ template <typename T,
           typename IndexType = Eigen::DenseIndex>
 using EigenMatrix = lite::fluid::EigenMatrix<T, MajorType, IndexType>;
 
+template <typename T>
+static inline void FillPadValue(T* dst, int64_t width, T pad_value) {
+  for (int64_t k = 0; k < width; ++k) {
+    dst[k] = pad_value;
+  }
+}
+
 template <typename T, bool is_test>
 class MaxSeqPoolFunctor {
  public:
@@ -53,34 +62,39 @@ class MaxSeqPoolFunctor {
     }
     PADDLE_ENFORCE_EQ(idx_dims, out_dims);
 
-    auto starts = input.lod()[0];
+    const auto& starts = input.lod()[0];
     const T* in_data = input.data<T>();
     T* out_data = output->template mutable_data<T>();
     int* max_index = index->mutable_data<int>();
 
     int64_t num_seq = out_dims[0];
     int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-          max_index[i * dim + k] = -1;
-        }
-        continue;
-      }
-      for (int64_t k = 0; k < dim; ++k) {
-        out_data[i * dim + k] = in_data[starts[i] * dim + k];
-        max_index[i * dim + k] = starts[i];
-      }
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
-            max_index[i * dim + k] = j;
+    x86::RunParallelForByLoD(
+        starts, dim, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            T* out = out_data + i * dim;
+            int* out_index = max_index + i * dim;
+            if (starts[i] == starts[i + 1]) {
+              FillPadValue(out, dim, pad_value);
+              for (int64_t k = 0; k < dim; ++k) {
+                out_index[k] = -1;
+              }
+              continue;
+            }
+            std::memcpy(out, in_data + starts[i] * dim, dim * sizeof(T));
+            for (int64_t k = 0; k < dim; ++k) {
+              out_index[k] = starts[i];
+            }
+            for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
+              const T* in = in_data + j * dim;
+              for (int64_t k = 0; k < dim; ++k) {
+                bool greater = in[k] > out[k];
+                out[k] = greater ? in[k] : out[k];
+                out_index[k] = greater ? static_cast<int>(j) : out_index[k];
+              }
+            }
           }
-        }
-      }
-    }
+        });
   }
 };
 // Instantisation of Max Sequence Pooling for test phase eg. no need to fill
@@ -101,29 +115,29 @@ class MaxSeqPoolFunctor<T, true> {
       PADDLE_ENFORCE_EQ(in_dims[i], out_dims[i]);
     }
 
-    auto starts = input.lod()[0];
+    const auto& starts = input.lod()[0];
     const T* in_data = input.data<T>();
     T* out_data = output->template mutable_data<T>();
 
     int64_t num_seq = out_dims[0];
     int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-        }
-        continue;
-      }
-      std::memcpy(
-          &out_data[i * dim], &in_data[starts[i] * dim], dim * sizeof(T));
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
+    x86::RunParallelForByLoD(
+        starts, dim, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            T* out = out_data + i * dim;
+            if (starts[i] == starts[i + 1]) {
+              FillPadValue(out, dim, pad_value);
+              continue;
+            }
+            std::memcpy(out, in_data + starts[i] * dim, dim * sizeof(T));
+            for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
+              const T* in = in_data + j * dim;
+              for (int64_t k = 0; k < dim; ++k) {
+                out[k] = in[k] > out[k] ? in[k] : out[k];
+              }
+            }
           }
-        }
-      }
-    }
+        });
   }
 };
 template <typename T>
@@ -161,6 +175,31 @@ class MaxSeqPoolGradFunctor {
   }
 };
 
+// Copies one row of every sequence to the output, the first row when
+// first is set and the last one otherwise.
+template <typename T>
+static void EdgeSeqPool(const lite::Tensor& input,
+                        T pad_value,
+                        bool first,
+                        lite::Tensor* output) {
+  const T* in_data = input.data<T>();
+  T* out_data = output->template mutable_data<T>();
+  int64_t item_size = input.numel() / input.dims()[0];
+  const auto& lod = input.lod()[0];
+  x86::RunParallelForByLoD(
+      lod, item_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          T* out = out_data + i * item_size;
+          if (lod[i] == lod[i + 1]) {
+            FillPadValue(out, item_size, pad_value);
+          } else {
+            uint64_t row = first ? lod[i] : lod[i + 1] - 1;
+            std::memcpy(out, in_data + row * item_size, item_size * sizeof(T));
+          }
+        }
+      });
+}
+
 template <typename T>
 class LastSeqPoolFunctor {
  public:
@@ -168,29 +207,7 @@ class LastSeqPoolFunctor {
                   const lite::Tensor& input,
                   T pad_value,
                   lite::Tensor* output) {
-    // Create pointers to input and output data
-    auto* in_data = input.data<T>();
-    auto* out_data = output->template mutable_data<T>();
-
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[0];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
-        }
-      } else {
-        // Point to the begin of next sequence
-        in_data += seq_len * item_size;
-        // Copy the last item of sequence to output
-        std::memcpy(out_data, (in_data - item_size), item_size * sizeof(T));
-      }
-      out_data += item_size;
-    }
+    EdgeSeqPool<T>(input, pad_value, false, output);
   }
 };
 
@@ -201,29 +218,7 @@ class FirstSeqPoolFunctor {
                   const lite::Tensor& input,
                   T pad_value,
                   lite::Tensor* output) {
-    // Create pointers to input and output data
-    auto* in_data = input.data<T>();
-    auto* out_data = output->template mutable_data<T>();
-
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[0];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
-        }
-      } else {
-        // Copy the first item of sequence to output
-        std::memcpy(out_data, in_data, item_size * sizeof(T));
-        // Point to the next sequence
-        in_data += seq_len * item_size;
-      }
-      out_data += item_size;
-    }
+    EdgeSeqPool<T>(input, pad_value, true, output);
   }
 };
 
@@ -285,54 +280,39 @@ class SequencePoolFunctor<TARGET(kX86), T> {
       return;
     }
 
-    auto lod = input.lod()[0];
+    jit::SeqPoolType type;
     if (pooltype == "SUM") {
-      const T* src = input.data<T>();
-      T* dst = output->template mutable_data<T>(TARGET(kX86));
-      jit::seq_pool_attr_t attr(
-          static_cast<int>(input.numel() / input.dims()[0]),
-          jit::SeqPoolType::kSum);
-      auto seqpool =
-          jit::KernelFuncs<jit::SeqPoolTuple<T>, lite::fluid::CPUPlace>::Cache()
-              .At(attr);
-      for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-        attr.h = static_cast<int>(lod[i + 1] - lod[i]);
-        if (attr.h == 0) {
-          for (int j = 0; j < attr.w; ++j) {
-            dst[j] = pad_value;
-          }
-        } else {
-          seqpool(src, dst, &attr);
-        }
-        dst += attr.w;
-        src += attr.h * attr.w;
-      }
-      return;
-    }
-    auto eigen_device = lite::fluid::EigenDeviceType<TARGET(kX86)>();
-    for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      Tensor out_t = output->Slice<float>(i, i + 1);
-      int64_t w = input.numel() / input.dims()[0];
-      if (lod[i] == lod[i + 1]) {
-        for (int j = 0; j < w; ++j) {
-          out_t.mutable_data<T>()[j] = pad_value;
-        }
-        continue;
-      }
-      Tensor in_t = input.Slice<float>(static_cast<int>(lod[i]),
-                                       static_cast<int>(lod[i + 1]));
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      auto in_e = EigenMatrix<T>::From(in_t, lite::DDim({h, w}));
-      auto out_e = EigenVector<T>::Flatten(out_t);
-      if (pooltype == "AVERAGE") {
-        out_e.device(eigen_device) = in_e.mean(Eigen::array<int, 1>({{0}}));
-      } else if (pooltype == "SQRT") {
-        out_e.device(eigen_device) = in_e.sum(Eigen::array<int, 1>({{0}})) /
-                                     std::sqrt(static_cast<T>(h));
-      } else {
-        PADDLE_THROW("unsupported pooling pooltype");
-      }
+      type = jit::SeqPoolType::kSum;
+    } else if (pooltype == "AVERAGE") {
+      type = jit::SeqPoolType::kAvg;
+    } else if (pooltype == "SQRT") {
+      type = jit::SeqPoolType::kSqrt;
+    } else {
+      PADDLE_THROW("unsupported pooling pooltype");
     }
+    // The reductions run in the JIT seqpool kernel, every thread works on
+    // its own copy of the attribute since the height changes per sequence.
+    const auto& lod = input.lod()[0];
+    const T* src = input.data<T>();
+    T* dst = output->template mutable_data<T>(TARGET(kX86));
+    jit::seq_pool_attr_t attr(
+        static_cast<int>(input.numel() / input.dims()[0]), type);
+    auto seqpool =
+        jit::KernelFuncs<jit::SeqPoolTuple<T>, lite::fluid::CPUPlace>::Cache()
+            .At(attr);
+    x86::RunParallelForByLoD(
+        lod, attr.w, [&](int64_t begin, int64_t end) {
+          jit::seq_pool_attr_t seq_attr = attr;
+          for (int64_t i = begin; i < end; ++i) {
+            T* out = dst + i * seq_attr.w;
+            seq_attr.h = static_cast<int>(lod[i + 1] - lod[i]);
+            if (seq_attr.h == 0) {
+              FillPadValue(out, seq_attr.w, pad_value);
+            } else {
+              seqpool(src + lod[i] * seq_attr.w, out, &seq_attr);
+            }
+          }
+        });
   }
 };
 
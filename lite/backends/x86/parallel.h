@@ -15,6 +15,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 #include "lite/backends/x86/mklml.h"
@@ -68,6 +71,47 @@ static inline void RunParallelFor(const int64_t begin,
   f(begin, end);
 }
 
+// Runs f on the sequences [0, lod.size() - 1) of a LoD level in parallel.
+// Every thread gets about the same number of rows rather than the same
+// number of sequences, so a long sequence does not hold up the others. Runs
+// serially when the rows of the given width hold too few elements to pay
+// for the threads.
+static inline void RunParallelForByLoD(const std::vector<uint64_t>& lod,
+                                       const int64_t width,
+                                       const ThreadHandler& f) {
+  const int64_t num_seq = static_cast<int64_t>(lod.size()) - 1;
+  if (num_seq <= 0) {
+    return;
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  const uint64_t total = lod[num_seq] - lod[0];
+  int64_t num_threads = std::min(GetMaxThreads(), num_seq);
+  if (num_threads > 1 && static_cast<int64_t>(total) * width >= (1 << 14)) {
+    // The first sequence of thread tid is the first one starting at or
+    // after the row lod[0] + total * tid / num_threads.
+    auto first_seq = [&](int64_t tid) -> int64_t {
+      if (tid >= num_threads) return num_seq;
+      uint64_t row = lod[0] + total * tid / num_threads;
+      return std::lower_bound(lod.begin(), lod.begin() + num_seq, row) -
+             lod.begin();
+    };
+#pragma omp parallel num_threads(num_threads)
+    {
+      int64_t tid = omp_get_thread_num();
+      int64_t begin_tid = tid == 0 ? 0 : first_seq(tid);
+      int64_t end_tid = first_seq(tid + 1);
+      if (begin_tid < end_tid) {
+        f(begin_tid, end_tid);
+      }
+    }
+    return;
+  }
+#endif
+
+  f(0, num_seq);
+}
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
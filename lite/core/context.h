@@ -42,6 +42,7 @@
 #include "lite/core/device_info.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
+#include "lite/core/workspace.h"
 #include "lite/utils/all.h"
 #include "lite/utils/env.h"
 
@@ -316,10 +317,32 @@ class Context<TargetType::kX86> {
 
   std::string name() const { return "X86Context"; }
 
- private:
-  // overall information
-  //
-  // kernel information
+  // The workspace is the temporary memory shared by the kernels running on the
+  // same thread rather than a state of the context. It only grows, and what a
+  // kernel allocates from it is released when the next kernel launches.
+
+  // Grow the workspace to `size` bytes, so that the first run doesn't need to.
+  // Kernels that know their temporary size can call it in PrepareForRun.
+  void ExtendWorkspace(size_t size) const {
+    WorkSpace::Global_X86().Reserve(size);
+  }
+
+  // Allocate `count` elements from the workspace.
+  template <typename T>
+  T* AllocWorkspace(size_t count) const {
+    return reinterpret_cast<T*>(
+        WorkSpace::Global_X86().Alloc(count * sizeof(T)));
+  }
+
+  // Back `tensor` with the workspace for its current dims.
+  template <typename T>
+  T* AllocWorkspace(Tensor* tensor) const {
+    size_t size = tensor->numel() * sizeof(T);
+    auto buffer = std::make_shared<Buffer>(
+        AllocWorkspace<T>(tensor->numel()), tensor->target(), size);
+    tensor->ResetBuffer(buffer, size);
+    return tensor->mutable_data<T>();
+  }
 };
 #endif
 
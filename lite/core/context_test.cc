@@ -18,6 +18,40 @@
 namespace paddle {
 namespace lite {
 
+#ifdef LITE_WITH_X86
+TEST(X86Context, workspace) {
+  X86Context ctx;
+  WorkSpace::Global_X86().AllocReset();
+  ctx.ExtendWorkspace(1024);
+  size_t capacity = WorkSpace::Global_X86().capacity();
+  ASSERT_GE(capacity, 1024UL);
+
+  float* a = ctx.AllocWorkspace<float>(3);
+  float* b = ctx.AllocWorkspace<float>(8);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0UL);
+  ASSERT_GE(b, a + 3);
+  ASSERT_EQ(WorkSpace::Global_X86().capacity(), capacity);
+  for (int i = 0; i < 3; i++) a[i] = i;
+
+  // Growing keeps the memory allocated before.
+  Tensor t;
+  t.Resize({static_cast<int64_t>(capacity)});
+  float* c = ctx.AllocWorkspace<float>(&t);
+  ASSERT_EQ(t.data<float>(), c);
+  ASSERT_GT(WorkSpace::Global_X86().capacity(), capacity);
+  for (int64_t i = 0; i < t.numel(); i++) c[i] = 0;
+  for (int i = 0; i < 3; i++) ASSERT_EQ(a[i], i);
+
+  // The workspace never shrinks, the next kernel reuses it.
+  capacity = WorkSpace::Global_X86().capacity();
+  WorkSpace::Global_X86().AllocReset();
+  float* d = ctx.AllocWorkspace<float>(t.numel());
+  WorkSpace::Global_X86().AllocReset();
+  ASSERT_EQ(ctx.AllocWorkspace<float>(t.numel()), d);
+  ASSERT_EQ(WorkSpace::Global_X86().capacity(), capacity);
+}
+#endif
+
 // #ifdef LITE_WITH_X86
 // TEST(ContextScheduler, NewContext) {
 //   auto ctx1_p = ContextScheduler::Global().NewContext(TargetType::kX86);
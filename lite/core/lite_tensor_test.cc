@@ -58,5 +58,42 @@ TEST(tensor, shared_memory) {
 #endif
 }
 
+TEST(tensor, ddim) {
+  DDim small(std::vector<int64_t>({2, 3, 4}));
+  EXPECT_EQ(small.production(), 24);
+  EXPECT_EQ(small.Slice(1, 3), DDim(std::vector<int64_t>({3, 4})));
+  EXPECT_EQ(small.Flatten2D(1), DDim(std::vector<int64_t>({2, 12})));
+
+  std::vector<int64_t> shape(DDim::kInlineSize + 2, 1);
+  shape.back() = 5;
+  DDim large(shape);
+  DDim copy = large;
+  copy[0] = 2;
+  EXPECT_EQ(large.production(), 5);
+  EXPECT_EQ(copy.production(), 10);
+  EXPECT_EQ(copy.Vectorize().size(), shape.size());
+  EXPECT_EQ(large.Slice(DDim::kInlineSize, shape.size()).production(), 5);
+  EXPECT_NE(large, copy);
+}
+
+TEST(tensor, lod_copy_on_write) {
+  TensorLite a;
+  a.set_lod({{0, 2, 5}});
+  TensorLite b = a;
+  EXPECT_EQ(&a.lod(), &b.lod());
+
+  b.mutable_lod()->push_back({0, 1, 2, 3, 4, 5});
+  EXPECT_EQ(a.lod().size(), 1UL);
+  EXPECT_EQ(b.lod().size(), 2UL);
+
+  TensorLite c;
+  c.ShareDataWith(b);
+  c.set_lod(a.lod());
+  EXPECT_EQ(b.lod().size(), 2UL);
+  EXPECT_EQ(c.lod(), a.lod());
+  c.set_lod({});
+  EXPECT_TRUE(c.lod().empty());
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/memory.h"
+#include "lite/backends/host/allocator.h"
 
 namespace paddle {
 namespace lite {
@@ -61,6 +62,17 @@ void* TargetMalloc(TargetType target, size_t size) {
   return data;
 }
 
+size_t TargetMallocSize(TargetType target, size_t size) {
+  switch (target) {
+    case TargetType::kHost:
+    case TargetType::kX86:
+    case TargetType::kARM:
+      return host::RoundUpSize(size);
+    default:
+      return size;
+  }
+}
+
 void TargetFree(TargetType target, void* data, std::string free_flag) {
   switch (target) {
     case TargetType::kHost:
@@ -46,6 +46,10 @@ namespace lite {
 // the `switch` here.
 LITE_API void* TargetMalloc(TargetType target, size_t size);
 
+// The number of bytes TargetMalloc actually provides for a request of `size`,
+// a buffer can grow up to it without a new allocation.
+size_t TargetMallocSize(TargetType target, size_t size);
+
 // Free memory for a specific Target. All the targets should be an element in
 // the `switch` here.
 void LITE_API TargetFree(TargetType target,
@@ -121,9 +125,9 @@ class Buffer {
     if (target != target_ || space_ < size) {
       CHECK_EQ(own_data_, true) << "Can not reset unowned buffer.";
       Free();
-      data_ = TargetMalloc(target, size);
+      space_ = TargetMallocSize(target, size);
+      data_ = TargetMalloc(target, space_);
       target_ = target;
-      space_ = size;
 #ifdef LITE_WITH_OPENCL
       cl_use_image2d_ = false;
 #endif
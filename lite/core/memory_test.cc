@@ -14,6 +14,12 @@
 
 #include "lite/core/memory.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include "lite/backends/host/allocator.h"
 
 namespace paddle {
 namespace lite {
@@ -30,5 +36,163 @@ TEST(memory, test) {
 #endif
 }
 
+TEST(memory, host_allocator_reuse) {
+  const size_t size = 1000;
+  size_t rounded = host::RoundUpSize(size);
+  ASSERT_GE(rounded, size);
+  EXPECT_EQ(TargetMallocSize(TARGET(kX86), size), rounded);
+  EXPECT_EQ(host::RoundUpSize(rounded), rounded);
+
+  void* a = host::Malloc(size);
+  ASSERT_TRUE(a);
+  EXPECT_EQ(reinterpret_cast<size_t>(a) % host::kMallocAlign, 0u);
+  memset(a, 1, rounded);
+  host::Free(a);
+  // The freed block goes to the thread cache and serves the same class.
+  void* b = host::Malloc(rounded);
+  EXPECT_EQ(a, b);
+  host::Free(b);
+
+  void* c = host::Malloc(size, true);
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(static_cast<char*>(c)[i], 0);
+  }
+  host::Free(c);
+
+  EXPECT_GT(host::CachedBytes(), 0u);
+  host::ReleaseCachedMemory();
+  EXPECT_EQ(host::CachedBytes(), 0u);
+}
+
+TEST(memory, host_target_malloc_zero) {
+  const size_t size = 3000;
+  const size_t rounded = TargetMallocSize(TARGET(kHost), size);
+  void* a = TargetMalloc(TARGET(kHost), rounded);
+  memset(a, 1, rounded);
+  TargetFree(TARGET(kHost), a);
+  // The cached block comes back cleared unless zeroing is turned off.
+  void* b = TargetMalloc(TARGET(kHost), rounded);
+  ASSERT_EQ(a, b);
+  for (size_t i = 0; i < rounded; ++i) {
+    ASSERT_EQ(static_cast<char*>(b)[i], 0);
+  }
+  memset(b, 1, rounded);
+  TargetFree(TARGET(kHost), b);
+
+  host::SetZeroOnMalloc(false);
+  void* c = TargetMalloc(TARGET(kHost), rounded);
+  ASSERT_EQ(a, c);
+  EXPECT_EQ(static_cast<char*>(c)[0], 1);
+  TargetFree(TARGET(kHost), c);
+  host::SetZeroOnMalloc(true);
+}
+
+TEST(memory, host_allocator_stats) {
+  auto stats = std::make_shared<host::AllocatorStats>();
+  void* a = nullptr;
+  void* b = nullptr;
+  {
+    host::ScopedAllocatorStats guard(stats);
+    a = host::Malloc(4096);
+    b = host::Malloc(100 << 20);
+  }
+  void* c = host::Malloc(4096);
+  EXPECT_EQ(stats->num_allocs.load(), 2);
+  EXPECT_GT(stats->bytes_in_use.load(), (100 << 20));
+  host::Free(a);
+  host::Free(b);
+  host::Free(c);
+  EXPECT_EQ(stats->num_frees.load(), 2);
+  EXPECT_EQ(stats->bytes_in_use.load(), 0);
+  EXPECT_GT(stats->peak_bytes_in_use.load(), (100 << 20));
+}
+
+TEST(memory, host_allocator_hugepage) {
+  host::SetAllocator(
+      std::make_shared<host::SystemAllocator>(host::HugePages::kTransparent));
+  const size_t size = 8 << 20;
+  void* a = host::Malloc(size);
+  ASSERT_TRUE(a);
+  EXPECT_EQ(reinterpret_cast<size_t>(a) % host::kMallocAlign, 0u);
+  memset(a, 1, size);
+  host::SetAllocator(std::make_shared<host::SystemAllocator>());
+  // Still released through the hugepage allocator it came from.
+  host::Free(a);
+  host::ReleaseCachedMemory();
+}
+
+TEST(memory, host_allocator_explicit_hugepage) {
+  // Falls back to transparent huge pages when none is reserved.
+  host::SetHugePages(host::HugePages::kExplicit);
+  const size_t size = 3 << 20;
+  void* a = host::Malloc(size);
+  ASSERT_TRUE(a);
+  EXPECT_EQ(reinterpret_cast<size_t>(a) % host::kMallocAlign, 0u);
+  memset(a, 1, size);
+  host::Free(a);
+  host::SetHugePages(host::HugePages::kNone);
+  host::ReleaseCachedMemory();
+}
+
+TEST(memory, host_allocator_explicit_hugepage_size) {
+  auto allocator =
+      std::make_shared<host::SystemAllocator>(host::HugePages::kExplicit);
+  host::SetAllocator(allocator);
+  // A request that rounds up to an 8MB class takes exactly 8MB, whether
+  // reserved huge pages back it or not.
+  const size_t size = host::RoundUpSize((8 << 20) - host::kMallocAlign);
+  ASSERT_EQ(size + host::kMallocAlign, static_cast<size_t>(8 << 20));
+  void* a = host::Malloc(size);
+  ASSERT_TRUE(a);
+  memset(a, 1, size);
+#ifdef __linux__
+  EXPECT_EQ(allocator->MappedBytes(), static_cast<size_t>(8 << 20));
+#endif
+  host::Free(a);
+  host::SetAllocator(std::make_shared<host::SystemAllocator>());
+  EXPECT_EQ(allocator->MappedBytes(), 0u);
+}
+
+class CountingAllocator : public host::SystemAllocator {
+ public:
+  void* Allocate(size_t size) override {
+    ++num_allocs;
+    return host::SystemAllocator::Allocate(size);
+  }
+  void Deallocate(void* ptr, size_t size) override {
+    ++num_frees;
+    host::SystemAllocator::Deallocate(ptr, size);
+  }
+  std::atomic<int> num_allocs{0};
+  std::atomic<int> num_frees{0};
+};
+
+TEST(memory, host_allocator_replaced_in_other_thread) {
+  auto first = std::make_shared<CountingAllocator>();
+  auto second = std::make_shared<CountingAllocator>();
+  host::SetAllocator(first);
+  void* live = host::Malloc(1000);
+  std::promise<void> cached, replaced;
+  std::thread worker([&] {
+    host::Free(host::Malloc(1000));
+    cached.set_value();
+    replaced.get_future().wait();
+    // The block cached before the switch is dropped, not handed out again.
+    host::Free(host::Malloc(1000));
+  });
+  cached.get_future().wait();
+  EXPECT_EQ(first->num_allocs.load(), 2);
+  host::SetAllocator(second);
+  replaced.set_value();
+  worker.join();
+  EXPECT_EQ(second->num_allocs.load(), 1);
+  // A block that outlives its allocator is not cached when freed.
+  const size_t cached_bytes = host::CachedBytes();
+  host::Free(live);
+  EXPECT_EQ(host::CachedBytes(), cached_bytes);
+  EXPECT_EQ(first->num_frees.load(), 2);
+  host::SetAllocator(std::make_shared<host::SystemAllocator>());
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,246 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The folded outputs may not grow the model by more than this, e.g. a
+// fill_constant of a large shape is cheaper to run than to store.
+const size_t kMaxFoldedGrowthBytes = 4 << 20;
+
+// The ops which must be run per request even if all their inputs are
+// persistable.
+const std::unordered_set<std::string>& UnfoldableOps() {
+  static const std::unordered_set<std::string> ops{"feed",
+                                                   "fetch",
+                                                   "while",
+                                                   "conditional_block",
+                                                   "subgraph",
+                                                   "io_copy",
+                                                   "io_copy_once",
+                                                   "layout",
+                                                   "layout_once",
+                                                   "calib",
+                                                   "calib_once",
+                                                   "uniform_random",
+                                                   "gaussian_random",
+                                                   "sampling_id",
+                                                   "write_to_array",
+                                                   "read_from_array"};
+  return ops;
+}
+
+// Only the kernels compiled for the current machine can be run, the others
+// are registered as fake kernels, e.g. all of them in the opt tool.
+bool IsHostExecutable(TargetType target) {
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  return false;
+#else
+  switch (target) {
+    case TARGET(kHost):
+      return true;
+#ifdef LITE_WITH_X86
+    case TARGET(kX86):
+      return true;
+#endif
+#ifdef LITE_WITH_ARM
+    case TARGET(kARM):
+      return true;
+#endif
+    default:
+      return false;
+  }
+#endif
+}
+
+}  // namespace
+
+bool ConstantFoldingPass::IsFoldable(
+    Node* op_node, const std::unordered_map<std::string, int>& writers) {
+  auto& stmt = op_node->AsStmt();
+  const auto* op_info = stmt.op_info();
+  const auto& op_type = op_info->Type();
+  if (UnfoldableOps().count(op_type) || op_type.find("fake_") == 0 ||
+      op_type.find("__xpu__") == 0 || op_info->HasAttr("sub_block")) {
+    return false;
+  }
+  if (op_node->outlinks.empty()) return false;
+  for (auto* in_node : op_node->inlinks) {
+    CHECK(in_node->IsArg());
+    if (!in_node->AsArg().is_weight) return false;
+  }
+  auto* scope = stmt.op()->scope();
+  for (auto* out_node : op_node->outlinks) {
+    CHECK(out_node->IsArg());
+    auto& arg = out_node->AsArg();
+    // A variable written more than once (e.g. in place) is not a constant.
+    auto it = writers.find(arg.name);
+    if (it == writers.end() || it->second != 1 || arg.is_weight) return false;
+    if (op_info->HasInput(arg.name)) return false;
+    auto* var = scope->FindVar(arg.name);
+    if (!var || !var->IsType<lite::Tensor>()) return false;
+  }
+  return true;
+}
+
+KernelBase* ConstantFoldingPass::PickHostKernel(Node* op_node) {
+  auto& stmt = op_node->AsStmt();
+  const auto* op_info = stmt.op_info();
+  auto* scope = stmt.op()->scope();
+  for (auto& kernel : stmt.kernels()) {
+    if (!IsHostExecutable(kernel->target()) ||
+        kernel->precision() == PRECISION(kInt8)) {
+      continue;
+    }
+    bool matched = true;
+    for (auto& input : op_info->inputs()) {
+      for (auto& name : input.second) {
+        auto* var = scope->FindVar(name);
+        if (!var || !var->IsType<lite::Tensor>()) {
+          matched = false;
+          break;
+        }
+        const auto* decl_type = kernel->GetInputDeclType(input.first);
+        auto precision = var->Get<lite::Tensor>().precision();
+        if (!decl_type->IsTensor() ||
+            (decl_type->precision() != PRECISION(kAny) &&
+             decl_type->precision() != precision)) {
+          matched = false;
+          break;
+        }
+      }
+      if (!matched) break;
+    }
+    if (matched) return kernel.get();
+  }
+  return nullptr;
+}
+
+// The bytes taken by the output `name` of `op_node` once the kernel runs,
+// known from its inferred shape and the precision the kernel declares.
+size_t ConstantFoldingPass::OutputBytes(Node* op_node,
+                                        KernelBase* kernel,
+                                        const std::string& name) {
+  auto& stmt = op_node->AsStmt();
+  const auto& tensor =
+      stmt.op()->scope()->FindVar(name)->Get<lite::Tensor>();
+  auto precision = kernel->precision();
+  std::string param;
+  if (stmt.op_info()->GetOutputArgname(name, &param)) {
+    const auto* type = ParamTypeRegistry::Global().RetrieveOutArgument(
+        kernel->place(), kernel->GenParamTypeKey(), param);
+    if (type && type->type->precision() != PRECISION(kAny)) {
+      precision = type->type->precision();
+    }
+  }
+  return tensor.dims().production() * lite_api::PrecisionTypeLength(precision);
+}
+
+bool ConstantFoldingPass::Evaluate(Node* op_node, KernelBase* kernel) {
+  auto& stmt = op_node->AsStmt();
+  auto* op = stmt.op().get();
+  auto* scope = op->scope();
+  if (!op->CheckShape() || !op->InferShape()) {
+    ReleaseOutputs(op_node);
+    return false;
+  }
+
+  // Rejected before the kernel runs, so a large result is never allocated.
+  size_t input_bytes = 0;
+  size_t output_bytes = 0;
+  for (auto* in_node : op_node->inlinks) {
+    input_bytes += scope->FindVar(in_node->AsArg().name)
+                       ->Get<lite::Tensor>()
+                       .memory_size();
+  }
+  for (auto* out_node : op_node->outlinks) {
+    output_bytes += OutputBytes(op_node, kernel, out_node->AsArg().name);
+  }
+  if (output_bytes > input_bytes + kMaxFoldedGrowthBytes) {
+    VLOG(4) << "skip folding " << op->op_info()->Type() << ", its outputs take "
+            << output_bytes << " bytes";
+    ReleaseOutputs(op_node);
+    return false;
+  }
+
+  kernel->SetContext(ContextScheduler::Global().NewContext(kernel->target()));
+  kernel->Launch();
+  return true;
+}
+
+void ConstantFoldingPass::ReleaseOutputs(Node* op_node) {
+  auto* scope = op_node->AsStmt().op()->scope();
+  for (auto* out_node : op_node->outlinks) {
+    scope->FindVar(out_node->AsArg().name)->GetMutable<lite::Tensor>()->clear();
+  }
+}
+
+void ConstantFoldingPass::FoldOp(SSAGraph* graph, Node* op_node) {
+  auto* scope = op_node->AsStmt().op()->scope();
+  std::unordered_set<const Node*> nodes_to_remove{op_node};
+  for (auto* out_node : op_node->outlinks) {
+    auto& arg = out_node->AsArg();
+    auto* tensor = scope->FindVar(arg.name)->GetMutable<lite::Tensor>();
+    tensor->set_persistable(true);
+    arg.is_weight = true;
+  }
+  // The weights used by the folded op only are not needed anymore.
+  for (auto* in_node : op_node->inlinks) {
+    if (in_node->outlinks.size() == 1) {
+      nodes_to_remove.insert(in_node);
+    }
+  }
+  VLOG(4) << "fold " << op_node->AsStmt().op_type();
+  GraphSafeRemoveNodes(graph, nodes_to_remove);
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::unordered_map<std::string, int> writers;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsStmt()) continue;
+    for (auto* out_node : node.outlinks) {
+      writers[out_node->AsArg().name]++;
+    }
+  }
+
+  int folded = 0;
+  for (auto* op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt() || !IsFoldable(op_node, writers)) continue;
+    auto* kernel = PickHostKernel(op_node);
+    if (!kernel || !Evaluate(op_node, kernel)) continue;
+    FoldOp(graph.get(), op_node);
+    ++folded;
+  }
+  VLOG(3) << "constant_folding_pass folded " << folded << " ops";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass, paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kAny)});
@@ -0,0 +1,59 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "lite/core/kernel.h"
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConstantFoldingPass evaluates the ops whose inputs are all persistable,
+ * such as fill_constant -> scale or transpose2 on a weight, once with a host
+ * kernel. Their outputs become persistable tensors and the ops are removed
+ * from the graph, so they are neither run per request nor kept in the saved
+ * model. As the folding is done in topological order, chains of such ops are
+ * folded entirely.
+ */
+class ConstantFoldingPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // Whether all the inputs of the op are weights and all its outputs are
+  // tensors that are written by this op only.
+  bool IsFoldable(Node* op_node,
+                  const std::unordered_map<std::string, int>& writers);
+  // Pick a kernel which runs on the host and accepts the input weights.
+  KernelBase* PickHostKernel(Node* op_node);
+  // Run the op once, returns false if the result should not be folded.
+  bool Evaluate(Node* op_node, KernelBase* kernel);
+  size_t OutputBytes(Node* op_node,
+                     KernelBase* kernel,
+                     const std::string& name);
+  // Free the outputs of a rejected fold, the op runs per request instead.
+  void ReleaseOutputs(Node* op_node);
+  void FoldOp(SSAGraph* graph, Node* op_node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,152 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block,
+            const std::string& name,
+            bool persistable = false) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(persistable);
+}
+
+void AddWeight(Scope* scope,
+               const std::string& name,
+               const std::vector<int64_t>& shape,
+               float value) {
+  auto* tensor = scope->Var(name)->GetMutable<lite::Tensor>();
+  tensor->Resize(shape);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = value;
+  }
+  tensor->set_persistable(true);
+}
+
+void AddScale(cpp::BlockDesc* block,
+              const std::string& x,
+              const std::string& out,
+              float scale) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("scale");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr<float>("scale", scale);
+  op->SetAttr<float>("bias", 0.f);
+  op->SetAttr<bool>("bias_after_scale", true);
+}
+
+void AddFetch(cpp::BlockDesc* block, const std::string& x, int col) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("fetch");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {"fetch"});
+  op->SetAttr<int>("col", col);
+}
+
+std::map<std::string, int> CountOps(SSAGraph* graph) {
+  std::map<std::string, int> counts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    counts[node->AsStmt().op_type()]++;
+  }
+  return counts;
+}
+
+}  // namespace
+
+TEST(ConstantFoldingPass, fold) {
+  // b = scale(w, 3) is folded.
+  // big = fill_constant_batch_size_like(w2, [-1, 1024]) takes 8MB, which is
+  // too large to be folded.
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* block = desc.GetBlock<cpp::BlockDesc>(0);
+  AddVar(block, "w", true);
+  AddVar(block, "w2", true);
+  AddVar(block, "b");
+  AddVar(block, "big");
+  AddScale(block, "w", "b", 3.f);
+  auto* fill = block->AddOp<cpp::OpDesc>();
+  fill->SetType("fill_constant_batch_size_like");
+  fill->SetInput("Input", {"w2"});
+  fill->SetOutput("Out", {"big"});
+  fill->SetAttr<int>("dtype", 5);
+  fill->SetAttr<std::vector<int>>("shape", {-1, 1024});
+  fill->SetAttr<float>("value", 1.f);
+  AddFetch(block, "b", 0);
+  AddFetch(block, "big", 1);
+
+  std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)},
+                            {TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  AddWeight(scope.get(), "w", {4, 4}, 2.f);
+  AddWeight(scope.get(), "w2", {2048, 4}, 0.f);
+  Program program(desc, scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  auto pass = PassManager::Global().LookUp("constant_folding_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto counts = CountOps(graph.get());
+  EXPECT_EQ(counts["fill_constant_batch_size_like"], 1);
+  EXPECT_EQ(counts["scale"], 0);
+  EXPECT_EQ(counts["fetch"], 2);
+
+  auto* exec_scope = program.exec_scope();
+  const auto& b = exec_scope->FindVar("b")->Get<lite::Tensor>();
+  EXPECT_TRUE(b.persistable());
+  ASSERT_EQ(b.numel(), 16);
+  for (int i = 0; i < b.numel(); i++) {
+    EXPECT_FLOAT_EQ(b.data<float>()[i], 6.f);
+  }
+  // The rejected fold is not run, so its output is not allocated.
+  const auto& big = exec_scope->FindVar("big")->Get<lite::Tensor>();
+  EXPECT_FALSE(big.persistable());
+  EXPECT_EQ(big.memory_size(), 0UL);
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg() && node.AsArg().name == "big") {
+      EXPECT_FALSE(node.AsArg().is_weight);
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fetch);
+USE_LITE_OP(fill_constant_batch_size_like);
+USE_LITE_OP(scale);
+USE_LITE_KERNEL(fill_constant_batch_size_like, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(fetch, kHost, kAny, kAny, def);
+USE_MIR_PASS(constant_folding_pass);
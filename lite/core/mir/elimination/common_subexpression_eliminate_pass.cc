@@ -0,0 +1,249 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The ops which must not be merged even if they have the same inputs and
+// attributes.
+const std::unordered_set<std::string>& NonMergeableOps() {
+  static const std::unordered_set<std::string> ops{"feed",
+                                                   "fetch",
+                                                   "while",
+                                                   "conditional_block",
+                                                   "subgraph",
+                                                   "uniform_random",
+                                                   "gaussian_random",
+                                                   "sampling_id",
+                                                   "write_to_array",
+                                                   "read_from_array",
+                                                   "increment"};
+  return ops;
+}
+
+// The framework attributes which do not change the computation.
+const std::unordered_set<std::string>& IgnoredAttrs() {
+  static const std::unordered_set<std::string> attrs{
+      "op_callstack", "op_namescope", "op_role", "op_role_var", "op_device"};
+  return attrs;
+}
+
+template <typename T>
+void AppendVector(const std::vector<T>& values, std::ostringstream* os) {
+  *os << "[";
+  for (auto& v : values) {
+    *os << v << ",";
+  }
+  *os << "]";
+}
+
+// Serialize the type, the inputs, the output parameters and the attributes
+// of an op, two ops with the same key compute the same outputs. Returns false
+// if the op has an attribute which can not be compared.
+bool OpKey(const OpInfo& op_info, std::string* key) {
+  using AttrType = OpDescAPI::AttrType;
+  std::ostringstream os;
+  os.precision(9);
+  os << op_info.Type() << ";";
+  for (auto& input : op_info.inputs()) {
+    os << input.first << ":";
+    AppendVector(input.second, &os);
+  }
+  os << ";";
+  for (auto& output : op_info.outputs()) {
+    os << output.first << ":" << output.second.size() << ",";
+  }
+  os << ";";
+  for (auto& attr : op_info.attr_types()) {
+    const auto& name = attr.first;
+    if (IgnoredAttrs().count(name)) continue;
+    os << name << "=";
+    switch (attr.second) {
+      case AttrType::INT:
+        os << op_info.GetAttr<int32_t>(name);
+        break;
+      case AttrType::FLOAT:
+        os << op_info.GetAttr<float>(name);
+        break;
+      case AttrType::STRING:
+        os << op_info.GetAttr<std::string>(name);
+        break;
+      case AttrType::BOOLEAN:
+        os << op_info.GetAttr<bool>(name);
+        break;
+      case AttrType::LONG:
+        os << op_info.GetAttr<int64_t>(name);
+        break;
+      case AttrType::INTS:
+        AppendVector(op_info.GetAttr<std::vector<int>>(name), &os);
+        break;
+      case AttrType::FLOATS:
+        AppendVector(op_info.GetAttr<std::vector<float>>(name), &os);
+        break;
+      case AttrType::STRINGS:
+        AppendVector(op_info.GetAttr<std::vector<std::string>>(name), &os);
+        break;
+      case AttrType::LONGS:
+        AppendVector(op_info.GetAttr<std::vector<int64_t>>(name), &os);
+        break;
+      default:
+        return false;
+    }
+    os << ";";
+  }
+  *key = os.str();
+  return true;
+}
+
+}  // namespace
+
+/*
+ * CommonSubexpressionEliminatePass merges the ops which have the same type,
+ * inputs and attributes, e.g. the same shape/cast/transpose2 of a var feeding
+ * several branches. The consumers of the duplicated op are redirected to the
+ * outputs of the first one and the duplicated op is removed. The ops are
+ * visited in topological order, so the chains of duplicated ops are merged
+ * entirely.
+ */
+class CommonSubexpressionEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override {
+    // The vars written more than once are not values, the ops reading or
+    // writing them are not merged.
+    std::unordered_map<std::string, int> writers;
+    for (auto& node : graph->mutable_nodes()) {
+      if (!node.IsStmt()) continue;
+      for (auto* out_node : node.outlinks) {
+        writers[out_node->AsArg().name]++;
+      }
+    }
+
+    std::unordered_map<std::string, Node*> exprs;
+    int merged = 0;
+    for (auto* op_node : graph->StmtTopologicalOrder()) {
+      if (!op_node->IsStmt()) continue;
+      const auto* op_info = op_node->AsStmt().op_info();
+      if (!IsMergeable(op_node, writers)) continue;
+      std::string key;
+      if (!OpKey(*op_info, &key)) continue;
+      auto it = exprs.find(key);
+      if (it == exprs.end()) {
+        exprs.emplace(key, op_node);
+        continue;
+      }
+      if (Merge(graph.get(), it->second, op_node)) {
+        ++merged;
+      }
+    }
+    VLOG(3) << "common_subexpression_eliminate_pass merged " << merged
+            << " ops";
+  }
+
+ private:
+  bool IsMergeable(Node* op_node,
+                   const std::unordered_map<std::string, int>& writers) {
+    const auto* op_info = op_node->AsStmt().op_info();
+    const auto& op_type = op_info->Type();
+    if (NonMergeableOps().count(op_type) || op_type.find("fake_") == 0 ||
+        op_info->HasAttr("sub_block") || op_node->outlinks.empty()) {
+      return false;
+    }
+    for (auto* in_node : op_node->inlinks) {
+      auto it = writers.find(in_node->AsArg().name);
+      if (it != writers.end() && it->second > 1) return false;
+    }
+    for (auto* out_node : op_node->outlinks) {
+      auto& arg = out_node->AsArg();
+      if (arg.is_weight || arg.is_persist || writers.at(arg.name) > 1) {
+        return false;
+      }
+      // The vars of the sub-blocks are only referred by name, and the names
+      // of the fetched vars are seen by the users, so they can not be
+      // renamed.
+      for (auto* consumer : out_node->outlinks) {
+        const auto* consumer_info = consumer->AsStmt().op_info();
+        if (consumer_info->Type() == "fetch" ||
+            consumer_info->HasAttr("sub_block")) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Redirect the consumers of `dup` to the outputs of `origin`, and remove
+  // `dup` with its outputs.
+  bool Merge(SSAGraph* graph, Node* origin, Node* dup) {
+    const auto* origin_info = origin->AsStmt().op_info();
+    const auto* dup_info = dup->AsStmt().op_info();
+    std::unordered_map<std::string, Node*> origin_outs;
+    for (auto* out_node : origin->outlinks) {
+      origin_outs[out_node->AsArg().name] = out_node;
+    }
+    // Pair the outputs by their parameters and positions.
+    std::vector<std::pair<Node*, Node*>> out_pairs;
+    for (auto* out_node : dup->outlinks) {
+      const auto& name = out_node->AsArg().name;
+      std::string param;
+      int index = -1;
+      CHECK(dup_info->GetOutputArgname(name, &param));
+      CHECK(dup_info->GetOutputIndex(name, &index));
+      const auto& origin_args = origin_info->Output(param);
+      CHECK_LT(index, static_cast<int>(origin_args.size()));
+      auto it = origin_outs.find(origin_args[index]);
+      if (it == origin_outs.end()) return false;
+      out_pairs.emplace_back(out_node, it->second);
+    }
+
+    std::unordered_set<const Node*> nodes_to_remove{dup};
+    for (auto& pair : out_pairs) {
+      auto* dup_out = pair.first;
+      auto* origin_out = pair.second;
+      const auto& from = dup_out->AsArg().name;
+      const auto& to = origin_out->AsArg().name;
+      for (auto* consumer : dup_out->outlinks) {
+        auto& stmt = consumer->AsStmt();
+        auto op_info = *stmt.op_info();
+        op_info.UpdateAllInputs(from, to);
+        stmt.ResetOp(op_info, graph->valid_places());
+        DirectedLink(origin_out, consumer);
+      }
+      nodes_to_remove.insert(dup_out);
+    }
+    VLOG(4) << "merge " << dup_info->Type() << " into the one producing "
+            << out_pairs.front().second->AsArg().name;
+    GraphSafeRemoveNodes(graph, nodes_to_remove);
+    return true;
+  }
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(common_subexpression_eliminate_pass,
+                  paddle::lite::mir::CommonSubexpressionEliminatePass)
+    .BindTargets({TARGET(kAny)});
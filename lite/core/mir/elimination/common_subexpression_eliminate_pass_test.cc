@@ -0,0 +1,186 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block, const std::string& name) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(false);
+}
+
+cpp::OpDesc* AddScale(cpp::BlockDesc* block,
+                      const std::string& x,
+                      const std::string& out,
+                      float scale) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("scale");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr<float>("scale", scale);
+  op->SetAttr<float>("bias", 0.f);
+  op->SetAttr<bool>("bias_after_scale", true);
+  return op;
+}
+
+void AddAdd(cpp::BlockDesc* block,
+            const std::string& x,
+            const std::string& y,
+            const std::string& out) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("elementwise_add");
+  op->SetInput("X", {x});
+  op->SetInput("Y", {y});
+  op->SetOutput("Out", {out});
+  op->SetAttr<int>("axis", -1);
+}
+
+void AddUniformRandom(cpp::BlockDesc* block, const std::string& out) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("uniform_random");
+  op->SetOutput("Out", {out});
+  op->SetAttr<std::vector<int64_t>>("shape", {2, 3});
+  op->SetAttr<float>("min", -1.f);
+  op->SetAttr<float>("max", 1.f);
+  op->SetAttr<int>("seed", 0);
+  op->SetAttr<int>("dtype", 5);
+}
+
+void AddConditionalBlock(cpp::BlockDesc* block,
+                         const std::string& x,
+                         const std::string& out) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("conditional_block");
+  op->SetInput("Cond", {"cond"});
+  op->SetInput("Input", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr<int32_t>("sub_block", 1);
+  op->SetAttr<bool>("is_scalar_condition", true);
+}
+
+void AddFetch(cpp::BlockDesc* block, const std::string& x, int col) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("fetch");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {"fetch"});
+  op->SetAttr<int>("col", col);
+}
+
+std::map<std::string, int> CountOps(SSAGraph* graph) {
+  std::map<std::string, int> counts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    counts[node->AsStmt().op_type()]++;
+  }
+  return counts;
+}
+
+}  // namespace
+
+TEST(CommonSubexpressionEliminatePass, merge) {
+  // a = scale(x, 2), b = scale(x, 2), c = scale(x, 3)
+  // d = a + a, e = a + b, which equals d once b is merged into a but is
+  // fetched, so its name is kept
+  // r0 = uniform_random(), r1 = uniform_random()
+  // o0 = conditional_block(x), o1 = conditional_block(x)
+  // g = scale(x, 2), consumed by a conditional_block
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  // The sub block of the conditional_block ops.
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* block = desc.GetBlock<cpp::BlockDesc>(0);
+  for (auto name : {"x", "cond", "a", "b", "c", "d", "e"}) {
+    AddVar(block, name);
+  }
+  for (auto name : {"r0", "r1", "o0", "o1", "g", "o2"}) {
+    AddVar(block, name);
+  }
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  AddScale(block, "x", "a", 2.f);
+  AddScale(block, "x", "b", 2.f);
+  AddScale(block, "x", "c", 3.f);
+  AddAdd(block, "a", "a", "d");
+  AddAdd(block, "a", "b", "e");
+  AddUniformRandom(block, "r0");
+  AddUniformRandom(block, "r1");
+  AddConditionalBlock(block, "x", "o0");
+  AddConditionalBlock(block, "x", "o1");
+  AddScale(block, "x", "g", 2.f);
+  AddConditionalBlock(block, "g", "o2");
+  int col = 0;
+  for (auto name : {"c", "d", "e", "r0", "r1", "o0", "o1", "o2"}) {
+    AddFetch(block, name, col++);
+  }
+
+  std::vector<Place> places{{TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  scope->Var("cond")->GetMutable<Tensor>();
+  Program program(desc, scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  auto pass = PassManager::Global().LookUp(
+      "common_subexpression_eliminate_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto counts = CountOps(graph.get());
+  // b is merged into a. e, which is fetched, the random ops, the ops with a
+  // sub block and g, whose consumer refers to it by name, are kept.
+  EXPECT_EQ(counts["scale"], 3);
+  EXPECT_EQ(counts["elementwise_add"], 2);
+  EXPECT_EQ(counts["uniform_random"], 2);
+  EXPECT_EQ(counts["conditional_block"], 3);
+  EXPECT_EQ(counts["fetch"], 8);
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    const auto* op_info = node->AsStmt().op_info();
+    if (op_info->Type() == "elementwise_add") {
+      EXPECT_EQ(op_info->Input("X").front(), "a");
+      EXPECT_EQ(op_info->Input("Y").front(), "a");
+    }
+    if (op_info->Type() == "fetch" && op_info->GetAttr<int>("col") == 2) {
+      // The fetch of e still reads e.
+      EXPECT_EQ(op_info->Input("X").front(), "e");
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(scale);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(uniform_random);
+USE_LITE_OP(conditional_block);
+USE_MIR_PASS(common_subexpression_eliminate_pass);
@@ -0,0 +1,128 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The ops which are always kept, their effects are not visible through the
+// vars of the main block, and feed ops define the input indices of the
+// predictor.
+const std::unordered_set<std::string>& SideEffectOps() {
+  static const std::unordered_set<std::string> ops{"feed",
+                                                   "fetch",
+                                                   "while",
+                                                   "conditional_block",
+                                                   "subgraph",
+                                                   "write_to_array",
+                                                   "increment",
+                                                   "assign",
+                                                   "sgd"};
+  return ops;
+}
+
+}  // namespace
+
+/*
+ * DeadCodeEliminatePass removes the ops whose outputs reach no fetch op. The
+ * liveness is propagated backward from the fetch ops and the side effect ops
+ * in reverse topological order, and the vars only used by the removed ops
+ * (including weights, which are then not saved) are removed as well.
+ */
+class DeadCodeEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override {
+    auto stmts = graph->StmtTopologicalOrder();
+    bool has_fetch = false;
+    for (auto* op_node : stmts) {
+      if (op_node->IsStmt() && op_node->AsStmt().op_type() == "fetch") {
+        has_fetch = true;
+        break;
+      }
+    }
+    // Without fetch ops the outputs of the graph are unknown.
+    if (!has_fetch) return;
+
+    std::unordered_set<std::string> live_vars;
+    std::unordered_set<const Node*> dead_nodes;
+    for (auto it = stmts.rbegin(); it != stmts.rend(); ++it) {
+      auto* op_node = *it;
+      if (!op_node->IsStmt()) continue;
+      if (IsLive(op_node, live_vars)) {
+        for (auto* in_node : op_node->inlinks) {
+          live_vars.insert(in_node->AsArg().name);
+        }
+        continue;
+      }
+      dead_nodes.insert(op_node);
+      for (auto* out_node : op_node->outlinks) {
+        dead_nodes.insert(out_node);
+      }
+    }
+    if (dead_nodes.empty()) return;
+
+    // The inputs which are used by dead ops only.
+    for (auto& node : graph->mutable_nodes()) {
+      if (!node.IsArg() || dead_nodes.count(&node) ||
+          live_vars.count(node.AsArg().name) || !node.inlinks.empty()) {
+        continue;
+      }
+      bool used = false;
+      for (auto* consumer : node.outlinks) {
+        if (!dead_nodes.count(consumer)) {
+          used = true;
+          break;
+        }
+      }
+      if (!used) dead_nodes.insert(&node);
+    }
+    VLOG(3) << "dead_code_eliminate_pass removes " << dead_nodes.size()
+            << " nodes";
+    GraphSafeRemoveNodes(graph.get(), dead_nodes);
+  }
+
+ private:
+  bool IsLive(Node* op_node, const std::unordered_set<std::string>& live_vars) {
+    const auto* op_info = op_node->AsStmt().op_info();
+    if (SideEffectOps().count(op_info->Type()) ||
+        op_info->HasAttr("sub_block") || op_node->outlinks.empty()) {
+      return true;
+    }
+    for (auto* out_node : op_node->outlinks) {
+      auto& arg = out_node->AsArg();
+      // Writing a persistable var is visible to the next run.
+      if (arg.is_weight || arg.is_persist || live_vars.count(arg.name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(dead_code_eliminate_pass,
+                  paddle::lite::mir::DeadCodeEliminatePass)
+    .BindTargets({TARGET(kAny)});
@@ -0,0 +1,143 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block,
+            const std::string& name,
+            bool persistable = false) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(persistable);
+}
+
+cpp::OpDesc* AddOp(cpp::BlockDesc* block,
+                   const std::string& type,
+                   const std::vector<std::string>& x,
+                   const std::string& out) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType(type);
+  op->SetInput("X", x);
+  op->SetOutput("Out", {out});
+  return op;
+}
+
+void AddScale(cpp::BlockDesc* block,
+              const std::string& x,
+              const std::string& out) {
+  auto* op = AddOp(block, "scale", {x}, out);
+  op->SetAttr<float>("scale", 2.f);
+  op->SetAttr<float>("bias", 0.f);
+  op->SetAttr<bool>("bias_after_scale", true);
+}
+
+}  // namespace
+
+TEST(DeadCodeEliminatePass, remove) {
+  // Live: a = scale(x) -> fetch
+  // Dead: b = scale(x), c = scale(b), d = x + w, where the weight w is used
+  // by d only
+  // Kept though unused: e = assign(x), p = scale(x) into a persistable var,
+  // o = conditional_block(x)
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  // The sub block of the conditional_block ops.
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* block = desc.GetBlock<cpp::BlockDesc>(0);
+  for (auto name : {"x", "cond", "a", "b", "c", "d", "e", "o"}) {
+    AddVar(block, name);
+  }
+  AddVar(block, "w", true);
+  AddVar(block, "p", true);
+  auto* feed = block->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  AddScale(block, "x", "a");
+  AddScale(block, "x", "b");
+  AddScale(block, "b", "c");
+  auto* add = AddOp(block, "elementwise_add", {"x"}, "d");
+  add->SetInput("Y", {"w"});
+  add->SetAttr<int>("axis", -1);
+  AddOp(block, "assign", {"x"}, "e");
+  AddScale(block, "x", "p");
+  auto* cond_op = AddOp(block, "conditional_block", {}, "o");
+  cond_op->SetInput("Cond", {"cond"});
+  cond_op->SetInput("Input", {"x"});
+  cond_op->SetAttr<int32_t>("sub_block", 1);
+  cond_op->SetAttr<bool>("is_scalar_condition", true);
+  auto* fetch = AddOp(block, "fetch", {"a"}, "fetch");
+  fetch->SetAttr<int>("col", 0);
+
+  std::vector<Place> places{{TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  scope->Var("w")->GetMutable<Tensor>();
+  scope->Var("p")->GetMutable<Tensor>();
+  scope->Var("cond")->GetMutable<Tensor>();
+  Program program(desc, scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  auto pass = PassManager::Global().LookUp("dead_code_eliminate_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  std::map<std::string, int> ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    ops[node->AsStmt().op_type()]++;
+  }
+  EXPECT_EQ(ops["feed"], 1);
+  EXPECT_EQ(ops["fetch"], 1);
+  EXPECT_EQ(ops["scale"], 2);
+  EXPECT_EQ(ops["elementwise_add"], 0);
+  EXPECT_EQ(ops["assign"], 1);
+  EXPECT_EQ(ops["conditional_block"], 1);
+  std::map<std::string, int> args;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) args[node.AsArg().name]++;
+  }
+  for (auto name : {"b", "c", "d", "w"}) {
+    EXPECT_EQ(args.count(name), 0u) << name;
+  }
+  for (auto name : {"x", "a", "e", "p", "o"}) {
+    EXPECT_EQ(args.count(name), 1u) << name;
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(scale);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(assign);
+USE_LITE_OP(conditional_block);
+USE_MIR_PASS(dead_code_eliminate_pass);
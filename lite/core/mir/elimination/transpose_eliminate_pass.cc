@@ -0,0 +1,341 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// The unary ops which compute every element independently, so
+// op(transpose(x)) == transpose(op(x)) and a transpose can be moved across
+// them.
+const std::unordered_set<std::string>& LayoutAgnosticOps() {
+  static const std::unordered_set<std::string> ops{"relu",
+                                                   "relu6",
+                                                   "leaky_relu",
+                                                   "sigmoid",
+                                                   "tanh",
+                                                   "swish",
+                                                   "hard_swish",
+                                                   "hard_sigmoid",
+                                                   "gelu",
+                                                   "exp",
+                                                   "log",
+                                                   "abs",
+                                                   "sqrt",
+                                                   "rsqrt",
+                                                   "square",
+                                                   "scale",
+                                                   "cast"};
+  return ops;
+}
+
+bool IsTranspose(const Node* node) {
+  if (!node->IsStmt()) return false;
+  const auto& op_type = node->stmt()->op_type();
+  return op_type == "transpose" || op_type == "transpose2";
+}
+
+std::vector<int> TransposeAxis(const Node* node) {
+  return node->stmt()->op_info()->GetAttr<std::vector<int>>("axis");
+}
+
+// Out[i] = X[axis[i]], so transpose(transpose(x, first), second) equals
+// transpose(x, first[second[i]]).
+std::vector<int> ComposeAxis(const std::vector<int>& first,
+                             const std::vector<int>& second) {
+  std::vector<int> axis(second.size());
+  for (size_t i = 0; i < second.size(); i++) {
+    axis[i] = first[second[i]];
+  }
+  return axis;
+}
+
+bool IsIdentityAxis(const std::vector<int>& axis) {
+  for (size_t i = 0; i < axis.size(); i++) {
+    if (axis[i] != static_cast<int>(i)) return false;
+  }
+  return true;
+}
+
+// Whether the transpose only swaps the last two dims.
+bool IsLastTwoDimsSwapped(const std::vector<int>& axis) {
+  size_t rank = axis.size();
+  if (rank < 2) return false;
+  for (size_t i = 0; i + 2 < rank; i++) {
+    if (axis[i] != static_cast<int>(i)) return false;
+  }
+  return axis[rank - 2] == static_cast<int>(rank - 1) &&
+         axis[rank - 1] == static_cast<int>(rank - 2);
+}
+
+Node* FindOutput(Node* op_node, const std::string& param) {
+  const auto* op_info = op_node->stmt()->op_info();
+  if (!op_info->HasOutput(param) || op_info->Output(param).empty()) {
+    return nullptr;
+  }
+  auto name = op_info->Output(param).front();
+  for (auto* out_node : op_node->outlinks) {
+    if (out_node->AsArg().name == name) return out_node;
+  }
+  return nullptr;
+}
+
+Node* FindInput(Node* op_node, const std::string& param) {
+  const auto* op_info = op_node->stmt()->op_info();
+  if (!op_info->HasInput(param) || op_info->Input(param).empty()) {
+    return nullptr;
+  }
+  auto name = op_info->Input(param).front();
+  for (auto* in_node : op_node->inlinks) {
+    if (in_node->AsArg().name == name) return in_node;
+  }
+  return nullptr;
+}
+
+// Make `op_node` read `to` instead of `from`, `from` is removed by the
+// caller.
+void ReplaceInput(SSAGraph* graph, Node* op_node, Node* from, Node* to) {
+  auto& stmt = op_node->AsStmt();
+  auto op_info = *stmt.op_info();
+  op_info.UpdateAllInputs(from->AsArg().name, to->AsArg().name);
+  stmt.ResetOp(op_info, graph->valid_places());
+  DirectedLink(to, op_node);
+}
+
+void ResetAxis(SSAGraph* graph, Node* op_node, const std::vector<int>& axis) {
+  auto& stmt = op_node->AsStmt();
+  auto op_info = *stmt.op_info();
+  op_info.SetAttr("axis", axis);
+  stmt.ResetOp(op_info, graph->valid_places());
+}
+
+}  // namespace
+
+/*
+ * TransposeEliminatePass removes the transposes which cancel each other or
+ * can be absorbed by their consumers, e.g. the transpose2 pairs around the
+ * attention heads of the transformer models:
+ *  - transpose(x) -> [relu/scale/cast...] -> transpose is reduced to
+ *    x -> [relu/scale/cast...] if the two transposes are inverse to each
+ *    other, otherwise the two transposes are merged into the last one;
+ *  - a transpose which swaps the last two dims of the input of matmul is
+ *    folded into the transpose_X/transpose_Y attribute of matmul.
+ * Only the vars with a single writer and a single reader are rewritten.
+ */
+class TransposeEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override {
+    int removed = 0;
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      CountWriters(graph.get());
+      for (auto* op_node : graph->StmtTopologicalOrder()) {
+        if (!IsTranspose(op_node)) continue;
+        if (CancelTranspose(graph.get(), op_node, &removed)) {
+          changed = true;
+          break;
+        }
+      }
+    }
+    CountWriters(graph.get());
+    for (auto* op_node : graph->StmtTopologicalOrder()) {
+      if (!op_node->IsStmt() || op_node->stmt()->op_type() != "matmul") {
+        continue;
+      }
+      removed += FoldIntoMatmul(graph.get(), op_node, "X", "transpose_X");
+      removed += FoldIntoMatmul(graph.get(), op_node, "Y", "transpose_Y");
+    }
+    VLOG(3) << "transpose_eliminate_pass removed " << removed
+            << " transpose ops";
+  }
+
+ private:
+  void CountWriters(SSAGraph* graph) {
+    writers_.clear();
+    for (auto& node : graph->mutable_nodes()) {
+      if (!node.IsStmt()) continue;
+      for (auto* out_node : node.outlinks) {
+        writers_[out_node->AsArg().name]++;
+      }
+    }
+  }
+
+  // Whether the var is an intermediate result read by a single op only.
+  bool IsSingleUse(Node* var_node) {
+    auto& arg = var_node->AsArg();
+    if (arg.is_weight || arg.is_persist || var_node->outlinks.size() != 1 ||
+        writers_[arg.name] != 1) {
+      return false;
+    }
+    return !var_node->outlinks.front()->stmt()->op_info()->HasAttr(
+        "sub_block");
+  }
+
+  // The nodes which die with a transpose op: the op itself, its output if
+  // `out` is true, and its XShape output.
+  void CollectTranspose(Node* op_node,
+                        bool out,
+                        std::unordered_set<const Node*>* nodes) {
+    nodes->insert(op_node);
+    if (out) nodes->insert(FindOutput(op_node, "Out"));
+    auto* xshape = FindOutput(op_node, "XShape");
+    if (xshape) nodes->insert(xshape);
+  }
+
+  bool IsRemovableTranspose(Node* op_node) {
+    if (op_node->inlinks.size() != 1) return false;
+    auto* xshape = FindOutput(op_node, "XShape");
+    return !xshape || xshape->outlinks.empty();
+  }
+
+  // Walk backward from the transpose `last` across the layout agnostic ops
+  // to the transpose producing the chain, then cancel or merge the two.
+  bool CancelTranspose(SSAGraph* graph, Node* last, int* removed) {
+    if (!IsRemovableTranspose(last)) return false;
+    std::vector<Node*> chain;  // The layout agnostic ops, in reverse order.
+    Node* var_node = FindInput(last, "X");
+    Node* first = nullptr;
+    while (var_node && IsSingleUse(var_node) && var_node->inlinks.size() == 1) {
+      auto* producer = var_node->inlinks.front();
+      if (IsTranspose(producer)) {
+        first = producer;
+        break;
+      }
+      if (!LayoutAgnosticOps().count(producer->stmt()->op_type()) ||
+          producer->inlinks.size() != 1 || producer->outlinks.size() != 1) {
+        return false;
+      }
+      chain.push_back(producer);
+      var_node = producer->inlinks.front();
+    }
+    if (!first || !IsRemovableTranspose(first)) return false;
+
+    auto* first_in = FindInput(first, "X");
+    auto* first_out = FindOutput(first, "Out");
+    auto* last_out = FindOutput(last, "Out");
+    if (!first_in || !first_out || !last_out) return false;
+    auto axis = ComposeAxis(TransposeAxis(first), TransposeAxis(last));
+    bool identity = IsIdentityAxis(axis);
+    if (identity && chain.empty()) {
+      // The consumers of `last_out` will read `first_in` directly, the fetch
+      // vars keep their names.
+      if (last_out->outlinks.empty() || last_out->AsArg().is_persist ||
+          writers_[last_out->AsArg().name] != 1) {
+        return false;
+      }
+      for (auto* consumer : last_out->outlinks) {
+        const auto* op_info = consumer->stmt()->op_info();
+        if (op_info->Type() == "fetch" || op_info->HasAttr("sub_block")) {
+          return false;
+        }
+      }
+    }
+
+    std::unordered_set<const Node*> nodes_to_remove;
+    CollectTranspose(first, true, &nodes_to_remove);
+    Node* head = chain.empty() ? last : chain.back();
+    if (identity) {
+      // The output of `last` is kept if the chain writes it.
+      CollectTranspose(last, chain.empty(), &nodes_to_remove);
+      if (chain.empty()) {
+        std::vector<Node*> consumers(last_out->outlinks.begin(),
+                                     last_out->outlinks.end());
+        for (auto* consumer : consumers) {
+          ReplaceInput(graph, consumer, last_out, first_in);
+        }
+      } else {
+        // The last layout agnostic op writes the output of `last`.
+        auto* tail = chain.front();
+        auto* tail_out = tail->outlinks.front();
+        auto& stmt = tail->AsStmt();
+        auto op_info = *stmt.op_info();
+        op_info.UpdateAllOutputs(tail_out->AsArg().name,
+                                 last_out->AsArg().name);
+        stmt.ResetOp(op_info, graph->valid_places());
+        DirectedLink(tail, last_out);
+        nodes_to_remove.insert(tail_out);
+        ReplaceInput(graph, head, first_out, first_in);
+      }
+    } else {
+      ReplaceInput(graph, head, first_out, first_in);
+      ResetAxis(graph, last, axis);
+    }
+    VLOG(4) << (identity ? "cancel" : "merge") << " the transposes of "
+            << first_in->AsArg().name << " across " << chain.size()
+            << " ops";
+    GraphSafeRemoveNodes(graph, nodes_to_remove);
+    *removed += identity ? 2 : 1;
+    return true;
+  }
+
+  int FoldIntoMatmul(SSAGraph* graph,
+                     Node* matmul,
+                     const std::string& param,
+                     const std::string& attr) {
+    const auto* op_info = matmul->stmt()->op_info();
+    if (op_info->Input("X") == op_info->Input("Y")) return 0;
+    auto* var_node = FindInput(matmul, param);
+    if (!var_node || !IsSingleUse(var_node) || var_node->inlinks.size() != 1) {
+      return 0;
+    }
+    auto* transpose = var_node->inlinks.front();
+    if (!IsTranspose(transpose) || !IsRemovableTranspose(transpose) ||
+        !IsLastTwoDimsSwapped(TransposeAxis(transpose))) {
+      return 0;
+    }
+    auto* in_node = FindInput(transpose, "X");
+    if (!in_node) return 0;
+    bool transposed = op_info->GetAttr<bool>(attr);
+
+    auto& stmt = matmul->AsStmt();
+    auto new_info = *stmt.op_info();
+    new_info.UpdateAllInputs(var_node->AsArg().name, in_node->AsArg().name);
+    new_info.SetAttr(attr, !transposed);
+    stmt.ResetOp(new_info, graph->valid_places());
+    DirectedLink(in_node, matmul);
+
+    std::unordered_set<const Node*> nodes_to_remove;
+    CollectTranspose(transpose, true, &nodes_to_remove);
+    GraphSafeRemoveNodes(graph, nodes_to_remove);
+    VLOG(4) << "fold the transpose of " << in_node->AsArg().name
+            << " into matmul." << attr;
+    return 1;
+  }
+
+  std::unordered_map<std::string, int> writers_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(transpose_eliminate_pass,
+                  paddle::lite::mir::TransposeEliminatePass)
+    .BindTargets({TARGET(kAny)})
+    .ExcludeTargets({TARGET(kNPU),
+                     TARGET(kXPU),
+                     TARGET(kBM),
+                     TARGET(kRKNPU),
+                     TARGET(kMLU)});
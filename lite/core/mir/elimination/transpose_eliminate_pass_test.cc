@@ -0,0 +1,215 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block, const std::string& name) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(false);
+}
+
+void AddFeed(cpp::BlockDesc* block, const std::string& out, int col) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("feed");
+  op->SetInput("X", {"feed"});
+  op->SetOutput("Out", {out});
+  op->SetAttr<int>("col", col);
+}
+
+void AddTranspose(cpp::BlockDesc* block,
+                  const std::string& x,
+                  const std::string& out,
+                  const std::vector<int>& axis) {
+  AddVar(block, out);
+  AddVar(block, out + "_xshape");
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("transpose2");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetOutput("XShape", {out + "_xshape"});
+  op->SetAttr<std::vector<int>>("axis", axis);
+}
+
+void AddRelu(cpp::BlockDesc* block,
+             const std::string& x,
+             const std::string& out) {
+  AddVar(block, out);
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("relu");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+}
+
+void AddScale(cpp::BlockDesc* block,
+              const std::string& x,
+              const std::string& out) {
+  AddVar(block, out);
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("scale");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {out});
+  op->SetAttr<float>("scale", 2.f);
+  op->SetAttr<float>("bias", 0.f);
+  op->SetAttr<bool>("bias_after_scale", true);
+}
+
+void AddMatmul(cpp::BlockDesc* block,
+               const std::string& x,
+               const std::string& y,
+               const std::string& out) {
+  AddVar(block, out);
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("matmul");
+  op->SetInput("X", {x});
+  op->SetInput("Y", {y});
+  op->SetOutput("Out", {out});
+  op->SetAttr<bool>("transpose_X", false);
+  op->SetAttr<bool>("transpose_Y", false);
+  op->SetAttr<float>("alpha", 1.f);
+}
+
+void AddFetch(cpp::BlockDesc* block, const std::string& x, int col) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType("fetch");
+  op->SetInput("X", {x});
+  op->SetOutput("Out", {"fetch"});
+  op->SetAttr<int>("col", col);
+}
+
+// The op writing `name`, nullptr if there is none.
+const OpInfo* Writer(SSAGraph* graph, const std::string& name) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    for (auto* out_node : node->outlinks) {
+      if (out_node->AsArg().name == name) return node->AsStmt().op_info();
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(TransposeEliminatePass, eliminate) {
+  // c = relu(transpose(transpose(x))), the transposes cancel each other.
+  // f = transpose(relu(transpose(x))), cancelled across relu, which writes
+  // the fetched f.
+  // i = scale(transpose(transpose(x))), the transposes are merged.
+  // k = matmul(x, transpose(y)), the transpose is folded into matmul.
+  // m = transpose(transpose(x)), kept as m is fetched.
+  const std::vector<int> swap12{0, 2, 1, 3};
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* block = desc.GetBlock<cpp::BlockDesc>(0);
+  AddVar(block, "x");
+  AddVar(block, "y");
+  AddFeed(block, "x", 0);
+  AddFeed(block, "y", 1);
+  AddTranspose(block, "x", "a", swap12);
+  AddTranspose(block, "a", "b", swap12);
+  AddRelu(block, "b", "c");
+  AddTranspose(block, "x", "d", swap12);
+  AddRelu(block, "d", "e");
+  AddTranspose(block, "e", "f", swap12);
+  AddTranspose(block, "x", "g", swap12);
+  AddTranspose(block, "g", "h", {1, 0, 2, 3});
+  AddScale(block, "h", "i");
+  AddTranspose(block, "y", "j", {0, 1, 3, 2});
+  AddMatmul(block, "x", "j", "k");
+  AddTranspose(block, "x", "l", swap12);
+  AddTranspose(block, "l", "m", swap12);
+  int col = 0;
+  for (auto name : {"c", "f", "i", "k", "m"}) {
+    AddFetch(block, name, col++);
+  }
+
+  std::vector<Place> places{{TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  Program program(desc, scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  auto pass = PassManager::Global().LookUp("transpose_eliminate_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  std::map<std::string, int> counts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    counts[node->AsStmt().op_type()]++;
+  }
+  // The merged transpose and the two of m are left.
+  EXPECT_EQ(counts["transpose2"], 3);
+  EXPECT_EQ(counts["relu"], 2);
+  EXPECT_EQ(counts["scale"], 1);
+  EXPECT_EQ(counts["matmul"], 1);
+  EXPECT_EQ(counts["fetch"], 5);
+
+  auto* c_writer = Writer(graph.get(), "c");
+  ASSERT_TRUE(c_writer);
+  EXPECT_EQ(c_writer->Input("X").front(), "x");
+
+  auto* f_writer = Writer(graph.get(), "f");
+  ASSERT_TRUE(f_writer);
+  EXPECT_EQ(f_writer->Type(), "relu");
+  EXPECT_EQ(f_writer->Input("X").front(), "x");
+
+  auto* h_writer = Writer(graph.get(), "h");
+  ASSERT_TRUE(h_writer);
+  EXPECT_EQ(h_writer->Type(), "transpose2");
+  EXPECT_EQ(h_writer->Input("X").front(), "x");
+  EXPECT_EQ(h_writer->GetAttr<std::vector<int>>("axis"),
+            std::vector<int>({2, 0, 1, 3}));
+
+  auto* k_writer = Writer(graph.get(), "k");
+  ASSERT_TRUE(k_writer);
+  EXPECT_EQ(k_writer->Input("Y").front(), "y");
+  EXPECT_TRUE(k_writer->GetAttr<bool>("transpose_Y"));
+  EXPECT_FALSE(k_writer->GetAttr<bool>("transpose_X"));
+
+  auto* m_writer = Writer(graph.get(), "m");
+  ASSERT_TRUE(m_writer);
+  EXPECT_EQ(m_writer->Type(), "transpose2");
+  EXPECT_EQ(m_writer->Input("X").front(), "l");
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    const auto* op_info = node->AsStmt().op_info();
+    if (op_info->Type() == "fetch" && op_info->GetAttr<int>("col") == 4) {
+      EXPECT_EQ(op_info->Input("X").front(), "m");
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(transpose2);
+USE_LITE_OP(relu);
+USE_LITE_OP(scale);
+USE_LITE_OP(matmul);
+USE_MIR_PASS(transpose_eliminate_pass);
@@ -0,0 +1,169 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+void AddVar(cpp::BlockDesc* block, const std::string& name, bool persistable) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  var->SetPersistable(persistable);
+}
+
+}  // namespace
+
+// feed(x), feed(y) -> elementwise_add -> layer_norm -> fetch, optimized by
+// the default passes and run.
+TEST(ElementwiseAddLayerNormFusePass, optimize_and_run) {
+  const int rows = 3;
+  const int width = 8;
+  const float epsilon = 1e-5f;
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "y", "sum", "out", "mean", "variance"}) {
+    AddVar(block, name, false);
+  }
+  AddVar(block, "scale", true);
+  AddVar(block, "bias", true);
+  for (int col = 0; col < 2; ++col) {
+    auto* feed = block->AddOp<cpp::OpDesc>();
+    feed->SetType("feed");
+    feed->SetInput("X", {"feed"});
+    feed->SetOutput("Out", {col ? "y" : "x"});
+    feed->SetAttr<int>("col", col);
+  }
+  auto* add = block->AddOp<cpp::OpDesc>();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"x"});
+  add->SetInput("Y", {"y"});
+  add->SetOutput("Out", {"sum"});
+  add->SetAttr<int>("axis", -1);
+  auto* layer_norm = block->AddOp<cpp::OpDesc>();
+  layer_norm->SetType("layer_norm");
+  layer_norm->SetInput("X", {"sum"});
+  layer_norm->SetInput("Scale", {"scale"});
+  layer_norm->SetInput("Bias", {"bias"});
+  layer_norm->SetOutput("Y", {"out"});
+  layer_norm->SetOutput("Mean", {"mean"});
+  layer_norm->SetOutput("Variance", {"variance"});
+  layer_norm->SetAttr<int>("begin_norm_axis", 1);
+  layer_norm->SetAttr<float>("epsilon", epsilon);
+  auto* fetch = block->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+
+  auto scope = std::make_shared<Scope>();
+  std::vector<float> scale(width), bias(width);
+  for (int i = 0; i < width; ++i) {
+    scale[i] = 0.5f + 0.1f * i;
+    bias[i] = 0.2f * i - 0.3f;
+  }
+  for (auto name : {"scale", "bias"}) {
+    auto* tensor = scope->Var(name)->GetMutable<Tensor>();
+    tensor->Resize(std::vector<int64_t>({width}));
+    auto& src = std::string(name) == "scale" ? scale : bias;
+    std::copy(src.begin(), src.end(), tensor->mutable_data<float>());
+    tensor->set_persistable(true);
+  }
+
+  std::vector<Place> places{Place{TARGET(kX86), PRECISION(kFloat)},
+                            Place{TARGET(kHost), PRECISION(kFloat)}};
+  Program program(desc, scope, places);
+  core::KernelPickFactor factor;
+  factor.ConsiderTarget();
+  factor.ConsiderPrecision();
+  factor.ConsiderDataLayout();
+  Optimizer optimizer;
+  optimizer.Run(std::move(program), places, factor);
+
+  int num_add = 0;
+  int num_fused = 0;
+  for (auto* node : optimizer.mutable_ssa_graph()->StmtTopologicalOrder()) {
+    const auto* op_info = node->AsStmt().op_info();
+    num_add += op_info->Type() == "elementwise_add";
+    num_fused +=
+        op_info->Type() == "layer_norm" && op_info->HasInput("Residual");
+  }
+  EXPECT_EQ(num_add, 0);
+  EXPECT_EQ(num_fused, 1);
+
+  auto runtime_program = optimizer.GenRuntimeProgram();
+  std::vector<float> x(rows * width), y(rows * width);
+  for (int i = 0; i < rows * width; ++i) {
+    x[i] = std::sin(0.3f * i);
+    y[i] = std::cos(0.7f * i);
+  }
+  // The feed and fetch ops are skipped at runtime, the tensors are used
+  // directly.
+  auto* exec_scope = runtime_program->exec_scope();
+  for (auto name : {"x", "y"}) {
+    auto& src = std::string(name) == "y" ? y : x;
+    auto* tensor = exec_scope->FindVar(name)->GetMutable<Tensor>();
+    tensor->Resize(std::vector<int64_t>({rows, width}));
+    std::copy(src.begin(), src.end(), tensor->mutable_data<float>());
+  }
+  runtime_program->Run();
+
+  const float* out =
+      exec_scope->FindVar("out")->GetMutable<Tensor>()->data<float>();
+  for (int r = 0; r < rows; ++r) {
+    float mean = 0.f;
+    for (int i = 0; i < width; ++i) {
+      mean += x[r * width + i] + y[r * width + i];
+    }
+    mean /= width;
+    float variance = 0.f;
+    for (int i = 0; i < width; ++i) {
+      float d = x[r * width + i] + y[r * width + i] - mean;
+      variance += d * d;
+    }
+    variance /= width;
+    for (int i = 0; i < width; ++i) {
+      float sum = x[r * width + i] + y[r * width + i];
+      float ref =
+          (sum - mean) / std::sqrt(variance + epsilon) * scale[i] + bias[i];
+      EXPECT_NEAR(out[r * width + i], ref, 1e-4) << r << ", " << i;
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(layer_norm);
+USE_LITE_KERNEL(feed, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(fetch, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(layer_norm, kX86, kFloat, kNCHW, def);
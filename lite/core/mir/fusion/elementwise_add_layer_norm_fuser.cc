@@ -0,0 +1,103 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_add_layer_norm_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+void ElementwiseAddLayerNormFuser::BuildPattern() {
+  // create input nodes.
+  auto* x = VarNode("x")->assert_is_op_input("elementwise_add", "X")->AsInput();
+  auto* y = VarNode("y")->assert_is_op_input("elementwise_add", "Y")->AsInput();
+  auto* scale =
+      VarNode("scale")->assert_is_op_input("layer_norm", "Scale")->AsInput();
+  auto* bias =
+      VarNode("bias")->assert_is_op_input("layer_norm", "Bias")->AsInput();
+
+  // create op nodes
+  auto* add = OpNode("add", "elementwise_add")
+                  ->assert_is_op("elementwise_add")
+                  ->assert_op_attr<int>("axis", -1)
+                  ->AsIntermediate();
+  auto* layer_norm = OpNode("layer_norm", "layer_norm")
+                         ->assert_is_op("layer_norm")
+                         ->AsIntermediate();
+
+  // create intermediate nodes
+  auto* add_out = VarNode("add_out")
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_is_op_input("layer_norm", "X")
+                      ->AsIntermediate();
+
+  // create output nodes
+  auto* out =
+      VarNode("output")->assert_is_op_output("layer_norm", "Y")->AsOutput();
+  auto* mean =
+      VarNode("mean")->assert_is_op_output("layer_norm", "Mean")->AsOutput();
+  auto* variance = VarNode("variance")
+                       ->assert_is_op_output("layer_norm", "Variance")
+                       ->AsOutput();
+
+  // create topology.
+  std::vector<PMNode*> add_inputs{x, y};
+  std::vector<PMNode*> layer_norm_inputs{add_out, scale, bias};
+  std::vector<PMNode*> layer_norm_outputs{out, mean, variance};
+  add_inputs >> *add >> *add_out;
+  layer_norm_inputs >> *layer_norm >> layer_norm_outputs;
+}
+
+void ElementwiseAddLayerNormFuser::InsertNewNode(SSAGraph* graph,
+                                                 const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto op = LiteOpRegistry::Global().Create("layer_norm");
+  auto old_op = matched.at("layer_norm")->stmt()->op();
+  auto* scope = old_op->scope();
+  // Only the X86 kernel takes the residual.
+  std::vector<Place> valid_places;
+  for (auto& place : old_op->valid_places()) {
+    if (place.target == TARGET(kX86)) {
+      valid_places.push_back(place);
+    }
+  }
+  CHECK(!valid_places.empty());
+  op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("x"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("y"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("scale"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("bias"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("output"));
+  IR_NODE_LINK_TO(new_op_node, matched.at("mean"));
+  IR_NODE_LINK_TO(new_op_node, matched.at("variance"));
+}
+
+cpp::OpDesc ElementwiseAddLayerNormFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  cpp::OpDesc op_desc = *matched.at("layer_norm")->stmt()->op_info();
+  op_desc.SetInput("X", {matched.at("x")->arg()->name});
+  op_desc.SetInput("Residual", {matched.at("y")->arg()->name});
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,97 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/embedding_seq_pool_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// """
+// merge {lookup_table, sequence_pool(SUM)} => fused_embedding_seq_pool
+//     W   Ids                      W   Ids
+//      |   |                        |   |
+//      v   v                        v   v
+//   lookup_table           =>  fused_embedding_seq_pool
+//        |                             |
+//        v                             v
+//  sequence_pool(SUM)                 Out
+//        |
+//        v
+//       Out
+// """
+void EmbeddingSeqPoolFuser::BuildPattern() {
+  // create nodes.
+  auto* w = VarNode("w")->assert_is_op_input("lookup_table", "W")->AsInput();
+  auto* ids =
+      VarNode("ids")->assert_is_op_input("lookup_table", "Ids")->AsInput();
+  auto* lookup_table =
+      OpNode("lookup_table", "lookup_table")->AsIntermediate();
+  auto* emb = VarNode("emb")
+                  ->assert_is_op_output("lookup_table", "Out")
+                  ->assert_is_op_input("sequence_pool", "X")
+                  ->AsIntermediate();
+  auto* sequence_pool =
+      OpNode("sequence_pool", "sequence_pool")
+          ->assert_op_attr<std::string>("pooltype", "SUM")
+          ->AsIntermediate();
+  auto* out = VarNode("out")->assert_is_op_output("sequence_pool", "Out");
+
+  // create topology.
+  *w >> *lookup_table;
+  *ids >> *lookup_table >> *emb >> *sequence_pool >> *out;
+  if (with_max_index_) {
+    auto* max_index = VarNode("max_index")
+                          ->assert_is_op_output("sequence_pool", "MaxIndex")
+                          ->AsIntermediate();
+    *sequence_pool >> *max_index;
+  }
+}
+
+void EmbeddingSeqPoolFuser::InsertNewNode(SSAGraph* graph,
+                                          const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fused_op = LiteOpRegistry::Global().Create("fused_embedding_seq_pool");
+  auto lookup_table = matched.at("lookup_table")->stmt()->op();
+  auto* scope = lookup_table->scope();
+  auto& valid_places = lookup_table->valid_places();
+  fused_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fused_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("w"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc EmbeddingSeqPoolFuser::GenOpDesc(const key2nodes_t& matched) {
+  auto* lookup_table_info = matched.at("lookup_table")->stmt()->op_info();
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_embedding_seq_pool");
+  op_desc.SetInput("W", {matched.at("w")->arg()->name});
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr<int64_t>(
+      "padding_idx", lookup_table_info->GetAttr<int64_t>("padding_idx"));
+  op_desc.SetAttr<std::string>("combiner", "sum");
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
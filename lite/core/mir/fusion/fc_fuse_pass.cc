@@ -24,16 +24,21 @@ namespace mir {
 
 void FcFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
 #ifdef LITE_WITH_X86
-#ifdef LITE_WITH_MLU
-  fusion::FcFuser fuser(false);
-  fuser(graph.get());
-#else
-  fusion::FcFuser fuser(true);
+#ifndef LITE_WITH_MLU
+  fusion::FcFuser fuser("relu");
   fuser(graph.get());
+  // Only the X86 fc kernel takes gelu, the fused fc is bound to X86.
+  for (auto& place : graph->valid_places()) {
+    if (place.target == TARGET(kX86)) {
+      fusion::FcFuser gelu_fuser("gelu");
+      gelu_fuser(graph.get());
+      break;
+    }
+  }
 #endif
 #endif
 
-  fusion::FcFuser fuser2(false);
+  fusion::FcFuser fuser2;
   fuser2(graph.get());
 }
 
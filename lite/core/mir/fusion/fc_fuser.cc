@@ -41,14 +41,14 @@ void FcFuser::BuildPattern() {
   mul->AsIntermediate();
   add->AsIntermediate();
 
-  if (with_relu_) {
+  if (!act_type_.empty()) {
     auto* add_out = VarNode("add_out");
-    auto* relu = OpNode("relu", "relu");
-    std::vector<PMNode*> relu_inputs{add_out};
+    auto* act = OpNode("act", act_type_);
+    std::vector<PMNode*> act_inputs{add_out};
     add_inputs >> *add >> *add_out;
-    relu_inputs >> *relu >> *Out;
+    act_inputs >> *act >> *Out;
     add_out->AsIntermediate();
-    relu->AsIntermediate();
+    act->AsIntermediate();
   } else {
     add_inputs >> *add >> *Out;
   }
@@ -59,7 +59,18 @@ void FcFuser::InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) {
   auto fc_op = LiteOpRegistry::Global().Create("fc");
   auto mul = matched.at("mul")->stmt()->op();
   auto* scope = mul->scope();
-  auto& valid_places = mul->valid_places();
+  auto valid_places = mul->valid_places();
+  if (act_type_ == "gelu") {
+    // Only the X86 kernel takes gelu.
+    std::vector<Place> x86_places;
+    for (auto& place : graph->valid_places()) {
+      if (place.target == TARGET(kX86)) {
+        x86_places.push_back(place);
+      }
+    }
+    valid_places = x86_places;
+  }
+  CHECK(!valid_places.empty());
   fc_op->Attach(op_desc, scope);
 
   auto* new_op_node = graph->GraphCreateInstructNode(fc_op, valid_places);
@@ -82,8 +93,8 @@ cpp::OpDesc FcFuser::GenOpDesc(const key2nodes_t& matched) {
   op_desc.SetAttr(
       "in_num_col_dims",
       matched.at("mul")->stmt()->op_info()->GetAttr<int>("x_num_col_dims"));
-  if (with_relu_) {
-    op_desc.SetAttr("activation_type", std::string{"relu"});
+  if (!act_type_.empty()) {
+    op_desc.SetAttr("activation_type", act_type_);
   }
   return op_desc;
 }
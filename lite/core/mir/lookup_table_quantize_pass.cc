@@ -0,0 +1,181 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/lookup_table_quantize_pass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+// Round a float32 to the nearest float16, ties to even.
+uint16_t Float32ToFloat16(float value) {
+  uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t mantissa = x & 0x7fffff;
+  int32_t raw_exponent = (x >> 23) & 0xff;
+  int32_t exponent = raw_exponent - 127 + 15;
+  if (raw_exponent == 0xff) {  // inf or nan
+    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+  }
+  if (exponent >= 31) {  // overflow
+    return sign | 0x7c00;
+  }
+  if (exponent <= 0) {  // subnormal or zero
+    if (exponent < -10) return sign;
+    mantissa |= 0x800000;
+    int shift = 14 - exponent;
+    uint32_t half = mantissa >> shift;
+    uint32_t rest = mantissa & ((1u << shift) - 1);
+    uint32_t middle = 1u << (shift - 1);
+    if (rest > middle || (rest == middle && (half & 1))) ++half;
+    return sign | half;
+  }
+  uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+  uint32_t rest = mantissa & 0x1fff;
+  // The carry of the rounding may go into the exponent, which is still the
+  // correct result.
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ++half;
+  return half;
+}
+
+}  // namespace
+
+bool LookupTableQuantizePass::QuantizeTable(const std::string& quant_type,
+                                            Tensor* table) {
+  if (table->precision() != PRECISION(kFloat) || table->dims().size() != 2) {
+    return false;
+  }
+  int64_t rows = table->dims()[0];
+  int64_t width = table->dims()[1];
+  const float* data = table->data<float>();
+  Tensor quantized;
+  if (quant_type == "int8") {
+    // Same layout as the tables of lookup_table_dequant in the models
+    // quantized offline, the width should be a multiple of 4.
+    if (width % 4 != 0) return false;
+    int64_t quant_width = 2 + width / 4;
+    quantized.Resize({rows, quant_width});
+    float* out = quantized.mutable_data<float>();
+    for (int64_t i = 0; i < rows; ++i) {
+      const float* row = data + i * width;
+      float* out_row = out + i * quant_width;
+      auto minmax = std::minmax_element(row, row + width);
+      float min = *minmax.first;
+      float max = *minmax.second;
+      float scale = (max - min) / 256.f;
+      out_row[0] = min;
+      out_row[1] = max;
+      uint8_t* codes = reinterpret_cast<uint8_t*>(out_row + 2);
+      for (int64_t j = 0; j < width; ++j) {
+        float code = scale > 0.f ? std::round((row[j] - min) / scale) : 0.f;
+        codes[j] = static_cast<uint8_t>(std::min(std::max(code, 0.f), 255.f));
+      }
+    }
+  } else if (quant_type == "fp16") {
+    if (width % 2 != 0) return false;
+    int64_t quant_width = width / 2;
+    quantized.Resize({rows, quant_width});
+    uint16_t* out =
+        reinterpret_cast<uint16_t*>(quantized.mutable_data<float>());
+    for (int64_t i = 0; i < rows * width; ++i) {
+      out[i] = Float32ToFloat16(data[i]);
+    }
+  } else {
+    LOG(FATAL) << "Unsupported embedding quant type: " << quant_type;
+  }
+  table->CopyDataFrom(quantized);
+  return true;
+}
+
+void LookupTableQuantizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  bool has_x86 = false;
+  for (auto& place : graph->valid_places()) {
+    has_x86 |= place.target == TARGET(kX86);
+  }
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || node->AsStmt().op_type() != "lookup_table") {
+      continue;
+    }
+    auto* op_info = node->AsStmt().mutable_op_info();
+    if (!op_info->HasAttr("embedding_quant_type")) continue;
+    auto quant_type = op_info->GetAttr<std::string>("embedding_quant_type");
+    // The mark is not a real attribute of lookup_table, drop it so it is
+    // not saved with the ops kept in float32.
+    op_info->DeleteAttr("embedding_quant_type");
+    if (quant_type.empty()) continue;
+    if (quant_type == "fp16" && !has_x86) {
+      LOG(WARNING) << "The fp16 embedding tables are only supported on X86";
+      continue;
+    }
+
+    auto w_name = op_info->Input("W").front();
+    auto ids_name = op_info->Input("Ids").front();
+    Node* w_node = nullptr;
+    Node* ids_node = nullptr;
+    for (auto* in_node : node->inlinks) {
+      if (in_node->AsArg().name == w_name) w_node = in_node;
+      if (in_node->AsArg().name == ids_name) ids_node = in_node;
+    }
+    CHECK(w_node && ids_node);
+    if (!w_node->AsArg().is_weight || w_node->outlinks.size() != 1) {
+      VLOG(3) << "Keep the table " << w_name << " in float32";
+      continue;
+    }
+    auto* scope = node->AsStmt().op()->scope();
+    auto* table = scope->FindVar(w_name)->GetMutable<Tensor>();
+    if (!QuantizeTable(quant_type, table)) {
+      VLOG(3) << "Can not convert the table " << w_name << " to " << quant_type;
+      continue;
+    }
+
+    cpp::OpDesc op_desc;
+    op_desc.SetType("lookup_table_dequant");
+    op_desc.SetInput("W", {w_name});
+    op_desc.SetInput("Ids", {ids_name});
+    op_desc.SetOutput("Out", op_info->Output("Out"));
+    op_desc.SetAttr<int64_t>("padding_idx",
+                             op_info->GetAttr<int64_t>("padding_idx"));
+    op_desc.SetAttr<int>("quant_bits", quant_type == "fp16" ? 16 : 8);
+    auto dequant_op = LiteOpRegistry::Global().Create("lookup_table_dequant");
+    dequant_op->Attach(op_desc, scope);
+    auto* new_node =
+        graph->GraphCreateInstructNode(dequant_op, graph->valid_places());
+    std::vector<Node*> out_nodes(node->outlinks.begin(), node->outlinks.end());
+    GraphSafeRemoveNodes(graph.get(), {node});
+    DirectedLink(w_node, new_node);
+    DirectedLink(ids_node, new_node);
+    for (auto* out_node : out_nodes) {
+      DirectedLink(new_node, out_node);
+    }
+    VLOG(3) << "Convert the table " << w_name << " to " << quant_type;
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lookup_table_quantize_pass,
+                  paddle::lite::mir::LookupTableQuantizePass)
+    .BindTargets({TARGET(kX86), TARGET(kARM)})
+    .BindKernel("lookup_table_dequant");
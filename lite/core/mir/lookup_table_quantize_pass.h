@@ -0,0 +1,44 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * LookupTableQuantizePass converts the float32 table of the lookup_table ops
+ * marked with the "embedding_quant_type" attribute (see
+ * CxxConfig::set_embedding_quant_type) and replaces them with
+ * lookup_table_dequant, which dequantizes the rows while gathering them:
+ *  - int8: every row is stored as [min, max, uint8 x width];
+ *  - fp16: every row is stored as float16 x width.
+ * The tables shared with other ops are kept in float32.
+ */
+class LookupTableQuantizePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool QuantizeTable(const std::string& quant_type, Tensor* table);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -96,12 +96,18 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     }
     // The specified input and output variables of the Ops whose 'inplace' attr
     // is true will not be reused, such as reshape/reshape2's X and Out
-    // variables
+    // variables, see view_op_inplace_pass
     std::unordered_map<std::string,
                        std::pair<std::unordered_set<std::string>,
                                  std::unordered_set<std::string>>>
         inplace_op_nodes = {{"reshape", {{"X"}, {"Out"}}},
-                            {"reshape2", {{"X"}, {"Out"}}}};
+                            {"reshape2", {{"X"}, {"Out"}}},
+                            {"squeeze", {{"X"}, {"Out"}}},
+                            {"squeeze2", {{"X"}, {"Out"}}},
+                            {"unsqueeze", {{"X"}, {"Out"}}},
+                            {"unsqueeze2", {{"X"}, {"Out"}}},
+                            {"flatten", {{"X"}, {"Out"}}},
+                            {"flatten2", {{"X"}, {"Out"}}}};
     auto inplace_op_node = inplace_op_nodes.find(op_type);
     if (inplace_op_node != inplace_op_nodes.end()) {
       bool inplace = false;
@@ -0,0 +1,112 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/view_op_inplace_pass.h"
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const std::unordered_set<std::string>& ViewOpInplacePass::view_op_types() {
+  static const std::unordered_set<std::string> types{"reshape",
+                                                     "reshape2",
+                                                     "squeeze",
+                                                     "squeeze2",
+                                                     "unsqueeze",
+                                                     "unsqueeze2",
+                                                     "flatten",
+                                                     "flatten2"};
+  return types;
+}
+
+bool ViewOpInplacePass::IsInplaceCandidate(Node* op_node) {
+  auto& stmt = op_node->AsStmt();
+  auto* op_info = stmt.op_info();
+  if (!view_op_types().count(op_info->Type())) return false;
+  if (op_info->HasAttr("inplace") && op_info->GetAttr<bool>("inplace")) {
+    return false;
+  }
+  // Only the host kernels know how to share a buffer, the ones of the other
+  // targets (e.g. OpenCL images) keep copying.
+  auto target = stmt.picked_kernel().target();
+  if (target != TARGET(kHost) && target != TARGET(kX86) &&
+      target != TARGET(kARM)) {
+    return false;
+  }
+  if (!op_info->HasInput("X") || op_info->Input("X").size() != 1 ||
+      !op_info->HasOutput("Out") || op_info->Output("Out").size() != 1) {
+    return false;
+  }
+  const auto& x_name = op_info->Input("X").front();
+  const auto& out_name = op_info->Output("Out").front();
+  if (x_name == out_name) return false;
+
+  for (auto* in_node : op_node->inlinks) {
+    CHECK(in_node->IsArg());
+    auto& arg = in_node->AsArg();
+    if (arg.name != x_name) continue;
+    // The input must not be read by any other op, otherwise a later writer
+    // of 'Out' could be observed through 'X'.
+    if (arg.is_weight || arg.is_persist || in_node->outlinks.size() != 1) {
+      return false;
+    }
+    if (arg.type != nullptr && !arg.type->IsTensor()) return false;
+  }
+  for (auto* out_node : op_node->outlinks) {
+    CHECK(out_node->IsArg());
+    auto& arg = out_node->AsArg();
+    if (arg.name == out_name && (arg.is_weight || arg.is_persist)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ViewOpInplacePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  for (auto* op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt() || !IsInplaceCandidate(op_node)) continue;
+    auto& stmt = op_node->AsStmt();
+    auto* op_info = stmt.mutable_op_info();
+    op_info->SetAttr<bool>("inplace", true);
+    VLOG(4) << "mark " << op_info->Type() << " "
+            << op_info->Output("Out").front() << " as inplace";
+
+    // Re-attach the op so that its param picks up the new attribute, and
+    // keep the kernel picked before.
+    auto original_selected_kernel = std::move(stmt.kernels().front());
+    auto updated_op_info = *op_info;
+    stmt.ResetOp(updated_op_info, graph->valid_places());
+    stmt.kernels().clear();
+    stmt.kernels().emplace_back(std::move(original_selected_kernel));
+    for (auto& kernel : stmt.kernels()) {
+      stmt.op()->AttachKernel(kernel.get());
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(view_op_inplace_pass, paddle::lite::mir::ViewOpInplacePass)
+    .BindTargets({TARGET(kARM), TARGET(kX86)})
+    .ExcludeTargets({TARGET(kNPU),
+                     TARGET(kXPU),
+                     TARGET(kBM),
+                     TARGET(kRKNPU),
+                     TARGET(kMLU)});
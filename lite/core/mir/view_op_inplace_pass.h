@@ -0,0 +1,48 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ViewOpInplacePass marks the ops which only change the shape of their input
+ * (reshape, squeeze, unsqueeze, flatten and their '2' versions) as inplace,
+ * so that their kernels share the input buffer instead of copying it.
+ *
+ * An op is marked only if its input 'X' is a non-persistable tensor on a host
+ * target and is consumed by this op alone, so no other op can observe the
+ * aliasing. The aliased variables are excluded from memory_optimize_pass.
+ */
+class ViewOpInplacePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  static const std::unordered_set<std::string>& view_op_types();
+
+ private:
+  bool IsInplaceCandidate(Node* op_node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
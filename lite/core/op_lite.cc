@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/op_lite.h"
+#include <algorithm>
 #include <list>
 #include <set>
 #include <utility>
@@ -22,10 +23,15 @@
 namespace paddle {
 namespace lite {
 
+// Number of input shapes whose inferred output shapes are kept per op, enough
+// for traffic that alternates between a few image sizes or sequence lengths.
+static const size_t kInferShapeCacheSize = 4;
+
 bool OpLite::InferShape() {
   // if input_tensor_ptrs and output_tensor_ptrs are overloaded in param_
   // InferShapeByMemoryInternal will be applied.
-  if (param_.input_tensor_ptrs() && param_.output_tensor_ptrs()) {
+  if (op_param_ && op_param_->input_tensor_ptrs() &&
+      op_param_->output_tensor_ptrs()) {
     return this->InferShapeWithCache();
   } else {
     // otherwise, InferShapeImpl is applied directly.
@@ -34,13 +40,15 @@ bool OpLite::InferShape() {
 }
 bool OpLite::InferShapeWithCache() {
   // 1. Get vector of current input tensors
-  auto *current_inputs = param_.input_tensor_ptrs();
+  auto *current_inputs = op_param_->input_tensor_ptrs();
   // 2. Get hash value of current inputs shape and lod
   size_t new_hash = 0;
   for (auto iter = current_inputs->begin(); iter != current_inputs->end();
        iter++) {
+    if (*iter == nullptr) continue;
     // combined dims value into new_hash value.
     auto &element_dims = (*iter)->dims();
+    new_hash = lite::hash_combine(new_hash, element_dims.size());
     for (int i = 0; i < element_dims.size(); i++) {
       new_hash =
           lite::hash_combine(new_hash, static_cast<int>(element_dims[i]));
@@ -49,29 +57,68 @@ bool OpLite::InferShapeWithCache() {
     auto &emement_lods = (*iter)->lod();
     for (auto lod_iter = emement_lods.begin(); lod_iter != emement_lods.end();
          lod_iter++) {
+      new_hash = lite::hash_combine(new_hash, lod_iter->size());
       for (int i = 0; i < lod_iter->size(); i++) {
         new_hash =
             lite::hash_combine(new_hash, static_cast<int>(lod_iter->at(i)));
       }
     }
   }
+  auto *current_outputs = op_param_->output_tensor_ptrs();
   // 3. infer shapes of output tensors
-  if (new_hash == io_shape_lod_hash_ && new_hash != 0) {
-    // if current hash value is consistent with io_shape_lod_hash_,
-    // previous outputs shape and lod are reused.
-    auto *current_outputs = param_.output_tensor_ptrs();
-    for (int i = 0; i < current_outputs->size(); i++) {
-      current_outputs->at(i)->Resize(last_output_shapes[i]);
-      current_outputs->at(i)->set_lod(last_output_lods[i]);
+  auto same_inputs = [&](const InferShapeCacheEntry &entry) {
+    if (entry.io_shape_lod_hash != new_hash) return false;
+    for (size_t i = 0; i < current_inputs->size(); i++) {
+      if (current_inputs->at(i) == nullptr) continue;
+      if (current_inputs->at(i)->dims() != entry.input_shapes[i] ||
+          current_inputs->at(i)->lod() != entry.input_lods[i]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  size_t hit = 0;
+  while (hit < infer_shape_cache_.size() &&
+         !same_inputs(infer_shape_cache_[hit])) {
+    hit++;
+  }
+  if (hit < infer_shape_cache_.size()) {
+    // the input shapes were seen recently, their outputs shape and lod are
+    // reused.
+    std::rotate(infer_shape_cache_.begin(),
+                infer_shape_cache_.begin() + hit,
+                infer_shape_cache_.begin() + hit + 1);
+    auto &entry = infer_shape_cache_.front();
+    for (size_t i = 0; i < current_outputs->size(); i++) {
+      if (current_outputs->at(i) == nullptr) continue;
+      current_outputs->at(i)->Resize(entry.output_shapes[i]);
+      current_outputs->at(i)->set_lod(entry.output_lods[i]);
     }
   } else {
-    // otherwise, current hash value is changed, InferShapeImpl will apply.
-    io_shape_lod_hash_ = new_hash;
+    // otherwise, InferShapeImpl will apply and its result replaces the least
+    // recently used entry.
     this->InferShapeImpl();
-    auto *current_outputs = param_.output_tensor_ptrs();
-    for (int i = 0; i < current_outputs->size(); i++) {
-      last_output_shapes[i] = current_outputs->at(i)->dims();
-      last_output_lods[i] = current_outputs->at(i)->lod();
+    if (infer_shape_cache_.size() < kInferShapeCacheSize) {
+      infer_shape_cache_.emplace_back();
+    }
+    std::rotate(infer_shape_cache_.begin(),
+                infer_shape_cache_.end() - 1,
+                infer_shape_cache_.end());
+    auto &entry = infer_shape_cache_.front();
+    entry.io_shape_lod_hash = new_hash;
+    entry.input_shapes.resize(current_inputs->size());
+    entry.input_lods.resize(current_inputs->size());
+    for (size_t i = 0; i < current_inputs->size(); i++) {
+      if (current_inputs->at(i) == nullptr) continue;
+      entry.input_shapes[i] = current_inputs->at(i)->dims();
+      entry.input_lods[i] = current_inputs->at(i)->lod();
+    }
+    entry.output_shapes.resize(current_outputs->size());
+    entry.output_lods.resize(current_outputs->size());
+    for (size_t i = 0; i < current_outputs->size(); i++) {
+      if (current_outputs->at(i) == nullptr) continue;
+      entry.output_shapes[i] = current_outputs->at(i)->dims();
+      entry.output_lods[i] = current_outputs->at(i)->lod();
     }
   }
   return true;
@@ -140,7 +187,12 @@ bool OpLite::Attach(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   scope_ = scope;
   op_info_.reset(
       new OpInfo(opdesc));  // Force clean the out-of-date infomation.
-  return AttachImpl(*op_info(), scope);
+  bool res = AttachImpl(*op_info(), scope);
+  // The op may be attached again to other tensors, e.g. by
+  // mir::Node::Stmt::ResetOp, so the cached tensors and shapes are stale.
+  if (op_param_) op_param_->ClearTensorPtrsCache();
+  infer_shape_cache_.clear();
+  return res;
 }
 
 const Tensor *OpLite::GetTensor(lite::Scope *scope,
@@ -168,15 +168,26 @@ class OpLite : public Registry {
   Place kernel_place_{TARGET(kHost), PRECISION(kFloat)};
   std::unique_ptr<OpInfo> op_info_;
 
-  std::vector<DDimLite> last_output_shapes{};
-  std::vector<std::vector<std::vector<uint64_t>>> last_output_lods{};
-  size_t io_shape_lod_hash_{};
-  mutable operators::ParamBase param_;
+  // Set by the ops whose output shapes depend on nothing but the shapes and
+  // lods of the tensors listed by the param, to enable the InferShape cache.
+  operators::ParamBase *op_param_{nullptr};
 
  private:
-  // Infer Shape according to memory, if current input shapes are consistent
-  // with that of previous inputs, output shapes of last time will be reused.
+  struct InferShapeCacheEntry {
+    size_t io_shape_lod_hash;
+    // Compared on a hash match, different inputs may share a hash.
+    std::vector<DDimLite> input_shapes;
+    std::vector<LoD> input_lods;
+    std::vector<DDimLite> output_shapes;
+    std::vector<LoD> output_lods;
+  };
+
+  // Infer Shape according to memory, output shapes inferred for one of the
+  // recently seen input shapes are reused without calling InferShapeImpl.
   bool InferShapeWithCache();
+
+  // Most recently used first.
+  std::vector<InferShapeCacheEntry> infer_shape_cache_;
 };
 
 /*
@@ -20,5 +20,117 @@ namespace lite {
 
 TEST(OpLite, test) {}
 
+struct InferShapeCacheParam : operators::ParamBase {
+  const lite::Tensor* x{};
+  lite::Tensor* out{};
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
+      input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
+    }
+    return input_tensor_ptrs_cache_.get();
+  }
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({out}));
+    }
+    return output_tensor_ptrs_cache_.get();
+  }
+};
+
+// Doubles the first dim of X.
+class InferShapeCacheOp : public OpLite {
+ public:
+  InferShapeCacheOp(const lite::Tensor* x, lite::Tensor* out)
+      : OpLite("infer_shape_cache") {
+    param_.x = x;
+    param_.out = out;
+    op_param_ = &param_;
+  }
+  bool InferShapeImpl() const override {
+    auto dims = param_.x->dims();
+    dims[0] *= 2;
+    param_.out->Resize(dims);
+    param_.out->set_lod(param_.x->lod());
+    num_infer_++;
+    return true;
+  }
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    param_.x = GetTensor(scope, opdesc.Input("X").front());
+    param_.out = GetMutableTensor(scope, opdesc.Output("Out").front());
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "infer_shape_cache"; }
+  int num_infer() const { return num_infer_; }
+
+ private:
+  mutable InferShapeCacheParam param_;
+  mutable int num_infer_{0};
+};
+
+TEST(OpLite, infer_shape_cache) {
+  lite::Tensor x, out;
+  InferShapeCacheOp op(&x, &out);
+  // Alternating between a few shapes infers each of them once.
+  for (int round = 0; round < 3; round++) {
+    for (int64_t n = 1; n <= 4; n++) {
+      x.Resize({n, 3});
+      x.set_lod({{0, static_cast<uint64_t>(n)}});
+      ASSERT_TRUE(op.InferShape());
+      EXPECT_EQ(out.dims()[0], 2 * n);
+      EXPECT_EQ(out.dims()[1], 3);
+      EXPECT_EQ(out.lod()[0][1], static_cast<uint64_t>(n));
+    }
+  }
+  EXPECT_EQ(op.num_infer(), 4);
+  // A fifth shape evicts the least recently used one.
+  x.Resize({5, 3});
+  op.InferShape();
+  x.Resize({1, 3});
+  x.set_lod({{0, 1}});
+  op.InferShape();
+  EXPECT_EQ(out.dims()[0], 2);
+  EXPECT_EQ(op.num_infer(), 6);
+}
+
+TEST(OpLite, infer_shape_cache_hash_collision) {
+  lite::Tensor x, out;
+  InferShapeCacheOp op(&x, &out);
+  // The hash only takes the low 32 bits of each dim, so these two shapes
+  // share it.
+  const int64_t big = (int64_t(1) << 32) + 3;
+  x.Resize({3, 3});
+  op.InferShape();
+  EXPECT_EQ(out.dims()[0], 6);
+  x.Resize({big, 3});
+  op.InferShape();
+  EXPECT_EQ(out.dims()[0], 2 * big);
+  EXPECT_EQ(op.num_infer(), 2);
+}
+
+TEST(OpLite, infer_shape_cache_attach_again) {
+  lite::Scope scope;
+  auto* x0 = scope.Var("x0")->GetMutable<lite::Tensor>();
+  auto* x1 = scope.Var("x1")->GetMutable<lite::Tensor>();
+  auto* out0 = scope.Var("out0")->GetMutable<lite::Tensor>();
+  auto* out1 = scope.Var("out1")->GetMutable<lite::Tensor>();
+  x0->Resize({3, 3});
+  x1->Resize({3, 3});
+  InferShapeCacheOp op(x0, out0);
+  op.InferShape();
+  EXPECT_EQ(out0->dims()[0], 6);
+  // Attaching the op to other tensors with the same shapes must resize the
+  // new output, not the one cached from the previous attach.
+  cpp::OpDesc desc;
+  desc.SetType("infer_shape_cache");
+  desc.SetInput("X", {"x1"});
+  desc.SetOutput("Out", {"out1"});
+  ASSERT_TRUE(op.Attach(desc, &scope));
+  op.InferShape();
+  EXPECT_EQ(out1->dims().size(), 2UL);
+  EXPECT_EQ(out1->dims()[0], 6);
+  EXPECT_EQ(op.num_infer(), 2);
+}
+
 }  // namespace lite
 }  // namespace paddle
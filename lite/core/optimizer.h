@@ -57,6 +57,9 @@ class Optimizer {
       std::vector<std::string> passes_local{
           {"lite_quant_dequant_fuse_pass",         //
            "weight_quantization_preprocess_pass",  //
+           "lookup_table_quantize_pass",           //
+           "constant_folding_pass",                // fold the ops which only
+                                                   // depend on weights
            "lite_conv_elementwise_fuse_pass",      // conv-elemwise-bn
            "lite_conv_bn_fuse_pass",               //
            "lite_conv_elementwise_fuse_pass",      // conv-bn-elemwise
@@ -68,11 +71,14 @@ class Optimizer {
 #endif
            "lite_var_conv_2d_activation_fuse_pass",       //
            "lite_fc_fuse_pass",                           //
+           "lite_elementwise_add_layer_norm_fuse_pass",   //
            "lite_shuffle_channel_fuse_pass",              //
+           "transpose_eliminate_pass",                    //
            "lite_transpose_softmax_transpose_fuse_pass",  //
            "lite_interpolate_fuse_pass",                  //
            "identity_scale_eliminate_pass",               //
            "elementwise_mul_constant_eliminate_pass",     //
+           "lite_embedding_seq_pool_fuse_pass",           //
            "lite_sequence_pool_concat_fuse_pass",         //
 #if (defined LITE_WITH_LIGHT_WEIGHT_FRAMEWORK) || (defined LITE_WITH_CUDA) || \
     (defined LITE_WITH_ARM)
@@ -80,6 +86,8 @@ class Optimizer {
 #endif
            "__xpu__resnet_fuse_pass",
            "__xpu__multi_encoder_fuse_pass",
+           "common_subexpression_eliminate_pass",
+           "dead_code_eliminate_pass",
            "quantized_op_attributes_inference_pass",  // Only for fully
                                                       // quantized model, infer
                                                       // the output scale and
@@ -129,6 +137,8 @@ class Optimizer {
            "runtime_context_assign_pass",
            "argument_type_display_pass",
 
+           "view_op_inplace_pass",  // share the input buffer in reshape-like
+                                    // ops, must be before memory_optimize_pass
            "memory_optimize_pass"}};
 
       if (passes.size() == 1) {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/program.h"
+#include <algorithm>
 #include <unordered_map>
 #include "lite/model_parser/cpp/block_desc.h"
 #include "lite/model_parser/cpp/op_desc.h"
@@ -27,6 +28,154 @@
 namespace paddle {
 namespace lite {
 
+namespace {
+
+// Hands the block named by the "sub_block" attribute to the control flow ops.
+void SetSubBlock(OpLite* op,
+                 const cpp::OpDesc& op_desc,
+                 cpp::ProgramDesc* program) {
+  auto op_type = op_desc.Type();
+  if (op_type != "while" && op_type != "conditional_block" &&
+      op_type != "subgraph") {
+    return;
+  }
+  auto sub_block_idx = op_desc.GetAttr<int32_t>("sub_block");
+  CHECK(sub_block_idx >= 0 && sub_block_idx < program->BlocksSize())
+      << "Invalid attribute sub_block(" << sub_block_idx << ") for "
+      << op_type;
+  auto sub_block_desc = program->GetBlock<cpp::BlockDesc>(sub_block_idx);
+  CHECK(sub_block_desc);
+  if (op_type == "while") {
+    auto* while_op = static_cast<operators::WhileOpLite*>(op);
+    while_op->SetSubBlock(sub_block_desc);
+    while_op->SetProgramDesc(program);
+  } else if (op_type == "conditional_block") {
+    auto* cond_op = static_cast<operators::ConditionalBlockOpLite*>(op);
+    cond_op->SetSubBlock(sub_block_desc);
+    cond_op->SetProgramDesc(program);
+  } else if (op_type == "subgraph") {
+    static_cast<operators::SubgraphOp*>(op)->SetSubBlock(sub_block_desc);
+  }
+}
+
+// Matching score of a kernel against the places, the lower the better.
+size_t PlaceScore(const KernelBase& kernel,
+                  const std::vector<Place>& valid_places) {
+  for (size_t i = 0; i < valid_places.size(); ++i) {
+    const auto& place = valid_places[i];
+    if (kernel.target() != place.target) continue;
+    bool precision_match = kernel.precision() == place.precision;
+    bool layout_match = kernel.layout() == place.layout;
+    if ((precision_match || kernel.precision() == PRECISION(kAny)) &&
+        (layout_match || kernel.layout() == DATALAYOUT(kAny))) {
+      // Prefer the kernels specialized for the place over the kAny ones.
+      return i * 4 + !precision_match * 2 + !layout_match;
+    }
+  }
+  return valid_places.size() * 4;
+}
+
+}  // namespace
+
+RuntimeProgram::RuntimeProgram(cpp::ProgramDesc* program,
+                               cpp::BlockDesc* block,
+                               lite::Scope* exec_scope,
+                               const std::vector<Place>& valid_places)
+    : exec_scope_(exec_scope) {
+  CHECK(block);
+  CHECK(exec_scope);
+  std::vector<Place> places = valid_places;
+  if (places.empty()) {
+#ifdef LITE_WITH_X86
+    places.emplace_back(TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW));
+    places.emplace_back(TARGET(kX86), PRECISION(kInt64), DATALAYOUT(kNCHW));
+#endif
+#ifdef LITE_WITH_ARM
+    places.emplace_back(TARGET(kARM), PRECISION(kFloat), DATALAYOUT(kNCHW));
+    places.emplace_back(TARGET(kARM), PRECISION(kInt64), DATALAYOUT(kNCHW));
+#endif
+    places.emplace_back(TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW));
+    places.emplace_back(TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny));
+  }
+  for (size_t i = 0; i < block->OpsSize(); ++i) {
+    auto& op_desc = *block->GetOp<cpp::OpDesc>(i);
+    auto op_type = op_desc.Type();
+    auto op = LiteOpRegistry::Global().Create(op_type);
+    CHECK(op) << "no Op found for " << op_type;
+    if (program) {
+      SetSubBlock(op.get(), op_desc, program);
+    }
+    op->Attach(op_desc, exec_scope);
+    auto kernels = op->CreateKernels(places);
+    CHECK(!kernels.empty()) << "no kernel found for " << op_type;
+    // CreateKernels orders the kernels by place, not by preference.
+    auto best = std::min_element(kernels.begin(),
+                                 kernels.end(),
+                                 [&](const std::unique_ptr<KernelBase>& a,
+                                     const std::unique_ptr<KernelBase>& b) {
+                                   return PlaceScore(*a, places) <
+                                          PlaceScore(*b, places);
+                                 });
+    std::unique_ptr<KernelBase> kernel(std::move(*best));
+    kernel->SetContext(ContextScheduler::Global().NewContext(kernel->target()));
+    instructions_.emplace_back(std::move(op), std::move(kernel));
+  }
+#ifdef LITE_WITH_PROFILE
+  set_profiler();
+#endif
+}
+
+RuntimeProgram::RuntimeProgram(const cpp::ProgramDesc& program,
+                               const std::shared_ptr<Scope>& root)
+    : root_(root) {
+  // 1. Create op first
+  Program prog(program, root, {});
+
+// 2. Create Instructs
+#ifdef LITE_WITH_OPENCL
+  using OpenCLContext = Context<TargetType::kOpenCL>;
+  std::unique_ptr<KernelContext> local_ctx(new KernelContext());
+  local_ctx->As<OpenCLContext>().InitOnce();
+#endif
+
+  // Create the kernels of the target places, and filter out the specific
+  // kernel with the target alias.
+  for (auto& op : prog.ops()) {
+    auto kernel_type = op->op_info()->GetAttr<std::string>(kKernelTypeAttr);
+    std::string op_type, alias;
+    Place place;
+    KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
+    auto kernels = op->CreateKernels({place});
+    // filter out a kernel
+    auto it = std::find_if(
+        kernels.begin(), kernels.end(), [&](std::unique_ptr<KernelBase>& it) {
+          return it->alias() == alias;
+        });
+    CHECK(it != kernels.end());
+
+#ifdef LITE_WITH_OPENCL
+    if ((*it)->target() == TARGET(kOpenCL)) {
+      std::unique_ptr<KernelContext> ctx(new KernelContext());
+      (*local_ctx).As<OpenCLContext>().CopySharedTo(&ctx->As<OpenCLContext>());
+      (*it)->SetContext(std::move(ctx));
+    } else {
+      (*it)->SetContext(ContextScheduler::Global().NewContext((*it)->target()));
+    }
+#else
+    (*it)->SetContext(ContextScheduler::Global().NewContext((*it)->target()));
+#endif
+
+    instructions_.emplace_back(op, std::move(*it));
+  }
+  CHECK(!instructions_.empty()) << "no instructions";
+
+  CHECK(prog.exec_scope());
+  exec_scope_ = prog.exec_scope();
+#ifdef LITE_WITH_PROFILE
+  set_profiler();
+#endif
+}
+
 void RuntimeProgram::SaveOpInfosToProgram(cpp::ProgramDesc* desc) {
   CHECK(desc);
   // NOTE: RuntimeProgram do not has all meta info, so save model just update
@@ -78,6 +227,13 @@ void RuntimeProgram::UpdateVarsOfProgram(cpp::ProgramDesc* desc) {
     origin_var_maps.emplace(name, *v);
   }
 
+  // The vars folded into constants by the passes are persistable now, while
+  // their origin descs are not.
+  auto is_persistable_tensor = [](lite::Scope* scope, const std::string& name) {
+    auto* var = scope->FindVar(name);
+    return var && var->IsType<Tensor>() && var->Get<Tensor>().persistable();
+  };
+
   main_block.ClearVars();
   for (auto& node : instructions_) {
     auto* op = const_cast<lite::OpLite*>(node.op());
@@ -91,7 +247,8 @@ void RuntimeProgram::UpdateVarsOfProgram(cpp::ProgramDesc* desc) {
         auto* v = main_block.AddVar<cpp::VarDesc>();
         v->SetName((it->second).Name());
         v->SetType((it->second).GetType());
-        v->SetPersistable((it->second).Persistable());
+        v->SetPersistable((it->second).Persistable() ||
+                          is_persistable_tensor(scope, in_name));
       } else {
         // New created vars must be LOD_TENSOR
         auto* v = main_block.AddVar<cpp::VarDesc>();
@@ -181,27 +338,7 @@ void Program::Build(const cpp::ProgramDesc& prog) {
     VLOG(4) << "create Op [" << op_type << "]";
     auto op = LiteOpRegistry::Global().Create(op_type);
     CHECK(op) << "no Op found for " << op_type;
-    if (op_type == "while" || op_type == "conditional_block" ||
-        op_type == "subgraph") {
-      auto sub_block_idx = op_desc.GetAttr<int32_t>("sub_block");
-      CHECK(sub_block_idx >= 0 && sub_block_idx < program.BlocksSize())
-          << "Invalid attribute sub_block(" << sub_block_idx << ") for "
-          << op_type;
-      auto sub_block_desc =
-          const_cast<cpp::ProgramDesc&>(prog).GetBlock<cpp::BlockDesc>(
-              sub_block_idx);
-      CHECK(sub_block_desc);
-      if (op_type == "while") {
-        static_cast<operators::WhileOpLite*>(op.get())->SetSubBlock(
-            sub_block_desc);
-      } else if (op_type == "conditional_block") {
-        static_cast<operators::ConditionalBlockOpLite*>(op.get())->SetSubBlock(
-            sub_block_desc);
-      } else if (op_type == "subgraph") {
-        static_cast<operators::SubgraphOp*>(op.get())->SetSubBlock(
-            sub_block_desc);
-      }
-    }
+    SetSubBlock(op.get(), op_desc, const_cast<cpp::ProgramDesc*>(&prog));
     ops_.emplace_back(std::move(op));
     ops_.back()->Attach(op_desc, exec_scope_);
   }
@@ -161,11 +161,28 @@ class LITE_API RuntimeProgram {
     set_profiler();
 #endif
   }
+  // Creates the instructions of an optimized program, whose ops record the
+  // kernels picked by the optimizer, to run on a new kid scope of `root`. The
+  // kid scope is deleted with this program, `program` should outlive it.
+  RuntimeProgram(const cpp::ProgramDesc& program,
+                 const std::shared_ptr<Scope>& root);
+  // Creates the instructions of `block`, the sub block of a while or
+  // conditional_block op in `program`, to run on `exec_scope`. Each op takes
+  // the kernel of the earliest place in `valid_places` it supports, the host
+  // places of this build are used when `valid_places` is empty.
+  RuntimeProgram(cpp::ProgramDesc* program,
+                 cpp::BlockDesc* block,
+                 lite::Scope* exec_scope,
+                 const std::vector<Place>& valid_places = {});
   ~RuntimeProgram() {
 #ifdef LITE_WITH_PROFILE
     LOG(INFO) << "\n" << profiler_.Summary(profile::Type::kCreate);
     LOG(INFO) << "\n" << profiler_.Summary(profile::Type::kDispatch);
 #endif  // LITE_WITH_PROFILE
+    if (root_) {
+      instructions_.clear();
+      root_->DeleteScope(exec_scope_);
+    }
   }
 
   void Run();
@@ -190,6 +207,8 @@ class LITE_API RuntimeProgram {
   RuntimeProgram(const RuntimeProgram&) = delete;
   std::vector<Instruction> instructions_;
   lite::Scope* exec_scope_{};
+  // Set when `exec_scope_` is owned by this program.
+  std::shared_ptr<Scope> root_;
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler profiler_;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/scope.h"
+#include <algorithm>
 
 namespace paddle {
 namespace lite {
@@ -26,11 +27,22 @@ Scope::~Scope() {
 }
 
 Scope &Scope::NewScope() const {
+  std::lock_guard<std::mutex> lock(kids_mutex_);
   kids_.push_back(new Scope);
   kids_.back()->parent_ = this;
   return *kids_.back();
 }
 
+void Scope::DeleteScope(Scope *scope) const {
+  {
+    std::lock_guard<std::mutex> lock(kids_mutex_);
+    auto it = std::find(kids_.begin(), kids_.end(), scope);
+    CHECK(it != kids_.end()) << "The scope to delete is not a kid";
+    kids_.erase(it);
+  }
+  delete scope;
+}
+
 Variable *Scope::Var(const std::string &name) {
   auto *var = FindVar(name);
   if (var) return var;
@@ -15,6 +15,7 @@
 #pragma once
 #include <list>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -37,6 +38,9 @@ class Scope final {
 
   Scope& NewScope() const;
 
+  // Destroy `scope`, a kid created by NewScope.
+  void DeleteScope(Scope* scope) const;
+
   Variable* Var(const std::string& name);
 
   Variable* FindVar(const std::string& name) const;
@@ -71,6 +75,7 @@ class Scope final {
  private:
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
+  mutable std::mutex kids_mutex_;
   const Scope* parent_{nullptr};
   std::unordered_map<std::string, std::unique_ptr<Variable>> vars_;
 };
@@ -33,5 +33,15 @@ TEST(Scope, FindVar) {
   ASSERT_TRUE(scope.FindVar("x"));
 }
 
+TEST(Scope, DeleteScope) {
+  Scope scope;
+  scope.Var("x");
+  auto& kid = scope.NewScope();
+  kid.Var("y");
+  ASSERT_TRUE(kid.FindVar("x"));
+  scope.DeleteScope(&kid);
+  ASSERT_FALSE(scope.FindVar("y"));
+}
+
 }  // namespace lite
 }  // namespace paddle
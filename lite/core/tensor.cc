@@ -23,35 +23,39 @@ namespace lite {
 
 using value_type = int64_t;
 
+const size_t DDimLite::kInlineSize;
+
 value_type DDimLite::production() const {
+  const value_type *dims = data();
   value_type res = 1;
-  for (size_t i = 0; i < data_.size(); i++) {
-    res *= data_[i];
+  for (size_t i = 0; i < size_; i++) {
+    res *= dims[i];
   }
   return res;
 }
 
 value_type DDimLite::count(int start, int end) const {
   start = std::max(start, 0);
-  end = std::min(end, static_cast<int>(data_.size()));
+  end = std::min(end, static_cast<int>(size_));
   if (end < start) {
     return 0;
   }
+  const value_type *dims = data();
   value_type sum = 1;
   for (auto i = start; i < end; ++i) {
-    sum *= data_[i];
+    sum *= dims[i];
   }
   return sum;
 }
 
 DDimLite DDimLite::Slice(int start, int end) const {
   start = std::max(start, 0);
-  end = std::min(end, static_cast<int>(data_.size()));
-  std::vector<value_type> new_dim(end - start);
-  for (int i = start; i < end; i++) {
-    new_dim[i - start] = data_[i];
+  end = std::min(end, static_cast<int>(size_));
+  DDimLite res;
+  if (end > start) {
+    res.ConstructFrom(data() + start, end - start);
   }
-  return DDim(new_dim);
+  return res;
 }
 
 std::string DDimLite::repr() const {
@@ -69,6 +73,32 @@ std::string DDimLite::repr() const {
   return ss.str();
 }
 
+const LoD &TensorLite::EmptyLoD() {
+  static const LoD *lod = new LoD;
+  return *lod;
+}
+
+LoD *TensorLite::mutable_lod() {
+  if (!lod_) {
+    lod_ = std::make_shared<LoD>();
+  } else if (lod_.use_count() > 1) {
+    lod_ = std::make_shared<LoD>(*lod_);
+  }
+  return lod_.get();
+}
+
+void TensorLite::set_lod(const LoD &lod) {
+  if (lod_.get() == &lod) return;
+  if (lod_ && lod_.use_count() == 1) {
+    // Assign in place, the storage is reused when the sizes do not grow.
+    *lod_ = lod;
+  } else if (lod.empty()) {
+    lod_.reset();
+  } else {
+    lod_ = std::make_shared<LoD>(lod);
+  }
+}
+
 void TensorLite::ShareDataWith(const TensorLite &other) {
   buffer_ = other.buffer_;
   dims_ = other.dims_;
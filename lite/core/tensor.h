@@ -38,9 +38,13 @@ class TensorLite;
 using DDim = lite::DDimLite;
 using Tensor = lite::TensorLite;
 
+// Dims of up to kInlineSize ranks are stored in the object itself, so
+// copying, slicing and resizing them never touches the heap. Higher ranks
+// fall back to a vector.
 class DDimLite {
  public:
   using value_type = int64_t;
+  static const size_t kInlineSize = 8;
 
   DDimLite() = default;
 
@@ -48,25 +52,43 @@ class DDimLite {
   // DDimLite(std::initializer_list<value_type> init_list) :
   // DDimLite(std::vector<value_type>(init_list)) {}
 
-  void ConstructFrom(const std::vector<value_type> &x) { data_ = x; }
+  void ConstructFrom(const std::vector<value_type> &x) {
+    ConstructFrom(x.data(), x.size());
+  }
+  void ConstructFrom(const value_type *x, size_t size) {
+    size_ = size;
+    if (size <= kInlineSize) {
+      heap_.clear();
+      std::copy(x, x + size, inline_);
+    } else {
+      heap_.assign(x, x + size);
+    }
+  }
 
-  value_type operator[](int offset) const { return data_[offset]; }
-  value_type &operator[](int offset) { return data_[offset]; }
-  std::vector<int64_t> Vectorize() const { return data_; }
+  value_type operator[](int offset) const { return data()[offset]; }
+  value_type &operator[](int offset) { return data()[offset]; }
+  std::vector<int64_t> Vectorize() const {
+    return std::vector<int64_t>(data(), data() + size_);
+  }
 
-  size_t size() const { return data_.size(); }
-  bool empty() const { return data_.empty(); }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
 
   value_type production() const;
 
-  const std::vector<value_type> &data() const { return data_; }
+  const value_type *data() const {
+    return size_ <= kInlineSize ? inline_ : heap_.data();
+  }
+  value_type *data() { return size_ <= kInlineSize ? inline_ : heap_.data(); }
   value_type count(int start, int end) const;
 
   DDimLite Slice(int start, int end) const;
 
   DDimLite Flatten2D(int col) const {
-    return DDimLite(std::vector<value_type>(
-        {Slice(0, col).production(), Slice(col, size()).production()}));
+    const value_type dims[2] = {count(0, col), count(col, size())};
+    DDimLite res;
+    res.ConstructFrom(dims, 2);
+    return res;
   }
 
   std::string repr() const;
@@ -78,22 +100,17 @@ class DDimLite {
 
   friend bool operator==(const DDimLite &a, const DDimLite &b) {
     if (a.size() != b.size()) return false;
-    for (size_t i = 0; i < a.size(); i++) {
-      if (a[i] != b[i]) return false;
-    }
-    return true;
+    return std::equal(a.data(), a.data() + a.size(), b.data());
   }
 
   friend bool operator!=(const DDimLite &a, const DDimLite &b) {
-    if (a.size() != b.size()) return true;
-    for (size_t i = 0; i < a.size(); i++) {
-      if (a[i] != b[i]) return true;
-    }
-    return false;
+    return !(a == b);
   }
 
  private:
-  std::vector<value_type> data_;
+  size_t size_{0};
+  value_type inline_[kInlineSize]{};
+  std::vector<value_type> heap_;
 };
 
 using LoD = std::vector<std::vector<uint64_t>>;
@@ -128,9 +145,11 @@ class TensorLite {
   const DDimLite &dims() const { return dims_; }
   int64_t numel() const { return dims_.production(); }
 
-  const LoD &lod() const { return lod_; }
-  LoD *mutable_lod() { return &lod_; }
-  void set_lod(const LoD &lod) { lod_ = lod; }
+  // The lod is shared by the copies of a tensor and cloned on the first
+  // write, a pointer from mutable_lod() is valid until the tensor is copied.
+  const LoD &lod() const { return lod_ ? *lod_ : EmptyLoD(); }
+  LoD *mutable_lod();
+  void set_lod(const LoD &lod);
 
   PrecisionType precision() const { return precision_; }
   void set_precision(PrecisionType precision) { precision_ = precision; }
@@ -219,6 +238,8 @@ class TensorLite {
   }
 
  private:
+  static const LoD &EmptyLoD();
+
   TargetType target_{TargetType::kHost};
   // precision_ and persistable_ are only used for persistable vars.
   // If your tensor wants to be saved and loaded correctly, you must
@@ -230,7 +251,7 @@ class TensorLite {
 
   DDimLite dims_;
   std::shared_ptr<Buffer> buffer_;
-  LoD lod_;
+  std::shared_ptr<LoD> lod_;
   size_t memory_size_{};
 
   /// @brief Buffer may be shared with other tensors
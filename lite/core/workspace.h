@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #pragma once
+#include <atomic>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "lite/core/memory.h"
 #include "lite/core/types.h"
 #include "lite/utils/macros.h"
@@ -38,17 +41,57 @@ namespace lite {
  */
 class WorkSpace {
  public:
+  ~WorkSpace() {
+    AllocReset();
+    if (target_ == TARGET(kHost)) HostBytes() -= buffer_->space();
+  }
+
   // Reset the workspace, and treat the workspace as empty.
-  void AllocReset() { cursor_ = 0; }
+  void AllocReset() {
+    cursor_ = 0;
+    if (target_ == TARGET(kHost)) {
+      for (auto& buffer : retired_) HostBytes() -= buffer->space();
+    }
+    retired_.clear();
+  }
 
-  // Allocate a memory buffer.
+  // Allocate a memory buffer, aligned to kAlignment. The buffers allocated
+  // before stay valid until AllocReset, even if the workspace grows.
   core::byte_t* Alloc(size_t size) {
-    buffer_.ResetLazy(target_, cursor_ + size);
-    auto* data = static_cast<core::byte_t*>(buffer_.data()) + cursor_;
+    cursor_ = (cursor_ + kAlignment - 1) / kAlignment * kAlignment;
+    Reserve(cursor_ + size);
+    auto* data = static_cast<core::byte_t*>(buffer_->data()) + cursor_;
     cursor_ += size;
     return data;
   }
 
+  // Grow the workspace to hold `size` bytes without growing again, it never
+  // shrinks. Kernels can call it when planning, before the first run.
+  void Reserve(size_t size) {
+    if (buffer_->space() >= size) return;
+    if (cursor_ > 0) {
+      retired_.emplace_back(std::move(buffer_));
+      buffer_.reset(new Buffer);
+    } else if (target_ == TARGET(kHost)) {
+      HostBytes() -= buffer_->space();
+    }
+    buffer_->ResetLazy(target_, size);
+    if (target_ == TARGET(kHost)) {
+      int64_t bytes = HostBytes() += buffer_->space();
+      int64_t peak = PeakHostBytes();
+      while (bytes > peak &&
+             !PeakHostBytes().compare_exchange_weak(peak, bytes)) {
+      }
+    }
+  }
+
+  // Bytes the workspace can hand out without growing.
+  size_t capacity() const { return buffer_->space(); }
+
+  // Bytes held by the host workspaces of all the threads.
+  static int64_t host_bytes() { return HostBytes(); }
+  static int64_t peak_host_bytes() { return PeakHostBytes(); }
+
   static WorkSpace& Global_Host() {
     thread_local std::unique_ptr<WorkSpace> x(new WorkSpace(TARGET(kHost)));
     return *x;
@@ -77,11 +120,24 @@ class WorkSpace {
 #endif
 
  private:
-  explicit WorkSpace(TargetType x) : target_(x) {}
+  static const size_t kAlignment = 64;
+
+  explicit WorkSpace(TargetType x) : target_(x), buffer_(new Buffer) {}
+
+  static std::atomic<int64_t>& HostBytes() {
+    static std::atomic<int64_t> x{0};
+    return x;
+  }
+  static std::atomic<int64_t>& PeakHostBytes() {
+    static std::atomic<int64_t> x{0};
+    return x;
+  }
 
   TargetType target_;
-  Buffer buffer_;
-  size_t cursor_;
+  std::unique_ptr<Buffer> buffer_;
+  // The buffers outgrown while their memory is still in use.
+  std::vector<std::unique_ptr<Buffer>> retired_;
+  size_t cursor_{0};
 
   DISALLOW_COPY_AND_ASSIGN(WorkSpace);
 };
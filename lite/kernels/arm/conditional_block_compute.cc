@@ -27,10 +27,15 @@ namespace arm {
 
 void ConditionalBlockCompute::PrepareForRun() {
   auto& param = Param<operators::ConditionalBlockParam>();
-  auto cur_scope = param.scope;
-
-  executor_ =
-      std::make_shared<CondExecutor>(param.sub_block, cur_scope, place());
+  auto places = param.valid_places;
+  if (places.empty()) {
+    // The op was created without valid places, run on the place of this
+    // kernel and the host.
+    places = {place(),
+              Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny)}};
+  }
+  program_.reset(new RuntimeProgram(
+      param.program_desc, param.sub_block, param.scope, places));
 }
 void ConditionalBlockCompute::Run() {
   auto& param = Param<operators::ConditionalBlockParam>();
@@ -52,7 +57,7 @@ void ConditionalBlockCompute::Run() {
     }
   }
   if (need_run) {
-    executor_->Run();
+    program_->Run();
   }
 }
 
@@ -41,6 +41,7 @@ void dequant(const unsigned char *in,
 
 void LookupTableDequantCompute::Run() {
   auto &param = this->Param<param_t>();
+  CHECK_EQ(param.quant_bits, 8) << "Only the uint8 tables are supported";
   // inputs
   auto w = param.W;
   auto ids = param.Ids;
@@ -158,7 +158,7 @@ void SliceCompute<T, PType>::Run() {
   const auto* x_data = in->template data<T>();
   auto* o_data = out->template mutable_data<T>();
   lite::arm::math::slice(
-      x_data, in_dims.data(), axes, starts, ends, o_data, &ctx);
+      x_data, in_dims.Vectorize(), axes, starts, ends, o_data, &ctx);
 }
 
 }  // namespace arm
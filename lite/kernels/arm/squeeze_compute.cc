@@ -24,10 +24,13 @@ void SqueezeCompute::Run() {
   auto& param = Param<operators::SqueezeParam>();
   auto x = param.X;
   auto output = param.Out;
-  auto x_dims = x->dims();
-  auto* x_data = x->data<float>();
-  auto* out_data = output->mutable_data<float>();
-  memcpy(out_data, x_data, x_dims.production() * sizeof(float));
+  auto out_dims = output->dims();
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
+  output->Resize(out_dims);
 }
 
 void Squeeze2Compute::Run() {
@@ -36,11 +39,16 @@ void Squeeze2Compute::Run() {
   auto output = param.Out;
   auto xshape = param.XShape;
   auto x_dims = x->dims();
+  auto out_dims = output->dims();
   auto* x_data = x->data<float>();
-  auto* out_data = output->mutable_data<float>();
   auto* xshape_data = xshape->mutable_data<float>();
-  memcpy(out_data, x_data, x_dims.production() * sizeof(float));
   memcpy(xshape_data, x_data, x_dims.production() * sizeof(float));
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
+  output->Resize(out_dims);
 }
 
 }  // namespace host
@@ -27,15 +27,20 @@ namespace arm {
 
 void WhileCompute::PrepareForRun() {
   auto &param = Param<operators::WhileParam>();
-  auto cur_scope = param.scope;
-
-  executor_ =
-      std::make_shared<StepExecutor>(param.sub_block, cur_scope, place());
+  auto places = param.valid_places;
+  if (places.empty()) {
+    // The op was created without valid places, run on the place of this
+    // kernel and the host.
+    places = {place(),
+              Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny)}};
+  }
+  program_.reset(new RuntimeProgram(
+      param.program_desc, param.sub_block, param.scope, places));
 }
 void WhileCompute::Run() {
   auto &param = Param<operators::WhileParam>();
   while (param.cond->data<bool>()[0]) {
-    executor_->Run();
+    program_->Run();
   }
 }
 
@@ -0,0 +1,67 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/increment_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+template <typename T>
+void Increment(const Tensor* x, float step, Tensor* out) {
+  const T* x_data = x->data<T>();
+  T* out_data = out->mutable_data<T>();
+  int64_t total_num = x->numel();
+  for (int64_t i = 0; i < total_num; i++) {
+    out_data[i] = x_data[i] + static_cast<T>(step);
+  }
+}
+
+void IncrementCompute::Run() {
+  auto& param = Param<operators::IncrementParam>();
+  switch (param.X->precision()) {
+    case PRECISION(kFloat):
+      Increment<float>(param.X, param.step, param.Out);
+      break;
+    case PRECISION(kInt64):
+      Increment<int64_t>(param.X, param.step, param.Out);
+      break;
+    case PRECISION(kInt32):
+      Increment<int32_t>(param.X, param.step, param.Out);
+      break;
+    default:
+      LOG(FATAL) << "unsupport input type "
+                 << PrecisionToStr(param.X->precision());
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(increment,
+                     kHost,
+                     kAny,
+                     kAny,
+                     paddle::lite::kernels::host::IncrementCompute,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny))})
+    .Finalize();
@@ -0,0 +1,119 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/logical_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+struct _LogicalAndFunctor {
+  inline bool operator()(bool a, bool b) const { return a && b; }
+};
+
+struct _LogicalOrFunctor {
+  inline bool operator()(bool a, bool b) const { return a || b; }
+};
+
+struct _LogicalXorFunctor {
+  inline bool operator()(bool a, bool b) const { return a != b; }
+};
+
+struct _LogicalNotFunctor {
+  inline bool operator()(bool a) const { return !a; }
+};
+
+template <typename Functor>
+void BinaryLogicalCompute<Functor>::Run() {
+  auto& param = this->template Param<operators::LogicalParam>();
+  const int64_t count = param.X->numel();
+  const bool* x = param.X->template data<bool>();
+  const bool* y = param.Y->template data<bool>();
+  bool* z = param.Out->template mutable_data<bool>();
+  Functor functor;
+  for (int64_t i = 0; i < count; ++i) {
+    z[i] = functor(x[i], y[i]);
+  }
+}
+
+template <typename Functor>
+void UnaryLogicalCompute<Functor>::Run() {
+  auto& param = this->template Param<operators::LogicalParam>();
+  const int64_t count = param.X->numel();
+  const bool* x = param.X->template data<bool>();
+  bool* z = param.Out->template mutable_data<bool>();
+  Functor functor;
+  for (int64_t i = 0; i < count; ++i) {
+    z[i] = functor(x[i]);
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+using logical_and_host = paddle::lite::kernels::host::BinaryLogicalCompute<
+    paddle::lite::kernels::host::_LogicalAndFunctor>;
+REGISTER_LITE_KERNEL(logical_and, kHost, kAny, kAny, logical_and_host, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .Finalize();
+
+using logical_or_host = paddle::lite::kernels::host::BinaryLogicalCompute<
+    paddle::lite::kernels::host::_LogicalOrFunctor>;
+REGISTER_LITE_KERNEL(logical_or, kHost, kAny, kAny, logical_or_host, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .Finalize();
+
+using logical_xor_host = paddle::lite::kernels::host::BinaryLogicalCompute<
+    paddle::lite::kernels::host::_LogicalXorFunctor>;
+REGISTER_LITE_KERNEL(logical_xor, kHost, kAny, kAny, logical_xor_host, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .Finalize();
+
+using logical_not_host = paddle::lite::kernels::host::UnaryLogicalCompute<
+    paddle::lite::kernels::host::_LogicalNotFunctor>;
+REGISTER_LITE_KERNEL(logical_not, kHost, kAny, kAny, logical_not_host, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(
+                   TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(
+                    TARGET(kHost), PRECISION(kBool), DATALAYOUT(kAny))})
+    .Finalize();
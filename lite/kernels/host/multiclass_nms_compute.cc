@@ -13,7 +13,7 @@
 // limitations under the License.
 
 #include "lite/kernels/host/multiclass_nms_compute.h"
-#include <map>
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -28,24 +28,12 @@ bool SortScorePairDescend(const std::pair<float, T>& pair1,
   return pair1.first > pair2.first;
 }
 
-template <class T>
-static void GetMaxScoreIndex(const std::vector<T>& scores,
-                             const T threshold,
-                             int top_k,
-                             std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
+// Orders the candidates as a stable descending sort by score would, the
+// smaller box index comes first on a tie.
+static bool SortScoreIndexDescend(const std::pair<float, int>& pair1,
+                                  const std::pair<float, int>& pair2) {
+  return pair1.first > pair2.first ||
+         (pair1.first == pair2.first && pair1.second < pair2.second);
 }
 
 template <class T>
@@ -95,152 +83,186 @@ T PolyIoU(const T* box1,
   return *box1;
 }
 
-template <class T>
-void SliceOneClass(const Tensor& items,
-                   const int class_id,
-                   Tensor* one_class_item) {
-  T* item_data = one_class_item->mutable_data<T>();
-  const T* items_data = items.data<T>();
-  const int64_t num_item = items.dims()[0];
-  const int64_t class_num = items.dims()[1];
-  if (items.dims().size() == 3) {
-    int64_t item_size = items.dims()[2];
-    for (int i = 0; i < num_item; ++i) {
-      std::memcpy(item_data + i * item_size,
-                  items_data + i * class_num * item_size + class_id * item_size,
-                  sizeof(T) * item_size);
+// The scores and boxes of one class of one image. The [N, C, M] scores share
+// the [M, box_size] boxes of the image across the classes, the LoD [M, C]
+// scores come with [M, C, box_size] boxes, one box per class.
+struct ClassView {
+  const float* scores;
+  int64_t score_stride;
+  const float* boxes;
+  int64_t box_stride;
+  int64_t num_boxes;
+
+  float score(int idx) const { return scores[idx * score_stride]; }
+  const float* box(int idx) const { return boxes + idx * box_stride; }
+};
+
+// Collects the candidates scoring above threshold. A block of scores is
+// skipped at once when its maximum does not pass the threshold.
+static void FilterByScore(const ClassView& view,
+                          float threshold,
+                          std::vector<std::pair<float, int>>* candidates) {
+  constexpr int kBlockSize = 16;
+  candidates->clear();
+  for (int begin = 0; begin < view.num_boxes; begin += kBlockSize) {
+    int end = std::min<int>(begin + kBlockSize, view.num_boxes);
+    float max = view.score(begin);
+    for (int j = begin + 1; j < end; ++j) {
+      float s = view.score(j);
+      max = s > max ? s : max;
     }
-  } else {
-    for (int i = 0; i < num_item; ++i) {
-      item_data[i] = items_data[i * class_num + class_id];
+    if (!(max > threshold)) continue;
+    for (int j = begin; j < end; ++j) {
+      if (view.score(j) > threshold) {
+        candidates->emplace_back(view.score(j), j);
+      }
     }
   }
 }
 
-template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
-             const T score_threshold,
-             const T nms_threshold,
-             const T eta,
-             const int64_t top_k,
-             std::vector<int>* selected_indices,
-             const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
-  // 4: [xmin ymin xmax ymax]
-  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
-  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
+// Returns the bits of the candidates in [begin, end) suppressed by the kept
+// candidate i, bit 0 stands for the candidate base.
+static uint64_t SuppressMask(const MulticlassNmsCompute::ClassScratch& scratch,
+                             int i,
+                             int base,
+                             int begin,
+                             int end,
+                             float norm,
+                             float nms_threshold) {
+  const float* x1 = scratch.x1.data();
+  const float* y1 = scratch.y1.data();
+  const float* x2 = scratch.x2.data();
+  const float* y2 = scratch.y2.data();
+  const float* area = scratch.area.data();
+  uint64_t mask = 0;
+  for (int j = begin; j < end; ++j) {
+    // The same arithmetic as JaccardOverlap(box j, box i).
+    bool disjoint = (x1[i] > x2[j]) | (x2[i] < x1[j]) | (y1[i] > y2[j]) |
+                    (y2[i] < y1[j]);
+    float inter_w = std::min(x2[j], x2[i]) - std::max(x1[j], x1[i]) + norm;
+    float inter_h = std::min(y2[j], y2[i]) - std::max(y1[j], y1[i]) + norm;
+    float inter_area = inter_w * inter_h;
+    float overlap =
+        disjoint ? 0.f : inter_area / (area[j] + area[i] - inter_area);
+    mask |= static_cast<uint64_t>(!(overlap <= nms_threshold)) << (j - base);
+  }
+  return mask;
+}
 
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  GetMaxScoreIndex(scores_data, score_threshold, top_k, &sorted_indices);
+static void NMSOneClass(const ClassView& view,
+                        const int64_t box_size,
+                        const operators::MulticlassNmsParam& param,
+                        MulticlassNmsCompute::ClassScratch* scratch) {
+  auto& sorted = scratch->sorted;
+  auto& selected = scratch->selected;
+  selected.clear();
+  FilterByScore(view, param.score_threshold, &sorted);
+  int64_t top_k = param.nms_top_k;
+  if (top_k > -1 && top_k < static_cast<int64_t>(sorted.size())) {
+    std::partial_sort(sorted.begin(),
+                      sorted.begin() + top_k,
+                      sorted.end(),
+                      SortScoreIndexDescend);
+    sorted.resize(top_k);
+  } else {
+    std::sort(sorted.begin(), sorted.end(), SortScoreIndexDescend);
+  }
 
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
+  const float nms_threshold = param.nms_threshold;
+  const float eta = param.nms_eta;
+  const bool normalized = param.normalized;
+  const int num = sorted.size();
+  if (box_size == 4 && !(eta < 1 && nms_threshold > 0.5)) {
+    // The threshold is fixed, a box is kept unless a kept box with a higher
+    // score overlaps it. Each kept box marks the boxes it suppresses in a
+    // bitmask, 64 boxes at a time, and the fully suppressed words are
+    // skipped.
+    scratch->x1.resize(num);
+    scratch->y1.resize(num);
+    scratch->x2.resize(num);
+    scratch->y2.resize(num);
+    scratch->area.resize(num);
+    for (int j = 0; j < num; ++j) {
+      const float* box = view.box(sorted[j].second);
+      scratch->x1[j] = box[0];
+      scratch->y1[j] = box[1];
+      scratch->x2[j] = box[2];
+      scratch->y2[j] = box[3];
+      scratch->area[j] = BBoxArea<float>(box, normalized);
+    }
+    const int words = (num + 63) / 64;
+    auto& suppressed = scratch->suppressed;
+    suppressed.assign(words, 0);
+    const float norm = normalized ? 0.f : 1.f;
+    for (int i = 0; i < num; ++i) {
+      if ((suppressed[i / 64] >> (i % 64)) & 1) continue;
+      selected.push_back(sorted[i].second);
+      for (int w = (i + 1) / 64; w < words; ++w) {
+        if (suppressed[w] == ~static_cast<uint64_t>(0)) continue;
+        int base = w * 64;
+        suppressed[w] |= SuppressMask(*scratch,
+                                      i,
+                                      base,
+                                      std::max(base, i + 1),
+                                      std::min(base + 64, num),
+                                      norm,
+                                      nms_threshold);
+      }
+    }
+    return;
+  }
 
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
+  float adaptive_threshold = nms_threshold;
+  for (const auto& candidate : sorted) {
+    const int idx = candidate.second;
     bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap = PolyIoU<T>(bbox_data + idx * box_size,
-                               bbox_data + kept_idx * box_size,
-                               box_size,
-                               normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
+    for (size_t k = 0; k < selected.size() && keep; ++k) {
+      const int kept_idx = selected[k];
+      float overlap = 0.f;
+      // 4: [xmin ymin xmax ymax]
+      if (box_size == 4) {
+        overlap = JaccardOverlap<float>(
+            view.box(idx), view.box(kept_idx), normalized);
+      }
+      // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
+      if (box_size == 8 || box_size == 16 || box_size == 24 ||
+          box_size == 32) {
+        overlap = PolyIoU<float>(
+            view.box(idx), view.box(kept_idx), box_size, normalized);
       }
+      keep = overlap <= adaptive_threshold;
     }
     if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
+      selected.push_back(idx);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
     }
   }
 }
 
-template <typename T>
-void MultiClassNMS(const operators::MulticlassNmsParam& param,
-                   const Tensor& scores,
-                   const Tensor& bboxes,
-                   const int scores_size,
-                   std::map<int, std::vector<int>>* indices,
-                   int* num_nmsed_out) {
-  int64_t background_label = param.background_label;
-  int64_t nms_top_k = param.nms_top_k;
-  int64_t keep_top_k = param.keep_top_k;
-  bool normalized = param.normalized;
-  T nms_threshold = static_cast<T>(param.nms_threshold);
-  T nms_eta = static_cast<T>(param.nms_eta);
-  T score_threshold = static_cast<T>(param.score_threshold);
-
-  int num_det = 0;
-
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
+// Gathers the detections of one image in output order: by label, and within
+// a label in NMS order, or by box index for the LoD input. Only the
+// keep_top_k best ones are kept.
+static void KeepTopK(const ClassView* views,
+                     const MulticlassNmsCompute::ClassScratch* class_scratch,
+                     const int64_t class_num,
+                     const int64_t keep_top_k,
+                     const bool sort_by_index,
+                     MulticlassNmsCompute::ImageScratch* scratch) {
+  auto& kept = scratch->kept;
+  kept.clear();
+  size_t num_det = 0;
   for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+    num_det += class_scratch[c].selected.size();
   }
-
-  *num_nmsed_out = num_det;
-  const T* scores_data = scores.data<T>();
-  if (keep_top_k > -1 && num_det > keep_top_k) {
-    const T* sdata;
-    std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
-    for (const auto& it : *indices) {
-      int label = it.first;
-      if (scores_size == 3) {
-        sdata = scores_data + label * scores.dims()[1];
-      } else {
-        score_slice.Resize({scores.dims()[0], 1});
-        SliceOneClass<T>(scores, label, &score_slice);
-        sdata = score_slice.data<T>();
-      }
-      const std::vector<int>& label_indices = it.second;
-      for (size_t j = 0; j < label_indices.size(); ++j) {
-        int idx = label_indices[j];
-        score_index_pairs.push_back(
-            std::make_pair(sdata[idx], std::make_pair(label, idx)));
+  if (keep_top_k > -1 && num_det > static_cast<size_t>(keep_top_k)) {
+    auto& score_index_pairs = scratch->score_index_pairs;
+    score_index_pairs.clear();
+    for (int64_t c = 0; c < class_num; ++c) {
+      for (int idx : class_scratch[c].selected) {
+        score_index_pairs.push_back(std::make_pair(
+            views[c].score(idx), std::make_pair(static_cast<int>(c), idx)));
       }
     }
     // Keep top k results per image.
@@ -248,75 +270,24 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
                      score_index_pairs.end(),
                      SortScorePairDescend<std::pair<int, int>>);
     score_index_pairs.resize(keep_top_k);
-
-    // Store the new indices.
-    std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
-      new_indices[label].push_back(idx);
-    }
-    if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
-      }
+    for (const auto& pair : score_index_pairs) {
+      kept.push_back(pair.second);
     }
-    new_indices.swap(*indices);
-    *num_nmsed_out = keep_top_k;
-  }
-}
-
-template <typename T>
-void MultiClassOutput(const Tensor& scores,
-                      const Tensor& bboxes,
-                      const std::map<int, std::vector<int>>& selected_indices,
-                      const int scores_size,
-                      Tensor* outs,
-                      int* oindices = nullptr,
-                      const int offset = 0) {
-  int64_t class_num = scores.dims()[1];
-  int64_t predict_dim = scores.dims()[1];
-  int64_t box_size = bboxes.dims()[1];
-  if (scores_size == 2) {
-    box_size = bboxes.dims()[2];
-  }
-  int64_t out_dim = box_size + 2;
-  auto* scores_data = scores.data<T>();
-  auto* bboxes_data = bboxes.data<T>();
-  auto* odata = outs->mutable_data<T>();
-  const T* sdata;
-  Tensor bbox;
-  bbox.Resize({scores.dims()[0], box_size});
-  int count = 0;
-  for (const auto& it : selected_indices) {
-    int label = it.first;
-    const std::vector<int>& indices = it.second;
-    if (scores_size == 2) {
-      SliceOneClass<T>(bboxes, label, &bbox);
+    if (sort_by_index) {
+      std::sort(kept.begin(), kept.end());
     } else {
-      sdata = scores_data + label * predict_dim;
+      std::stable_sort(
+          kept.begin(),
+          kept.end(),
+          [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first < b.first;
+          });
     }
-    for (size_t j = 0; j < indices.size(); ++j) {
-      int idx = indices[j];
-      odata[count * out_dim] = label;  // label
-      const T* bdata;
-      if (scores_size == 3) {
-        bdata = bboxes_data + idx * box_size;
-        odata[count * out_dim + 1] = sdata[idx];  // score
-        if (oindices != nullptr) {
-          oindices[count] = offset + idx;
-        }
-      } else {
-        bdata = bbox.data<T>() + idx * box_size;
-        odata[count * out_dim + 1] = *(scores_data + idx * class_num + label);
-        if (oindices != nullptr) {
-          oindices[count] = offset + idx * class_num + label;
-        }
+  } else {
+    for (int64_t c = 0; c < class_num; ++c) {
+      for (int idx : class_scratch[c].selected) {
+        kept.emplace_back(static_cast<int>(c), idx);
       }
-      // xmin, ymin, xmax, ymax or multi-points coordinates
-      std::memcpy(odata + count * out_dim + 2, bdata, box_size * sizeof(T));
-      count++;
     }
   }
 }
@@ -329,32 +300,75 @@ void MulticlassNmsCompute::Run() {
   bool return_index = param.index ? true : false;
   auto* index = param.index;
   auto score_dims = scores->dims();
-  auto score_size = score_dims.size();
+  // The scores are either [N, C, M], or [M, C] with the images in the LoD
+  // of the boxes.
+  const bool class_major = score_dims.size() == 3;
+  const int64_t class_num = score_dims[1];
+  const int64_t box_dim = boxes->dims()[2];
+  const int64_t out_dim = box_dim + 2;
+  const float* scores_data = scores->data<float>();
+  const float* boxes_data = boxes->data<float>();
+  std::vector<uint64_t> boxes_lod;
+  if (!class_major) {
+    boxes_lod = boxes->lod().back();
+  }
+  const int n = class_major ? score_dims[0] : boxes_lod.size() - 1;
 
-  std::vector<std::map<int, std::vector<int>>> all_indices;
-  std::vector<uint64_t> batch_starts = {0};
-  int64_t batch_size = score_dims[0];
-  int64_t box_dim = boxes->dims()[2];
-  int64_t out_dim = box_dim + 2;
-  int num_nmsed_out = 0;
-  Tensor boxes_slice, scores_slice;
-  int n = score_size == 3 ? batch_size : boxes->lod().back().size() - 1;
+  std::vector<ClassView> views(n * class_num);
   for (int i = 0; i < n; ++i) {
-    if (score_size == 3) {
-      scores_slice = scores->Slice<float>(i, i + 1);
-      scores_slice.Resize({score_dims[1], score_dims[2]});
-      boxes_slice = boxes->Slice<float>(i, i + 1);
-      boxes_slice.Resize({score_dims[2], box_dim});
-    } else {
-      auto boxes_lod = boxes->lod().back();
-      scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-      boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
+    for (int64_t c = 0; c < class_num; ++c) {
+      ClassView& view = views[i * class_num + c];
+      if (class_major) {
+        int64_t num_boxes = score_dims[2];
+        view.scores = scores_data + (i * class_num + c) * num_boxes;
+        view.score_stride = 1;
+        view.boxes = boxes_data + i * num_boxes * box_dim;
+        view.box_stride = box_dim;
+        view.num_boxes = num_boxes;
+      } else {
+        int64_t start = boxes_lod[i];
+        view.scores = scores_data + start * class_num + c;
+        view.score_stride = class_num;
+        view.boxes = boxes_data + (start * class_num + c) * box_dim;
+        view.box_stride = class_num * box_dim;
+        view.num_boxes = boxes_lod[i + 1] - start;
+      }
     }
-    std::map<int, std::vector<int>> indices;
-    MultiClassNMS<float>(
-        param, scores_slice, boxes_slice, score_size, &indices, &num_nmsed_out);
-    all_indices.push_back(indices);
-    batch_starts.push_back(batch_starts.back() + num_nmsed_out);
+  }
+
+  // Every (image, class) pair runs its NMS independently.
+  const int task_num = n * class_num;
+  class_scratch_.resize(task_num);
+  image_scratch_.resize(n);
+#if defined(PADDLE_WITH_MKLML) || defined(ARM_WITH_OMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int t = 0; t < task_num; ++t) {
+    auto& scratch = class_scratch_[t];
+    if (t % class_num == param.background_label) {
+      scratch.selected.clear();
+      continue;
+    }
+    NMSOneClass(views[t], box_dim, param, &scratch);
+    if (!class_major) {
+      std::sort(scratch.selected.begin(), scratch.selected.end());
+    }
+  }
+
+#if defined(PADDLE_WITH_MKLML) || defined(ARM_WITH_OMP)
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < n; ++i) {
+    KeepTopK(views.data() + i * class_num,
+             class_scratch_.data() + i * class_num,
+             class_num,
+             param.keep_top_k,
+             !class_major,
+             &image_scratch_[i]);
+  }
+  std::vector<uint64_t> batch_starts = {0};
+  for (int i = 0; i < n; ++i) {
+    batch_starts.push_back(batch_starts.back() + image_scratch_[i].kept.size());
   }
 
   uint64_t num_kept = batch_starts.back();
@@ -370,42 +384,33 @@ void MulticlassNmsCompute::Run() {
     }
   } else {
     outs->Resize({static_cast<int64_t>(num_kept), out_dim});
-    outs->mutable_data<float>();
-    int offset = 0;
+    float* odata = outs->mutable_data<float>();
     int* oindices = nullptr;
+    if (return_index) {
+      index->Resize({static_cast<int64_t>(num_kept), 1});
+      oindices = index->mutable_data<int>();
+    }
+#if defined(PADDLE_WITH_MKLML) || defined(ARM_WITH_OMP)
+#pragma omp parallel for
+#endif
     for (int i = 0; i < n; ++i) {
-      if (score_size == 3) {
-        scores_slice = scores->Slice<float>(i, i + 1);
-        boxes_slice = boxes->Slice<float>(i, i + 1);
-        scores_slice.Resize({score_dims[1], score_dims[2]});
-        boxes_slice.Resize({score_dims[2], box_dim});
-        if (return_index) {
-          offset = i * score_dims[2];
-        }
-      } else {
-        auto boxes_lod = boxes->lod().back();
-        scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-        boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-        if (return_index) {
-          offset = boxes_lod[i] * score_dims[1];
-        }
-      }
-      int64_t s = static_cast<int64_t>(batch_starts[i]);
-      int64_t e = static_cast<int64_t>(batch_starts[i + 1]);
-      if (e > s) {
-        Tensor out = outs->Slice<float>(s, e);
-        if (return_index) {
-          index->Resize({static_cast<int64_t>(num_kept), 1});
-          int* output_idx = index->mutable_data<int>();
-          oindices = output_idx + s;
+      const auto& kept = image_scratch_[i].kept;
+      int64_t offset =
+          class_major ? i * score_dims[2] : boxes_lod[i] * class_num;
+      for (size_t j = 0; j < kept.size(); ++j) {
+        int label = kept[j].first;
+        int idx = kept[j].second;
+        const ClassView& view = views[i * class_num + label];
+        int64_t count = batch_starts[i] + j;
+        float* out = odata + count * out_dim;
+        out[0] = label;
+        out[1] = view.score(idx);
+        // xmin, ymin, xmax, ymax or multi-points coordinates
+        std::memcpy(out + 2, view.box(idx), box_dim * sizeof(float));
+        if (oindices != nullptr) {
+          oindices[count] =
+              offset + (class_major ? idx : idx * class_num + label);
         }
-        MultiClassOutput<float>(scores_slice,
-                                boxes_slice,
-                                all_indices[i],
-                                score_dims.size(),
-                                &out,
-                                oindices,
-                                offset);
       }
     }
   }
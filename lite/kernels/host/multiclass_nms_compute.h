@@ -14,6 +14,8 @@
 
 #pragma once
 #include <algorithm>
+#include <utility>
+#include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -28,6 +30,28 @@ class MulticlassNmsCompute
   void Run() override;
 
   virtual ~MulticlassNmsCompute() = default;
+
+  // The working set of one (image, class) pair. The buffers are kept by the
+  // kernel, so the runs after the first one do not allocate.
+  struct ClassScratch {
+    // The candidates above the score threshold, as (score, box index).
+    std::vector<std::pair<float, int>> sorted;
+    // The candidate boxes in sorted order, one array per coordinate.
+    std::vector<float> x1, y1, x2, y2, area;
+    // Bit j is set once the candidate j is suppressed.
+    std::vector<uint64_t> suppressed;
+    std::vector<int> selected;
+  };
+
+  // The detections of one image, as (label, box index) in output order.
+  struct ImageScratch {
+    std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
+    std::vector<std::pair<int, int>> kept;
+  };
+
+ private:
+  std::vector<ClassScratch> class_scratch_;
+  std::vector<ImageScratch> image_scratch_;
 };
 
 }  // namespace host
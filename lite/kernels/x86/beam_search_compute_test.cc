@@ -0,0 +1,98 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/beam_search_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(beam_search_x86, retrive_op) {
+  auto kernel =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "beam_search");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(beam_search_x86, run_test) {
+  lite::Tensor ids, scores, pre_ids, pre_scores;
+  lite::Tensor selected_ids, selected_scores, parent_idx;
+
+  LoD lod{{0, 2, 4}, {0, 1, 2, 3, 4}};
+  ids.set_lod(lod);
+  scores.set_lod(lod);
+  ids.Resize({4, 3});
+  scores.Resize({4, 3});
+  std::vector<int64_t> ids_vec{4, 2, 5, 2, 1, 3, 3, 5, 2, 8, 2, 1};
+  std::vector<float> scores_vec{
+      0.6f, 0.3f, 0.5f, 0.2f, 0.3f, 0.1f, 0.9f, 0.5f, 0.1f, 0.7f, 0.5f, 0.1f};
+  auto* ids_data = ids.mutable_data<int64_t>();
+  auto* scores_data = scores.mutable_data<float>();
+  for (size_t i = 0; i < ids_vec.size(); i++) {
+    ids_data[i] = ids_vec[i];
+    scores_data[i] = scores_vec[i];
+  }
+  pre_ids.Resize({4, 1});
+  pre_scores.Resize({4, 1});
+  for (int i = 0; i < 4; i++) {
+    pre_ids.mutable_data<int64_t>()[i] = i + 1;
+    pre_scores.mutable_data<float>()[i] = 0.1f * (i + 1);
+  }
+
+  BeamSearchCompute beam_search;
+  operators::BeamSearchParam param;
+  param.pre_ids = &pre_ids;
+  param.pre_scores = &pre_scores;
+  param.ids = &ids;
+  param.scores = &scores;
+  param.selected_ids = &selected_ids;
+  param.selected_scores = &selected_scores;
+  param.parent_idx = &parent_idx;
+  param.level = 0;
+  param.beam_size = 2;
+  param.end_id = 0;
+  param.is_accumulated = true;
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  beam_search.SetContext(std::move(ctx));
+  beam_search.SetParam(param);
+  beam_search.Run();
+
+  ASSERT_EQ(selected_ids.lod(), selected_scores.lod());
+  LoD expected_lod{{0, 2, 4}, {0, 2, 2, 3, 4}};
+  ASSERT_EQ(selected_ids.lod(), expected_lod);
+  std::vector<int64_t> expected_ids{4, 5, 3, 8};
+  std::vector<float> expected_scores{0.6f, 0.5f, 0.9f, 0.7f};
+  std::vector<int> expected_parent{0, 0, 2, 3};
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(selected_ids.data<int64_t>()[i], expected_ids[i]);
+    EXPECT_EQ(selected_scores.data<float>()[i], expected_scores[i]);
+    EXPECT_EQ(parent_idx.data<int>()[i], expected_parent[i]);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(beam_search, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,190 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/beam_search_decode_compute.h"
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+using LoDTensorArray = std::vector<lite::Tensor>;
+
+// All the lod have 2 levels, the first is the source level and the second
+// is the sentence level.
+const size_t kSourceLevel = 0;
+const size_t kSentenceLevel = 1;
+
+struct Sentence {
+  std::vector<int64_t> word_ids;
+  std::vector<float> scores;
+};
+
+using SentenceVector = std::vector<Sentence>;
+
+// Gathers the hypotheses of the source src_idx by backtracing through the
+// steps, the prefix tree of one source never refers to another source, so
+// the sources are decoded independently.
+static void BacktraceSource(const LoDTensorArray& step_ids,
+                            const LoDTensorArray& step_scores,
+                            size_t src_idx,
+                            size_t beam_size,
+                            int end_id,
+                            SentenceVector* sentence_vector) {
+  sentence_vector->assign(beam_size, Sentence());
+  std::vector<size_t> prefix_idx_vector;
+  for (int step_id = static_cast<int>(step_ids.size()) - 1; step_id >= 0;
+       --step_id) {
+    const auto& cur_ids = step_ids[step_id];
+    const int64_t* ids_data = cur_ids.data<int64_t>();
+    const float* scores_data = step_scores[step_id].data<float>();
+    const auto& source_lod = cur_ids.lod()[kSourceLevel];
+    const auto& sentence_lod = cur_ids.lod()[kSentenceLevel];
+    size_t src_prefix_start = source_lod[src_idx];
+    size_t src_prefix_end = source_lod[src_idx + 1];
+    if (prefix_idx_vector.empty()) {
+      // Finished and pruned at this step, or the last time step.
+      for (size_t prefix_idx = src_prefix_start; prefix_idx < src_prefix_end;
+           ++prefix_idx) {
+        for (size_t candidate_idx = sentence_lod[prefix_idx];
+             candidate_idx < sentence_lod[prefix_idx + 1];
+             ++candidate_idx) {
+          prefix_idx_vector.push_back(prefix_idx);
+          auto& sentence = sentence_vector->at(prefix_idx_vector.size() - 1);
+          sentence.word_ids.push_back(ids_data[candidate_idx]);
+          sentence.scores.push_back(scores_data[candidate_idx]);
+        }
+      }
+    } else {
+      // Use prefix_idx_vector to backtrace.
+      size_t src_candidate_start = sentence_lod[src_prefix_start];
+      size_t prefix_idx = src_prefix_start;
+      size_t candidate_num =
+          sentence_lod[prefix_idx + 1] - sentence_lod[prefix_idx];
+      for (size_t idx = 0; idx < prefix_idx_vector.size(); ++idx) {
+        size_t candidate_idx = prefix_idx_vector[idx];
+        int64_t cur_id = ids_data[candidate_idx];
+        auto& sentence = sentence_vector->at(idx);
+        // Skip the redundant end tokens.
+        if (cur_id != end_id || sentence.word_ids.empty()) {
+          sentence.word_ids.push_back(cur_id);
+          sentence.scores.push_back(scores_data[candidate_idx]);
+        }
+        // Search the corresponding prefix.
+        while (src_candidate_start + candidate_num <= candidate_idx) {
+          prefix_idx++;
+          candidate_num +=
+              sentence_lod[prefix_idx + 1] - sentence_lod[prefix_idx];
+        }
+        prefix_idx_vector[idx] = prefix_idx;
+      }
+    }
+  }
+  // The words were gathered backward, so the first score is the final one.
+  std::sort(sentence_vector->begin(),
+            sentence_vector->end(),
+            [](const Sentence& a, const Sentence& b) {
+              return a.scores.front() > b.scores.front();
+            });
+}
+
+void BeamSearchDecodeCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const LoDTensorArray& step_ids = *param.ids;
+  const LoDTensorArray& step_scores = *param.scores;
+
+  const size_t step_num = step_ids.size();
+  CHECK_GT(step_num, 0UL) << "beam search steps should be larger than 0";
+  CHECK_EQ(step_num, step_scores.size())
+      << "step_ids and step_scores should be the same";
+  const size_t src_num = step_ids[0].lod().at(kSourceLevel).size() - 1;
+  CHECK_GT(src_num, 0UL) << "source num should be larger than 0";
+  for (size_t i = 0; i < step_num; ++i) {
+    CHECK_EQ(step_ids[i].lod().size(), 2UL) << "Level of LodTensor should be 2";
+  }
+
+  std::vector<SentenceVector> sentence_vector_list(src_num);
+  size_t beam_size = param.beam_size;
+  int end_id = param.end_id;
+  lite::x86::RunParallelFor(0, src_num, [&](int64_t begin, int64_t end) {
+    for (int64_t src_idx = begin; src_idx < end; ++src_idx) {
+      BacktraceSource(step_ids,
+                      step_scores,
+                      src_idx,
+                      beam_size,
+                      end_id,
+                      &sentence_vector_list[src_idx]);
+    }
+  });
+
+  // Merge the sources in order, the words of each sentence are reversed
+  // back to the decoding order.
+  LoD lod(2, std::vector<uint64_t>(1, 0));
+  size_t word_num = 0;
+  for (const auto& sentence_vector : sentence_vector_list) {
+    for (const auto& sentence : sentence_vector) {
+      word_num += sentence.word_ids.size();
+      lod[kSentenceLevel].push_back(word_num);
+    }
+    lod[kSourceLevel].push_back(lod[kSourceLevel].back() +
+                                sentence_vector.size());
+  }
+
+  auto* id_tensor = param.sentence_ids;
+  auto* score_tensor = param.sentence_scores;
+  *id_tensor->mutable_lod() = lod;
+  *score_tensor->mutable_lod() = lod;
+  id_tensor->Resize({static_cast<int64_t>(word_num)});
+  score_tensor->Resize({static_cast<int64_t>(word_num)});
+  int64_t* id_ptr = id_tensor->mutable_data<int64_t>();
+  float* score_ptr = score_tensor->mutable_data<float>();
+  for (const auto& sentence_vector : sentence_vector_list) {
+    for (const auto& sentence : sentence_vector) {
+      id_ptr = std::copy(
+          sentence.word_ids.rbegin(), sentence.word_ids.rend(), id_ptr);
+      score_ptr = std::copy(
+          sentence.scores.rbegin(), sentence.scores.rend(), score_ptr);
+    }
+  }
+
+  // When decode finish, we clear ids and scores.
+  param.ids->clear();
+  param.scores->clear();
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(beam_search_decode,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::BeamSearchDecodeCompute,
+                     def)
+    .BindInput("Ids",
+               {LiteType::GetTensorListTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindInput("Scores",
+               {LiteType::GetTensorListTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindOutput("SentenceIds",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindOutput("SentenceScores",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
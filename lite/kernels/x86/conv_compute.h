@@ -72,7 +72,7 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     lite::Tensor col_matrix;
     if (is_expand) {
       col.Resize(col_shape);
-      col.mutable_data<T>();
+      context.AllocWorkspace<T>(&col);
       col_matrix.ShareDataWith(col);
       col_matrix.Resize(col_matrix_shape);
     }
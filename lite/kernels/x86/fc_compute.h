@@ -43,7 +43,8 @@ class FCFunctor {
                   T* Y,
                   const T* B = nullptr,
                   bool relu = false,
-                  bool padding_weights = false) {
+                  bool padding_weights = false,
+                  bool gelu = false) {
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     T* Y1_data = nullptr;
 
@@ -53,11 +54,24 @@ class FCFunctor {
                   .At(N)
             : jit::KernelFuncs<jit::VAddTuple<T>, fluid::CPUPlace>::Cache().At(
                   N);
+    auto act =
+        gelu ? jit::KernelFuncs<jit::VGeluTuple<T>, fluid::CPUPlace>::Cache()
+                   .At(N)
+             : nullptr;
+    // Bias and gelu are applied row by row right after each other, so the
+    // activation reads the row while it is still in cache.
     auto parallel_compute = [&](int64_t begin, int64_t end) {
       for (int64_t i = begin; i < end; i++) {
         T* dst = Y + i * N;
         T* src = Y1_data ? Y1_data + i * (N + 4) : dst;
-        compute(B, src, dst, N);
+        if (B) {
+          compute(B, src, dst, N);
+        } else if (src != dst) {
+          memcpy(dst, src, N * sizeof(T));
+        }
+        if (act) {
+          act(dst, dst, N);
+        }
       }
     };
 
@@ -67,15 +81,8 @@ class FCFunctor {
       const int NN = N + 4;
       const int KK = K + 4;
 
-      // NOTE: here need to mutable_data for temporary Tensor X1 and Y1,
-      //  the overhead is unmeasured.
-      lite::Tensor X1;
-      X1.Resize(std::vector<int64_t>{M * KK});
-      T* X1_data = X1.mutable_data<T>();
-
-      lite::Tensor Y1;
-      Y1.Resize(std::vector<int64_t>{M * NN});
-      Y1_data = Y1.mutable_data<T>();
+      T* X1_data = context.AllocWorkspace<T>(M * KK);
+      Y1_data = context.AllocWorkspace<T>(M * NN);
 
       auto parallel_memcpy_x = [&](int64_t begin, int64_t end) {
         for (int64_t i = begin; i < end; i++) {
@@ -98,20 +105,10 @@ class FCFunctor {
                 Y1_data,
                 NN);
 
-      if (!B) {
-        auto parallel_memcpy_y = [&](int64_t begin, int64_t end) {
-          for (int64_t i = begin; i < end; i++) {
-            memcpy(Y + i * N, Y1_data + i * NN, N * sizeof(T));
-          }
-        };
-        lite::x86::RunParallelFor(0, M, parallel_memcpy_y);
-        return;
-      }
-
       lite::x86::RunParallelFor(0, M, parallel_compute);
     } else {
       blas.MatMul(M, N, K, X, W, Y);
-      if (!B) {
+      if (!B && !act) {
         return;
       }
 
@@ -132,6 +129,7 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* bias = param.bias;
     auto* output = param.output;
     bool with_relu = (param.activation_type == "relu") ? true : false;
+    bool with_gelu = (param.activation_type == "gelu") ? true : false;
 
     bool padding_weights = param.padding_weights;
     const auto& w_dims = w->dims();
@@ -155,7 +153,8 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
        output_data,
        bias ? bias->template data<T>() : NULL,
        with_relu,
-       padding_weights);
+       padding_weights,
+       with_gelu);
   }
 
   virtual ~FcCompute() = default;
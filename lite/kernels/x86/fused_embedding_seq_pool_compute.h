@@ -0,0 +1,98 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+class FusedEmbeddingSeqPoolCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedEmbeddingSeqPoolParam;
+
+  void Run() override {
+    auto &param = *param_.get_mutable<operators::FusedEmbeddingSeqPoolParam>();
+    auto *table_t = param.W;
+    auto *ids_t = param.Ids;
+    auto *output_t = param.Out;
+    int64_t padding_idx = param.padding_idx;
+
+    const auto &lod = ids_t->lod()[0];
+    const int64_t *ids = ids_t->template data<int64_t>();
+    int64_t ids_numel = ids_t->numel();
+    int64_t row_number = table_t->dims()[0];
+    int64_t row_width = table_t->dims()[1];
+    // The ids of a sequence are laid out as [seq_len, idx_width, 1].
+    int64_t idx_width = ids_t->dims()[0] > 0 ? ids_numel / ids_t->dims()[0] : 1;
+    int64_t out_width = row_width * idx_width;
+
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      if (padding_idx != -1 && ids[i] == padding_idx) continue;
+      CHECK_LT(ids[i], row_number);
+      CHECK_GE(ids[i], 0);
+    }
+
+    const T *table = table_t->template data<T>();
+    T *output = output_t->template mutable_data<T>();
+    int64_t batch = static_cast<int64_t>(lod.size()) - 1;
+    jit::emb_seq_pool_attr_t attr(
+        row_number, row_width, 1, idx_width, out_width, jit::SeqPoolType::kSum);
+    auto emb_seqpool =
+        jit::KernelFuncs<jit::EmbSeqPoolTuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    auto vadd =
+        jit::KernelFuncs<jit::VAddTuple<T>, fluid::CPUPlace>::Cache().At(
+            row_width);
+    for (int64_t i = 0; i < batch; ++i) {
+      T *out = output + i * out_width;
+      const int64_t *seq_ids = ids + lod[i] * idx_width;
+      attr.index_height = static_cast<int64_t>(lod[i + 1] - lod[i]);
+      if (attr.index_height == 0) {
+        // Same as the pad value of sequence_pool.
+        memset(out, 0, out_width * sizeof(T));
+      } else if (padding_idx == -1) {
+        emb_seqpool(table, seq_ids, out, &attr);
+      } else {
+        // The padding ids look up zeros, so they are skipped.
+        memset(out, 0, out_width * sizeof(T));
+        for (int64_t h = 0; h < attr.index_height; ++h) {
+          for (int64_t w = 0; w < idx_width; ++w) {
+            int64_t id = seq_ids[h * idx_width + w];
+            if (id == padding_idx) continue;
+            T *dst = out + w * row_width;
+            vadd(table + id * row_width, dst, dst, row_width);
+          }
+        }
+      }
+    }
+  }
+
+  virtual ~FusedEmbeddingSeqPoolCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,103 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void fused_embedding_seq_pool_ref(const lite::Tensor& w,
+                                  const lite::Tensor& ids,
+                                  int64_t padding_idx,
+                                  lite::Tensor* out) {
+  auto lod = ids.lod()[0];
+  int64_t emb_size = w.dims()[1];
+  const float* w_data = w.data<float>();
+  const int64_t* ids_data = ids.data<int64_t>();
+  float* out_data = out->mutable_data<float>();
+  for (size_t i = 0; i + 1 < lod.size(); i++) {
+    for (int64_t k = 0; k < emb_size; k++) {
+      out_data[i * emb_size + k] = 0.f;
+    }
+    for (uint64_t j = lod[i]; j < lod[i + 1]; j++) {
+      if (ids_data[j] == padding_idx) continue;
+      for (int64_t k = 0; k < emb_size; k++) {
+        out_data[i * emb_size + k] += w_data[ids_data[j] * emb_size + k];
+      }
+    }
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernels =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "fused_embedding_seq_pool");
+  ASSERT_FALSE(kernels.empty());
+  ASSERT_TRUE(kernels.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, compute) {
+  int vocab_size = 40;
+  std::vector<std::vector<uint64_t>> lod{{0, 3, 3, 10, 11}};
+  for (int emb_size : {16, 50}) {
+    for (int64_t padding_idx : {-1, 2}) {
+      FusedEmbeddingSeqPoolCompute<float> fused_embedding_seq_pool;
+      operators::FusedEmbeddingSeqPoolParam param;
+      lite::Tensor w, ids, out, out_ref;
+
+      int64_t ids_num = static_cast<int64_t>(lod[0].back());
+      int64_t batch = static_cast<int64_t>(lod[0].size()) - 1;
+      w.Resize({vocab_size, emb_size});
+      ids.Resize({ids_num, 1});
+      ids.set_lod(lod);
+      out.Resize({batch, emb_size});
+      out_ref.Resize({batch, emb_size});
+
+      auto* w_data = w.mutable_data<float>();
+      for (int i = 0; i < w.numel(); i++) {
+        w_data[i] = static_cast<float>(i % 17) * 0.1f - 0.8f;
+      }
+      auto* ids_data = ids.mutable_data<int64_t>();
+      for (int64_t i = 0; i < ids_num; i++) {
+        ids_data[i] = (i * 7) % vocab_size;
+      }
+
+      param.W = &w;
+      param.Ids = &ids;
+      param.Out = &out;
+      param.padding_idx = padding_idx;
+      fused_embedding_seq_pool.SetParam(param);
+      fused_embedding_seq_pool.Run();
+
+      fused_embedding_seq_pool_ref(w, ids, padding_idx, &out_ref);
+      auto* out_data = out.data<float>();
+      auto* out_ref_data = out_ref.data<float>();
+      for (int i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out_data[i], out_ref_data[i], 1e-5);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
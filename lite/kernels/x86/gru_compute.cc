@@ -13,13 +13,6 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/gru_compute.h"
-#include "lite/utils/env.h"
-
-// DEFINE_int32(paddle_num_threads,
-//              1,
-//              "Number of threads for each paddle instance.");
-int32_t paddle_num_threads =
-    paddle::lite::GetIntFromEnv("paddle_num_threads", 1);
 
 REGISTER_LITE_KERNEL(gru,
                      kX86,
@@ -13,22 +13,25 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/detail/gru_cpu_kernel.h"
 #include "lite/backends/x86/math/detail/gru_kernel.h"
 #include "lite/backends/x86/math/gru_compute.h"
 #include "lite/backends/x86/math/math_function.h"
+#include "lite/backends/x86/math/packed_gemm.h"
 #include "lite/backends/x86/math/sequence2batch.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
 #include "lite/fluid/eigen.h"
 
-// DECLARE_int32(paddle_num_threads);
-extern int32_t paddle_num_threads;
-
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -52,6 +55,38 @@ static inline int64_t CalculateSeqWidth(const DDim& dims) {
   return dims.count(1, dims.size());
 }
 
+// Copies the packed rows [begin, end) of one step back to their rows in the
+// sequences while they are still in cache.
+template <typename T>
+inline void ScatterRows(const T* src,
+                        const std::vector<uint64_t>& seq2batch_idx,
+                        int64_t begin,
+                        int64_t end,
+                        int64_t width,
+                        T* dst) {
+  for (int64_t i = begin; i < end; ++i) {
+    memcpy(dst + seq2batch_idx[i] * width,
+           src + (i - begin) * width,
+           width * sizeof(T));
+  }
+}
+
+// Runs fn on the rows [0, rows) of one step, in parallel when the step is
+// large enough.
+template <typename Func>
+inline void RunRows(int64_t rows, int64_t width, Func fn) {
+  auto run = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(i);
+    }
+  };
+  if (rows > 1 && rows * width >= (1 << 14)) {
+    lite::x86::RunParallelFor(0, rows, run);
+  } else {
+    run(0, rows);
+  }
+}
+
 template <typename T>
 class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -77,16 +112,31 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     T* batch_hidden_ptr = batch_hidden->template mutable_data<T>();
 
     auto* hidden = param.hidden;
-    hidden->template mutable_data<T>();
+    T* hidden_ptr = hidden->template mutable_data<T>();
 
     const auto& hidden_dims = hidden->dims();
 
-    lite::x86::math::LoDTensor2BatchFunctor<TARGET(kX86), T> to_batch;
-    to_batch(context, *input, batch_gate, true, is_reverse);
-
-    if (bias) {
-      lite::x86::math::RowwiseAdd<TARGET(kX86), T> add_bias;
-      add_bias(context, *batch_gate, *bias, batch_gate);
+    // Gather the input rows into the packed layout shared by the sequence
+    // kernels and add the bias in the same pass.
+    CHECK_EQ(input->lod().size(), 1UL) << "Only support one level sequence";
+    auto layout =
+        lite::x86::math::GetSeqPackedLayout(input->lod()[0], is_reverse);
+    batch_gate->set_lod(
+        {layout->batch_starts, layout->seq2batch_idx, layout->seq_order});
+    const auto& seq2batch_idx = layout->seq2batch_idx;
+    const T* input_data = input->template data<T>();
+    int64_t input_width = CalculateSeqWidth(input->dims());
+    const T* bias_data = bias ? bias->template data<T>() : nullptr;
+    for (size_t i = 0; i < seq2batch_idx.size(); ++i) {
+      const T* src = input_data + seq2batch_idx[i] * input_width;
+      T* dst = batch_gate_ptr + i * input_width;
+      if (bias_data) {
+        for (int64_t j = 0; j < input_width; ++j) {
+          dst[j] = src[j] + bias_data[j];
+        }
+      } else {
+        memcpy(dst, src, input_width * sizeof(T));
+      }
     }
 
     int frame_size = hidden_dims[1];
@@ -100,96 +150,104 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       // Since the batch computing for GRU reorders the input sequences
       // according to their length. The initialized cell state also needs
       // to reorder.
-      const std::vector<uint64_t>& order(batch_gate->lod()[2]);
-      ReorderInitState<T>(context, *h0, order, &ordered_h0, true);
+      ordered_h0.Resize(h0->dims());
+      context.AllocWorkspace<T>(&ordered_h0);
+      ReorderInitState<T>(context, *h0, layout->seq_order, &ordered_h0, true);
       gru_value.prev_out_value = ordered_h0.mutable_data<T>();
     } else {
       gru_value.prev_out_value = nullptr;
     }
 
-    const auto& batch_starts = batch_gate->lod()[0];
+    const auto& batch_starts = layout->batch_starts;
     size_t seq_len = batch_starts.size() - 1;
     int64_t batch_gate_width = CalculateSeqWidth(batch_gate->dims());
     int64_t batch_reset_hidden_prev_width =
         CalculateSeqWidth(batch_reset_hidden_prev->dims());
     int64_t batch_hidden_width = CalculateSeqWidth(batch_hidden->dims());
-    auto active_node =
-        lite::x86::math::detail::GetActivationType(param.activation);
-    auto active_gate =
-        lite::x86::math::detail::GetActivationType(param.gate_activation);
-
-#ifdef PADDLE_WITH_MKLML
-    // use MKL packed to speedup GEMM
-    if (paddle_num_threads >= 4) {
-      auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
-      T* packed_gate = blas.GEMM_ALLOC(CblasBMatrix,
-                                       1 /*height of C*/,
-                                       frame_size * 2 /*width of weight*/,
-                                       frame_size /*height of height*/);
-      CHECK(packed_gate);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size * 2,
-                     frame_size,
-                     T(1.0),
-                     gru_value.gate_weight,
-                     frame_size * 2,
-                     packed_gate);
-      T* packed_state = blas.GEMM_ALLOC(CblasBMatrix,
-                                        1 /*height of C*/,
-                                        frame_size /*width of weight*/,
-                                        frame_size /*height of height*/);
-      CHECK(packed_state);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size,
-                     frame_size,
-                     T(1.0),
-                     gru_value.state_weight,
-                     frame_size,
-                     packed_state);
+
+    if (!origin_mode) {
+      // The recurrent weights are packed once, the gate activations and the
+      // state update of every row run in the JIT kernels right after the
+      // GEMMs of the step.
+      if (!gate_weight_.packed()) {
+        gate_weight_.Pack(
+            context, gru_value.gate_weight, frame_size, frame_size * 2);
+        state_weight_.Pack(
+            context, gru_value.state_weight, frame_size, frame_size);
+      }
+      jit::gru_attr_t attr(frame_size,
+                           jit::to_kerneltype(param.gate_activation),
+                           jit::to_kerneltype(param.activation));
+      auto gru_h1 =
+          jit::KernelFuncs<jit::GRUH1Tuple<T>, fluid::CPUPlace>::Cache().At(
+              attr);
+      auto gru_ht_part1 = jit::KernelFuncs<jit::GRUHtPart1Tuple<T>,
+                                           fluid::CPUPlace>::Cache()
+                              .At(attr);
+      auto gru_ht_part2 = jit::KernelFuncs<jit::GRUHtPart2Tuple<T>,
+                                           fluid::CPUPlace>::Cache()
+                              .At(attr);
+      const T* prev = gru_value.prev_out_value;
       for (size_t n = 0; n < seq_len; n++) {
         int64_t bstart = static_cast<int64_t>(batch_starts[n]);
         int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
         int64_t cur_batch_size = bend - bstart;
+        T* gates = batch_gate_ptr + bstart * batch_gate_width;
+        T* reset = batch_reset_hidden_prev_ptr +
+                   bstart * batch_reset_hidden_prev_width;
+        T* out = batch_hidden_ptr + bstart * batch_hidden_width;
 
-        gru_value.output_value = batch_hidden_ptr + bstart * batch_hidden_width;
-        gru_value.gate_value = batch_gate_ptr + bstart * batch_gate_width;
-        gru_value.reset_output_value = batch_reset_hidden_prev_ptr +
-                                       bstart * batch_reset_hidden_prev_width;
-
-        if (gru_value.prev_out_value) {
-          blas.GEMM_COMPUTE(CblasNoTrans,
-                            CblasPacked,
-                            cur_batch_size,
-                            frame_size * 2,
-                            frame_size,
-                            gru_value.prev_out_value,
-                            frame_size,
-                            packed_gate,
-                            frame_size * 2,
-                            T(1),
-                            gru_value.gate_value,
-                            frame_size * 3);
+        if (prev) {
+          gate_weight_.Compute(context,
+                               cur_batch_size,
+                               prev,
+                               frame_size,
+                               gates,
+                               batch_gate_width);
+          RunRows(cur_batch_size, frame_size, [&](int64_t i) {
+            jit::gru_t step;
+            step.gates = gates + i * batch_gate_width;
+            step.ht_1 = prev + i * frame_size;
+            step.ht = reset + i * batch_reset_hidden_prev_width;
+            gru_ht_part1(&step, &attr);
+          });
+          state_weight_.Compute(context,
+                                cur_batch_size,
+                                reset,
+                                batch_reset_hidden_prev_width,
+                                gates + frame_size * 2,
+                                batch_gate_width);
+          RunRows(cur_batch_size, frame_size, [&](int64_t i) {
+            jit::gru_t step;
+            step.gates = gates + i * batch_gate_width;
+            step.ht_1 = prev + i * frame_size;
+            step.ht = out + i * batch_hidden_width;
+            gru_ht_part2(&step, &attr);
+          });
+        } else {
+          memset(reset,
+                 0,
+                 cur_batch_size * batch_reset_hidden_prev_width * sizeof(T));
+          RunRows(cur_batch_size, frame_size, [&](int64_t i) {
+            jit::gru_t step;
+            step.gates = gates + i * batch_gate_width;
+            step.ht = out + i * batch_hidden_width;
+            gru_h1(&step, &attr);
+          });
         }
-
-        lite::x86::math::detail::forward_final_output(
-            lite::x86::math::detail::forward::gru_finalOutput<T>(),
-            gru_value,
-            frame_size,
-            cur_batch_size,
-            active_node,
-            origin_mode);
-
-        gru_value.prev_out_value = gru_value.output_value;
+        prev = out;
+        ScatterRows(out,
+                    seq2batch_idx,
+                    bstart,
+                    bend,
+                    batch_hidden_width,
+                    hidden_ptr);
       }
-
-      blas.GEMM_FREE(packed_gate);
-      blas.GEMM_FREE(packed_state);
     } else {
-#endif
+      auto active_node =
+          lite::x86::math::detail::GetActivationType(param.activation);
+      auto active_gate =
+          lite::x86::math::detail::GetActivationType(param.gate_activation);
       for (size_t n = 0; n < seq_len; n++) {
         int64_t bstart = static_cast<int64_t>(batch_starts[n]);
         int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
@@ -210,14 +268,20 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
             origin_mode);
 
         gru_value.prev_out_value = gru_value.output_value;
+        ScatterRows(gru_value.output_value,
+                    seq2batch_idx,
+                    bstart,
+                    bend,
+                    batch_hidden_width,
+                    hidden_ptr);
       }
-#ifdef PADDLE_WITH_MKLML
     }
-#endif
-    lite::x86::math::Batch2LoDTensorFunctor<TARGET(kX86), T> to_seq;
     batch_hidden->set_lod(batch_gate->lod());
-    to_seq(context, *batch_hidden, hidden);
   }
+
+ private:
+  lite::x86::math::PackedGemmWeight<T> gate_weight_;
+  lite::x86::math::PackedGemmWeight<T> state_weight_;
 };
 
 }  // namespace x86
@@ -23,6 +23,7 @@ REGISTER_LITE_KERNEL(layer_norm,
     .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Residual", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Mean", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Variance", {LiteType::GetTensorTy(TARGET(kX86))})
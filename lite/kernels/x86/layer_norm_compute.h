@@ -14,13 +14,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
 #include "lite/backends/x86/jit/helper.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/type_system.h"
+#include "lite/kernels/x86/elementwise_compute.h"
 #include "lite/operators/layer_norm_op.h"
 
 namespace paddle {
@@ -28,6 +32,40 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
+// Whether `residual` can be added to `x` (elementwise_add with axis -1) one
+// normalized row at a time: either it has the layout of x, or it matches the
+// normalized trailing dims of x and is broadcast to every row.
+inline bool ResidualIsRowAligned(const lite::DDim& x_dims,
+                                 const lite::DDim& res_dims,
+                                 int begin_norm_axis,
+                                 bool* broadcast) {
+  if (res_dims == x_dims) {
+    *broadcast = false;
+    return true;
+  }
+  size_t lead = 0;
+  while (lead < res_dims.size() && res_dims[lead] == 1) {
+    ++lead;
+  }
+  const size_t rank = res_dims.size() - lead;
+  if (rank > x_dims.size() ||
+      x_dims.size() - rank < static_cast<size_t>(begin_norm_axis)) {
+    return false;
+  }
+  for (size_t i = 0; i < rank; ++i) {
+    if (res_dims[lead + i] != x_dims[x_dims.size() - rank + i]) {
+      return false;
+    }
+  }
+  for (size_t i = begin_norm_axis; i < x_dims.size() - rank; ++i) {
+    if (x_dims[i] != 1) {
+      return false;
+    }
+  }
+  *broadcast = true;
+  return true;
+}
+
 template <typename T>
 class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -39,6 +77,7 @@ class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto Scale = param.Scale;
     auto Bias = param.Bias;
     auto x = param.X;
+    auto residual = param.Residual;
 
     auto y = param.Y;
     auto Mean = param.Mean;
@@ -47,42 +86,87 @@ class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
     auto x_dims = x->dims();
 
-    y->template mutable_data<T>();
-    Mean->template mutable_data<T>();
-    Var->template mutable_data<T>();
-
     auto matrix_dim = x_dims.Flatten2D(begin_norm_axis);
     int left = static_cast<int>(matrix_dim[0]);
     int right = static_cast<int>(matrix_dim[1]);
-    lite::DDim matrix_shape({left, right});
-
-    lite::Tensor in;
-    in.ShareDataWith(*x);
-    in.Resize(matrix_shape);
-    lite::Tensor out;
-    out.ShareDataWith(*y);
-    out.Resize(matrix_shape);
 
     PADDLE_ENFORCE_EQ(Mean->numel(), left);
     PADDLE_ENFORCE_EQ(Var->numel(), left);
     PADDLE_ENFORCE_EQ(Scale->numel(), right);
     PADDLE_ENFORCE_EQ(Bias->numel(), right);
 
+    const T *x_data = x->template data<T>();
+    const T *res_data = nullptr;
+    int64_t res_stride = right;
+    bool broadcast = false;
+    if (residual) {
+      if (ResidualIsRowAligned(
+              x_dims, residual->dims(), begin_norm_axis, &broadcast)) {
+        res_data = residual->template data<T>();
+        res_stride = broadcast ? 0 : right;
+      } else {
+        // Any other broadcast falls back to a separate add.
+        auto &context = ctx_->As<X86Context>();
+        sum_.Resize(x_dims);
+        sum_.template mutable_data<T>();
+        ElementwiseComputeEx<AddFunctor<T>, lite::TargetType::kX86, T>(
+            context, x, residual, -1, AddFunctor<T>(), &sum_);
+        x_data = sum_.template data<T>();
+      }
+    }
+
+    T *y_data = y->template mutable_data<T>();
+    T *mean_data = Mean->template mutable_data<T>();
+    T *var_data = Var->template mutable_data<T>();
+    const T *scale_data = Scale->template data<T>();
+    const T *bias_data = Bias->template data<T>();
+
     auto ker = paddle::lite::jit::KernelFuncs<jit::LayerNormTuple<T>,
                                               lite::fluid::CPUPlace>::Cache()
                    .At(right);
-    ker(in.mutable_data<T>(),
-        out.mutable_data<T>(),
-        Mean->template mutable_data<T>(),
-        Var->template mutable_data<T>(),
-        Scale->template data<T>(),
-        Bias->template data<T>(),
-        static_cast<int>(left),
-        epsilon,
-        right);
+    auto add = res_data
+                   ? jit::KernelFuncs<jit::VAddTuple<T>,
+                                      lite::fluid::CPUPlace>::Cache()
+                         .At(right)
+                   : nullptr;
+    // The residual add is done for a few rows at a time into a small buffer
+    // that stays in cache until the normalization reads it back.
+    const int64_t row_block = 8;
+    auto parallel_compute = [&](int64_t begin, int64_t end) {
+      std::vector<T> sum;
+      if (res_data) {
+        sum.resize(std::min(row_block, end - begin) * right);
+      }
+      for (int64_t i = begin; i < end; i += row_block) {
+        const int rows = static_cast<int>(std::min(row_block, end - i));
+        T *src = const_cast<T *>(x_data) + i * right;
+        if (res_data) {
+          for (int r = 0; r < rows; ++r) {
+            add(src + r * right,
+                res_data + (i + r) * res_stride,
+                sum.data() + r * right,
+                right);
+          }
+          src = sum.data();
+        }
+        ker(src,
+            y_data + i * right,
+            mean_data + i,
+            var_data + i,
+            scale_data,
+            bias_data,
+            rows,
+            epsilon,
+            right);
+      }
+    };
+    lite::x86::RunParallelFor(0, left, parallel_compute);
   }
 
   virtual ~LayerNormCompute() = default;
+
+ private:
+  lite::Tensor sum_;
 };
 
 }  // namespace x86
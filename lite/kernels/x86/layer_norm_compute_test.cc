@@ -160,6 +160,89 @@ TEST(layer_norm_x86, run_test) {
   LOG(INFO) << *var_data;
 }
 
+TEST(layer_norm_x86, run_residual_test) {
+  std::vector<int64_t> x_shape({4, 3, 20});
+  int begin_norm_axis = 2;
+  float epsilon = 1e-5;
+  // same shape, row broadcast and a broadcast that needs the fallback add
+  std::vector<std::vector<int64_t>> res_shapes{{4, 3, 20}, {1, 20}, {3, 1}};
+  for (auto& res_shape : res_shapes) {
+    lite::Tensor x, residual, sum, Scale, Bias;
+    lite::Tensor out, Mean, Var, ref_out, ref_mean, ref_var;
+    x.Resize(x_shape);
+    sum.Resize(x_shape);
+    out.Resize(x_shape);
+    ref_out.Resize(x_shape);
+    residual.Resize(res_shape);
+    Scale.Resize({20});
+    Bias.Resize({20});
+    Mean.Resize({12});
+    Var.Resize({12});
+    ref_mean.Resize({12});
+    ref_var.Resize({12});
+
+    auto x_data = x.mutable_data<float>();
+    auto res_data = residual.mutable_data<float>();
+    auto sum_data = sum.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      x_data[i] = static_cast<float>((i * 7) % 11) * 0.3f - 1.f;
+    }
+    for (int64_t i = 0; i < residual.numel(); ++i) {
+      res_data[i] = static_cast<float>((i * 5) % 13) * 0.2f - 1.f;
+    }
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      int64_t j = i;
+      if (res_shape.size() == 2 && res_shape[0] == 1) {
+        j = i % 20;
+      } else if (res_shape.size() == 2) {
+        j = (i / 20) % 3;
+      }
+      sum_data[i] = x_data[i] + res_data[j];
+    }
+    auto scale_data = Scale.mutable_data<float>();
+    auto bias_data = Bias.mutable_data<float>();
+    for (int i = 0; i < 20; ++i) {
+      scale_data[i] = 0.5f + 0.1f * i;
+      bias_data[i] = 0.25f - 0.05f * i;
+    }
+
+    LayerNormCompute<float> layer_norm;
+    operators::LayerNormParam param;
+    param.X = &x;
+    param.Residual = &residual;
+    param.Y = &out;
+    param.Scale = &Scale;
+    param.Bias = &Bias;
+    param.Mean = &Mean;
+    param.Variance = &Var;
+    param.begin_norm_axis = begin_norm_axis;
+    param.epsilon = epsilon;
+
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    layer_norm.SetContext(std::move(ctx));
+    layer_norm.SetParam(param);
+    layer_norm.Run();
+
+    std::vector<float> ref_data = ref(&sum,
+                                      &Scale,
+                                      &Bias,
+                                      &ref_out,
+                                      &ref_mean,
+                                      &ref_var,
+                                      begin_norm_axis,
+                                      epsilon);
+    auto out_data = out.data<float>();
+    for (int j = 0; j < out.dims().production(); ++j) {
+      EXPECT_NEAR(out_data[j], ref_data[j], 1e-5);
+    }
+    for (int j = 0; j < 12; ++j) {
+      EXPECT_NEAR(Mean.data<float>()[j], ref_mean.data<float>()[j], 1e-5);
+      EXPECT_NEAR(Var.data<float>()[j], ref_var.data<float>()[j], 1e-5);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
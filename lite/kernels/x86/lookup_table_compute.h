@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/fluid/eigen.h"
@@ -23,6 +26,18 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
+// Fetch the row at `row` into the caches ahead of the copy.
+template <typename T>
+inline void PrefetchRow(const T *row, int64_t row_width) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char *begin = reinterpret_cast<const char *>(row);
+  const char *end = reinterpret_cast<const char *>(row + row_width);
+  for (const char *p = begin; p < end; p += 64) {
+    __builtin_prefetch(p, 0, 1);
+  }
+#endif
+}
+
 template <typename T>
 class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -40,23 +55,59 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t row_number = table_t->dims()[0];
     int64_t row_width = table_t->dims()[1];
 
+    // Check the bounds of all the ids at once, out of the copy loop.
+    int64_t min_id = 0;
+    int64_t max_id = 0;
+    if (padding_idx == -1) {
+      if (ids_numel > 0) min_id = max_id = ids[0];
+      for (int64_t i = 1; i < ids_numel; ++i) {
+        min_id = std::min(min_id, ids[i]);
+        max_id = std::max(max_id, ids[i]);
+      }
+    } else {
+      for (int64_t i = 0; i < ids_numel; ++i) {
+        int64_t id = ids[i] == padding_idx ? 0 : ids[i];
+        min_id = std::min(min_id, id);
+        max_id = std::max(max_id, id);
+      }
+    }
+    CHECK_GE(min_id, 0) << "lookup_table ids should be non-negative";
+    CHECK_LT(max_id, row_number) << "lookup_table ids exceed the table size";
+
     const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
-    memset(output, 0, output_t->dims().production() * sizeof(T));
-    for (int64_t i = 0; i < ids_numel; ++i) {
-      if (padding_idx != -1 && ids[i] == padding_idx) {
-        memset(output + i * row_width, 0, row_width * sizeof(T));
-      } else {
-        CHECK_LT(ids[i], row_number);
-        CHECK_GE(ids[i], 0);
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
+    // Every output row is written exactly once, so the output is not
+    // zeroed beforehand.
+    auto gather = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        if (i + kPrefetchDistance < end &&
+            ids[i + kPrefetchDistance] != padding_idx) {
+          PrefetchRow(table + ids[i + kPrefetchDistance] * row_width,
+                      row_width);
+        }
+        if (padding_idx != -1 && ids[i] == padding_idx) {
+          memset(output + i * row_width, 0, row_width * sizeof(T));
+        } else {
+          memcpy(output + i * row_width,
+                 table + ids[i] * row_width,
+                 row_width * sizeof(T));
+        }
       }
+    };
+    if (ids_numel * row_width >= kMinParallelSize) {
+      lite::x86::RunParallelFor(0, ids_numel, gather);
+    } else {
+      gather(0, ids_numel);
     }
   }
 
   virtual ~LookupTableCompute() = default;
+
+ private:
+  // The number of rows fetched ahead of the one being copied.
+  static constexpr int64_t kPrefetchDistance = 4;
+  // The minimum number of elements to gather with multiple threads.
+  static constexpr int64_t kMinParallelSize = 1 << 15;
 };
 
 }  // namespace x86
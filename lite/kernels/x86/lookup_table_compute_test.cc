@@ -74,6 +74,50 @@ TEST(lookup_table_x86, compute) {
   }
 }
 
+TEST(lookup_table_x86, compute_padding) {
+  LookupTableCompute<float> lookup_table;
+  operators::LookupTableParam param;
+  lite::Tensor w, ids, out;
+  int64_t padding_idx = 3;
+
+  int vocab_size = 64;
+  int emb_size = 128;
+  int ids_num = 1024;
+
+  w.Resize({vocab_size, emb_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+
+  auto* w_data = w.mutable_data<float>();
+  auto* ids_data = ids.mutable_data<int64_t>();
+  auto* out_data = out.mutable_data<float>();
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = static_cast<float>(i % 97) + 1.f;
+  }
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 13) % vocab_size;
+  }
+  // The output rows of the padding ids should be zeroed.
+  for (int i = 0; i < ids_num * emb_size; i++) {
+    out_data[i] = -1.f;
+  }
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+  for (int i = 0; i < ids_num; i++) {
+    for (int j = 0; j < emb_size; j++) {
+      float ref = ids_data[i] == padding_idx
+                      ? 0.f
+                      : w_data[ids_data[i] * emb_size + j];
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-5);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
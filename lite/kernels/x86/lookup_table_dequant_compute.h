@@ -0,0 +1,115 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/fluid/float16.h"
+#include "lite/kernels/x86/lookup_table_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The rows of W are [min, max, uint8 x width], dequantized as
+// min + q * (max - min) / 256.
+inline void DequantUint8Row(const float *row, int64_t width, float *out) {
+  float min = row[0];
+  float scale = (row[1] - min) / 256.f;
+  const uint8_t *codes = reinterpret_cast<const uint8_t *>(row + 2);
+  for (int64_t i = 0; i < width; ++i) {
+    out[i] = scale * static_cast<float>(codes[i]) + min;
+  }
+}
+
+// The rows of W are float16 x width.
+inline void DequantFP16Row(const float *row, int64_t width, float *out) {
+  const lite::fluid::float16 *values =
+      reinterpret_cast<const lite::fluid::float16 *>(row);
+  for (int64_t i = 0; i < width; ++i) {
+    out[i] = static_cast<float>(values[i]);
+  }
+}
+
+class LookupTableDequantCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::LookupTableDequantParam;
+
+  void Run() override {
+    auto &param = *param_.get_mutable<operators::LookupTableDequantParam>();
+    auto *ids_t = param.Ids;
+    auto *output_t = param.Out;
+    int64_t padding_idx = param.padding_idx;
+    const int64_t *ids = ids_t->data<int64_t>();
+    int64_t ids_numel = ids_t->numel();
+
+    auto *table_t = param.W;
+    int64_t row_number = table_t->dims()[0];
+    int64_t quant_number = table_t->dims()[1];
+    bool fp16 = param.quant_bits == 16;
+    int64_t row_width = fp16 ? quant_number * 2 : (quant_number - 2) * 4;
+    auto dequant = fp16 ? DequantFP16Row : DequantUint8Row;
+
+    int64_t min_id = 0;
+    int64_t max_id = 0;
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      int64_t id = padding_idx != -1 && ids[i] == padding_idx ? 0 : ids[i];
+      min_id = std::min(min_id, id);
+      max_id = std::max(max_id, id);
+    }
+    CHECK_GE(min_id, 0) << "lookup_table ids should be non-negative";
+    CHECK_LT(max_id, row_number) << "lookup_table ids exceed the table size";
+
+    const float *table = table_t->data<float>();
+    float *output = output_t->mutable_data<float>();
+    auto gather = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        if (i + kPrefetchDistance < end &&
+            ids[i + kPrefetchDistance] != padding_idx) {
+          PrefetchRow(table + ids[i + kPrefetchDistance] * quant_number,
+                      quant_number);
+        }
+        if (padding_idx != -1 && ids[i] == padding_idx) {
+          memset(output + i * row_width, 0, row_width * sizeof(float));
+        } else {
+          dequant(
+              table + ids[i] * quant_number, row_width, output + i * row_width);
+        }
+      }
+    };
+    if (ids_numel * row_width >= kMinParallelSize) {
+      lite::x86::RunParallelFor(0, ids_numel, gather);
+    } else {
+      gather(0, ids_numel);
+    }
+    *(output_t->mutable_lod()) = ids_t->lod();
+  }
+
+  virtual ~LookupTableDequantCompute() = default;
+
+ private:
+  static constexpr int64_t kPrefetchDistance = 4;
+  static constexpr int64_t kMinParallelSize = 1 << 15;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
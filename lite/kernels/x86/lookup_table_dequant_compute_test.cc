@@ -0,0 +1,126 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lookup_table_dequant_compute.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(lookup_table_dequant_x86, compute_uint8) {
+  LookupTableDequantCompute lookup_table;
+  operators::LookupTableDequantParam param;
+  lite::Tensor w, ids, out;
+  int64_t padding_idx = 5;
+
+  int vocab_size = 32;
+  int emb_size = 64;
+  int ids_num = 2048;
+
+  // Every row is [min, max, uint8 x emb_size].
+  int quant_size = 2 + emb_size / 4;
+  w.Resize({vocab_size, quant_size});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+
+  auto* w_data = w.mutable_data<float>();
+  for (int i = 0; i < vocab_size; i++) {
+    float* row = w_data + i * quant_size;
+    row[0] = -1.f * i;
+    row[1] = 2.f * i;
+    auto* codes = reinterpret_cast<uint8_t*>(row + 2);
+    for (int j = 0; j < emb_size; j++) {
+      codes[j] = static_cast<uint8_t>((i * 7 + j * 3) % 256);
+    }
+  }
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 11) % vocab_size;
+  }
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  param.quant_bits = 8;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < ids_num; i++) {
+    int64_t id = ids_data[i];
+    for (int j = 0; j < emb_size; j++) {
+      float ref = 0.f;
+      if (id != padding_idx) {
+        float min = -1.f * id;
+        float max = 2.f * id;
+        ref = min + ((id * 7 + j * 3) % 256) * (max - min) / 256.f;
+      }
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-5);
+    }
+  }
+}
+
+TEST(lookup_table_dequant_x86, compute_fp16) {
+  LookupTableDequantCompute lookup_table;
+  operators::LookupTableDequantParam param;
+  lite::Tensor w, ids, out;
+
+  int vocab_size = 40;
+  int emb_size = 50;
+  int ids_num = 30;
+
+  // Every row is float16 x emb_size, packed into emb_size / 2 floats.
+  w.Resize({vocab_size, emb_size / 2});
+  ids.Resize({ids_num, 1});
+  out.Resize({ids_num, emb_size});
+
+  auto* w_data = reinterpret_cast<lite::fluid::float16*>(
+      w.mutable_data<float>());
+  for (int i = 0; i < vocab_size * emb_size; i++) {
+    w_data[i] = lite::fluid::float16(static_cast<float>(i % 100) / 8.f);
+  }
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < ids_num; i++) {
+    ids_data[i] = (i * 3) % vocab_size;
+  }
+
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = -1;
+  param.quant_bits = 16;
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < ids_num; i++) {
+    for (int j = 0; j < emb_size; j++) {
+      float ref =
+          static_cast<float>((ids_data[i] * emb_size + j) % 100) / 8.f;
+      EXPECT_NEAR(out_data[i * emb_size + j], ref, 1e-5);
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lookup_table_dequant, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,175 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/packed_gemm.h"
+#include "lite/backends/x86/math/sequence2batch.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/gru_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+class LstmCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::LstmParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::LstmParam>();
+    auto* input = param.Input;
+    auto* weight = param.Weight;
+    auto* bias = param.Bias;
+    auto* batch_gate = param.BatchGate;
+    auto* batch_cell_pre_act = param.BatchCellPreAct;
+
+    int frame_size = static_cast<int>(input->dims()[1] / 4);
+    int gate_width = frame_size * 4;
+    T* batch_gate_ptr = batch_gate->template mutable_data<T>();
+    T* cell_pre_act_ptr = batch_cell_pre_act->template mutable_data<T>();
+    T* hidden_ptr = param.Hidden->template mutable_data<T>();
+    T* cell_ptr = param.Cell->template mutable_data<T>();
+
+    // Gather the input rows into the packed layout shared by the sequence
+    // kernels and add the bias in the same pass.
+    CHECK_EQ(input->lod().size(), 1UL) << "Only support one level sequence";
+    auto layout =
+        lite::x86::math::GetSeqPackedLayout(input->lod()[0], param.is_reverse);
+    batch_gate->set_lod(
+        {layout->batch_starts, layout->seq2batch_idx, layout->seq_order});
+    const auto& seq2batch_idx = layout->seq2batch_idx;
+    const T* input_data = input->template data<T>();
+    const T* bias_data = bias->template data<T>();
+    for (size_t i = 0; i < seq2batch_idx.size(); ++i) {
+      const T* src = input_data + seq2batch_idx[i] * gate_width;
+      T* dst = batch_gate_ptr + i * gate_width;
+      for (int j = 0; j < gate_width; ++j) {
+        dst[j] = src[j] + bias_data[j];
+      }
+    }
+
+    // The hidden and the cell of every step in the packed layout.
+    int64_t total_rows = seq2batch_idx.size();
+    batch_hidden_.Resize({total_rows, frame_size});
+    batch_cell_.Resize({total_rows, frame_size});
+    T* batch_hidden_ptr = batch_hidden_.mutable_data<T>();
+    T* batch_cell_ptr = batch_cell_.mutable_data<T>();
+
+    // Since the batch computing for LSTM reorders the input sequences
+    // according to their length, the initial states also need to reorder.
+    Tensor ordered_h0, ordered_c0;
+    const T* prev_hidden = nullptr;
+    const T* prev_cell = nullptr;
+    if (param.H0) {
+      ReorderInitState<T>(
+          context, *param.H0, layout->seq_order, &ordered_h0, true);
+      prev_hidden = ordered_h0.data<T>();
+    }
+    if (param.C0) {
+      ReorderInitState<T>(
+          context, *param.C0, layout->seq_order, &ordered_c0, true);
+      prev_cell = ordered_c0.data<T>();
+    }
+
+    // The recurrent weight is packed once, the gate activations and the
+    // state update of every row run in the JIT kernels right after the
+    // GEMM of the step.
+    if (!weight_.packed()) {
+      weight_.Pack(context, weight->template data<T>(), frame_size, gate_width);
+    }
+    jit::lstm_attr_t attr(frame_size,
+                          jit::to_kerneltype(param.gate_activation),
+                          jit::to_kerneltype(param.candidate_activation),
+                          jit::to_kerneltype(param.cell_activation),
+                          param.use_peepholes);
+    auto lstm_ctht =
+        jit::KernelFuncs<jit::LSTMCtHtTuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    auto lstm_c1h1 =
+        jit::KernelFuncs<jit::LSTMC1H1Tuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    // The peephole weights W_ic, W_fc, W_oc follow the gate bias.
+    const T* peephole = param.use_peepholes ? bias_data + gate_width : nullptr;
+    std::vector<T> checked;
+    if (param.use_peepholes) {
+      checked.resize(layout->seq_order.size() * 2 * frame_size);
+    }
+
+    const auto& batch_starts = layout->batch_starts;
+    for (size_t n = 0; n + 1 < batch_starts.size(); n++) {
+      int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+      int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
+      int64_t cur_batch_size = bend - bstart;
+      T* gates = batch_gate_ptr + bstart * gate_width;
+      T* out = batch_hidden_ptr + bstart * frame_size;
+      T* cell = batch_cell_ptr + bstart * frame_size;
+      T* cell_pre_act = cell_pre_act_ptr + bstart * frame_size;
+
+      if (prev_hidden) {
+        weight_.Compute(context,
+                        cur_batch_size,
+                        prev_hidden,
+                        frame_size,
+                        gates,
+                        gate_width);
+      }
+      RunRows(cur_batch_size, frame_size, [&](int64_t i) {
+        jit::lstm_t step;
+        step.gates = gates + i * gate_width;
+        step.ct = cell + i * frame_size;
+        step.ht = out + i * frame_size;
+        step.wp = peephole;
+        step.checked = param.use_peepholes
+                           ? checked.data() + i * 2 * frame_size
+                           : nullptr;
+        if (prev_cell) {
+          step.ct_1 = prev_cell + i * frame_size;
+          lstm_ctht(&step, &attr);
+        } else {
+          lstm_c1h1(&step, &attr);
+        }
+        // The JIT kernels leave the activated cell in the forget gate.
+        memcpy(cell_pre_act + i * frame_size,
+               gates + i * gate_width + frame_size * 2,
+               frame_size * sizeof(T));
+      });
+      prev_hidden = out;
+      prev_cell = cell;
+      ScatterRows(out, seq2batch_idx, bstart, bend, frame_size, hidden_ptr);
+      ScatterRows(cell, seq2batch_idx, bstart, bend, frame_size, cell_ptr);
+    }
+  }
+
+  virtual ~LstmCompute() = default;
+
+ private:
+  lite::x86::math::PackedGemmWeight<T> weight_;
+  Tensor batch_hidden_;
+  Tensor batch_cell_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
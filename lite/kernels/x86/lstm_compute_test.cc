@@ -0,0 +1,180 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lstm_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// Runs every sequence step by step, gates: {c, i, f, o}.
+static void LstmRef(const std::vector<float>& input,
+                    const std::vector<uint64_t>& lod,
+                    const std::vector<float>& weight,
+                    const std::vector<float>& bias,
+                    const std::vector<float>& h0,
+                    const std::vector<float>& c0,
+                    int d,
+                    bool use_peepholes,
+                    bool is_reverse,
+                    std::vector<float>* hidden,
+                    std::vector<float>* cell) {
+  hidden->resize(lod.back() * d);
+  cell->resize(lod.back() * d);
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    std::vector<float> h(d, 0.f), c(d, 0.f);
+    if (!h0.empty()) h.assign(h0.begin() + s * d, h0.begin() + (s + 1) * d);
+    if (!c0.empty()) c.assign(c0.begin() + s * d, c0.begin() + (s + 1) * d);
+    int len = lod[s + 1] - lod[s];
+    for (int t = 0; t < len; t++) {
+      int row = is_reverse ? lod[s + 1] - 1 - t : lod[s] + t;
+      std::vector<float> g(4 * d);
+      for (int j = 0; j < 4 * d; j++) {
+        g[j] = input[row * 4 * d + j] + bias[j];
+        for (int k = 0; k < d; k++) {
+          g[j] += h[k] * weight[k * 4 * d + j];
+        }
+      }
+      for (int j = 0; j < d; j++) {
+        float ig = g[d + j];
+        float fg = g[2 * d + j];
+        if (use_peepholes) {
+          ig += bias[4 * d + j] * c[j];
+          fg += bias[5 * d + j] * c[j];
+        }
+        float new_c = std::tanh(g[j]) * Sigmoid(ig) + c[j] * Sigmoid(fg);
+        float og = g[3 * d + j];
+        if (use_peepholes) og += bias[6 * d + j] * new_c;
+        c[j] = new_c;
+        h[j] = std::tanh(new_c) * Sigmoid(og);
+      }
+      for (int j = 0; j < d; j++) {
+        (*hidden)[row * d + j] = h[j];
+        (*cell)[row * d + j] = c[j];
+      }
+    }
+  }
+}
+
+static void Fill(std::vector<float>* v, int n, int seed) {
+  v->resize(n);
+  for (int i = 0; i < n; i++) {
+    (*v)[i] = static_cast<float>((i * 37 + seed * 11) % 23 - 11) / 23.f;
+  }
+}
+
+TEST(lstm_x86, retrive_op) {
+  auto kernel =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>("lstm");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(lstm_x86, run_test) {
+  std::vector<uint64_t> lod{0, 3, 4, 9, 11};
+  int d = 8;
+  int rows = lod.back();
+  int batch = lod.size() - 1;
+  for (bool use_peepholes : {false, true}) {
+    for (bool is_reverse : {false, true}) {
+      for (bool with_init : {false, true}) {
+        std::vector<float> input_v, weight_v, bias_v, h0_v, c0_v;
+        Fill(&input_v, rows * 4 * d, 1);
+        Fill(&weight_v, d * 4 * d, 2);
+        Fill(&bias_v, (use_peepholes ? 7 : 4) * d, 3);
+        if (with_init) {
+          Fill(&h0_v, batch * d, 4);
+          Fill(&c0_v, batch * d, 5);
+        }
+        std::vector<float> hidden_ref, cell_ref;
+        LstmRef(input_v,
+                lod,
+                weight_v,
+                bias_v,
+                h0_v,
+                c0_v,
+                d,
+                use_peepholes,
+                is_reverse,
+                &hidden_ref,
+                &cell_ref);
+
+        lite::Tensor input, weight, bias, h0, c0;
+        lite::Tensor hidden, cell, batch_gate, batch_cell_pre_act;
+        auto set = [](lite::Tensor* t, DDim dims, const std::vector<float>& v) {
+          t->Resize(dims);
+          std::copy(v.begin(), v.end(), t->mutable_data<float>());
+        };
+        set(&input, DDim({rows, 4 * d}), input_v);
+        input.set_lod({lod});
+        set(&weight, DDim({d, 4 * d}), weight_v);
+        set(&bias, DDim({1, static_cast<int64_t>(bias_v.size())}), bias_v);
+        hidden.Resize({rows, d});
+        cell.Resize({rows, d});
+        batch_gate.Resize({rows, 4 * d});
+        batch_cell_pre_act.Resize({rows, d});
+
+        operators::LstmParam param;
+        param.Input = &input;
+        param.Weight = &weight;
+        param.Bias = &bias;
+        if (with_init) {
+          set(&h0, DDim({batch, d}), h0_v);
+          set(&c0, DDim({batch, d}), c0_v);
+          param.H0 = &h0;
+          param.C0 = &c0;
+        }
+        param.Hidden = &hidden;
+        param.Cell = &cell;
+        param.BatchGate = &batch_gate;
+        param.BatchCellPreAct = &batch_cell_pre_act;
+        param.use_peepholes = use_peepholes;
+        param.is_reverse = is_reverse;
+        param.gate_activation = "sigmoid";
+        param.cell_activation = "tanh";
+        param.candidate_activation = "tanh";
+
+        LstmCompute<float> lstm;
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        lstm.SetContext(std::move(ctx));
+        lstm.SetParam(param);
+        lstm.Run();
+
+        auto* hidden_data = hidden.data<float>();
+        auto* cell_data = cell.data<float>();
+        for (int i = 0; i < rows * d; i++) {
+          EXPECT_NEAR(hidden_data[i], hidden_ref[i], 1e-5);
+          EXPECT_NEAR(cell_data[i], cell_ref[i], 1e-5);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lstm, kX86, kFloat, kNCHW, def);
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/match_matrix_tensor_compute.h"
+#include <cstring>
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -50,8 +52,6 @@ void MatchMatrixTensorCompute<T>::Run() {
   auto* t_data = w->template data<T>();
   auto* out_data = out->template mutable_data<T>();
   auto* bottom_l_trans_data = tmp->template mutable_data<T>();
-  memset(out_data, 0.0, out->dims()[0] * out->dims()[1] * sizeof(T));
-  memset(bottom_l_trans_data, 0.0, tmp->dims()[0] * tmp->dims()[1] * sizeof(T));
 
   auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
   blas.GEMM(CblasNoTrans,
@@ -68,52 +68,44 @@ void MatchMatrixTensorCompute<T>::Run() {
             bottom_l_trans_data,
             dim_t * dim_in);
 
-  for (size_t b = 0; b < x->lod()[0].size() - 1; b++) {
-    for (int t = 0; t < dim_t; t++) {
+  // The dim_t products of a sequence share the right matrix, and the rows of
+  // the left ones are interleaved in bottom_l_trans, so one GEMM computes
+  // them all in [len_l, dim_t, len_r] order. The sequences run in parallel
+  // and every one is reordered into [dim_t, len_l, len_r] for the output.
+  interleaved_.resize(top_size);
+  T* interleaved_data = interleaved_.data();
+  int batch_size = x->lod()[0].size() - 1;
+  lite::x86::RunParallelFor(0, batch_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
       int len_l = offset_l[b + 1] - offset_l[b];
       int len_r = offset_r[b + 1] - offset_r[b];
-      auto* top_data = out_data + top_offset[b] + t * len_l * len_r;
-      const auto* l_t_data =
-          bottom_l_trans_data + offset_l[b] * dim_t * dim_in + t * dim_in;
+      if (len_l == 0 || len_r == 0) continue;
+      const auto* l_t_data = bottom_l_trans_data + offset_l[b] * dim_t * dim_in;
       const auto* r_data = bottom_r_data + offset_r[b] * dim_in;
-
-      auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+      auto* products = interleaved_data + top_offset[b];
       blas.GEMM(CblasNoTrans,
                 CblasTrans,
-                len_l,
+                len_l * dim_t,
                 len_r,
                 dim_in,
                 1.0f,
                 l_t_data,
-                dim_t * dim_in,
+                dim_in,
                 r_data,
                 dim_in,
                 0.0f,
-                top_data,
+                products,
                 len_r);
-    }
-  }
-
-  int batch_size = x->lod()[0].size() - 1;
-  int lod_lv1_size = batch_size * dim_t;
-  int lod_lv2_size = x->lod()[0].back() * dim_t;
-  std::vector<uint64_t> out_lod0(batch_size + 1, 0);
-  std::vector<uint64_t> out_lod1(lod_lv1_size + 1, 0);
-  std::vector<uint64_t> out_lod2(lod_lv2_size + 1, 0);
-  for (int i = 0; i < batch_size; i++) {
-    out_lod0[i + 1] = out_lod0[i] + dim_t;
-    int len_l = offset_l[i + 1] - offset_l[i];
-
-    for (int j = 0; j < dim_t; j++) {
-      out_lod1[i * dim_t + j + 1] = out_lod1[i * dim_t + j] + len_l;
-      int len_r = offset_r[i + 1] - offset_r[i];
-
-      for (int k = 0; k < len_l; k++) {
-        out_lod2[offset_l[i] * dim_t + j * len_l + k + 1] =
-            out_lod2[offset_l[i] * dim_t + j * len_l + k] + len_r;
+      auto* top_data = out_data + top_offset[b];
+      for (int t = 0; t < dim_t; t++) {
+        for (int i = 0; i < len_l; i++) {
+          std::memcpy(top_data + (t * len_l + i) * len_r,
+                      products + (i * dim_t + t) * len_r,
+                      len_r * sizeof(T));
+        }
       }
     }
-  }
+  });
 
   LoD out_lod;
   out_lod.push_back(top_offset);
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <algorithm>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
@@ -34,6 +35,11 @@ class MatchMatrixTensorCompute
   void Run() override;
 
   virtual ~MatchMatrixTensorCompute() = default;
+
+ private:
+  // The products of every sequence in [len_l, dim_t, len_r] order, kept
+  // between runs.
+  std::vector<T> interleaved_;
 };
 
 }  // namespace x86
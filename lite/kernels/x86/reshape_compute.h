@@ -27,11 +27,15 @@ namespace kernels {
 namespace x86 {
 
 template <typename T>
-void Compute(const lite::Tensor* in, lite::Tensor* out) {
-  // In CopyDataFrom, the target tensor's dims will be set to the source
-  // tensor's dims.
+void Compute(const lite::Tensor* in, lite::Tensor* out, bool inplace = false) {
+  // In ShareDataWith and CopyDataFrom, the target tensor's dims will be set
+  // to the source tensor's dims.
   auto out_dims = out->dims();
-  out->CopyDataFrom(*in);
+  if (inplace) {
+    out->ShareDataWith(*in);
+  } else {
+    out->CopyDataFrom(*in);
+  }
   out->Resize(out_dims);
 }
 
@@ -42,7 +46,7 @@ class ReshapeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    Compute<T>(param.x, param.output);
+    Compute<T>(param.x, param.output, param.inplace);
   }
 
   virtual ~ReshapeCompute() = default;
@@ -58,7 +62,7 @@ class Reshape2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    Compute<T>(param.x, param.output);
+    Compute<T>(param.x, param.output, param.inplace);
   }
 
   virtual ~Reshape2Compute() = default;
@@ -84,6 +84,32 @@ TEST(reshape_x86, run_test) {
   }
 }
 
+TEST(reshape_x86, run_inplace_test) {
+  lite::Tensor x, out;
+  x.Resize(lite::DDim(std::vector<int64_t>({2, 3, 4})));
+  out.Resize(lite::DDim(std::vector<int64_t>({6, 4})));
+  auto x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.dims().production(); ++i) {
+    x_data[i] = static_cast<float>(i);
+  }
+
+  ReshapeCompute<float> reshape;
+  operators::ReshapeParam param;
+  param.x = &x;
+  param.output = &out;
+  param.shape_vct = {6, 4};
+  param.inplace = true;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  reshape.SetContext(std::move(ctx));
+  reshape.SetParam(param);
+  reshape.Run();
+
+  // The output only changes the shape and shares the buffer of the input.
+  EXPECT_EQ(out.dims(), lite::DDim(std::vector<int64_t>({6, 4})));
+  EXPECT_EQ(out.data<float>(), x.data<float>());
+}
+
 // reshape2
 TEST(reshape2_x86, retrive_op) {
   auto reshape2 =
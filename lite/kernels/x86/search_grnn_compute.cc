@@ -16,6 +16,8 @@
 #include <algorithm>
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/sequence2batch.h"
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -44,119 +46,6 @@ void CallGemm(const lite::x86::math::BlasT<TARGET(kX86), T>& blas,
   blas.GEMM(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N);
 }
 
-template <typename T>
-void SearchGrnnCompute<T>::PrepareLayout(const Tensor* input_blob) {
-  auto& param = this->Param<param_t>();
-  auto* _idx_sorted_by_width = param.idx_sorted_by_width;
-  auto* _layout_input = param.layout_input;
-  auto* _input = input_blob;
-
-  // usually total length
-  int dim0 = _input->dims()[0];
-  // if it is id only sequence
-  int dim1 = 1;
-  // if its a embedding like sequence (dim1 would be embedding_size)
-  if (_input->dims().size() > 1) {
-    dim1 = _input->dims()[1];
-  }
-
-  int batch = _input->lod()[0].size() - 1;
-  auto& offset = _input->lod()[0];
-
-  Tensor _width;
-  _width.Resize({batch});
-  _idx_sorted_by_width->Resize({batch});
-  int* width_data = _width.template mutable_data<int>();
-  int* idx_sorted_by_width_data =
-      _idx_sorted_by_width->template mutable_data<int>();
-  // sort sequence by width (descending) and find the largest width in the
-  // batch
-  for (int i = 0; i < batch; i++) {
-    width_data[i] = offset[i + 1] - offset[i];
-    idx_sorted_by_width_data[i] = i;
-  }
-  std::sort(idx_sorted_by_width_data,
-            idx_sorted_by_width_data + batch,
-            [&_width](int a, int b) {
-              return _width.template data<int>()[a] >
-                     _width.template data<int>()[b];
-            });
-  int max_width = width_data[idx_sorted_by_width_data[0]];
-
-  // start of reorganizing the input
-  std::vector<uint64_t> new_offset;
-  new_offset.resize(max_width + 1);
-
-  new_offset[0] = 0;
-  int j = batch - 1;
-  int last_width = 0;
-  int sub_row = 0;
-  int sub_col = 0;
-
-  for (int i = 1; i <= max_width;) {
-    for (int k = j; k >= 0; --k) {
-      if (width_data[idx_sorted_by_width_data[k]] > last_width) {
-        sub_row = width_data[idx_sorted_by_width_data[k]] - last_width;
-        sub_col = k + 1;
-
-        for (int s = 0; s < sub_row; s++) {
-          new_offset[i] = new_offset[i - 1] + sub_col;
-          i++;
-        }
-        // move on
-        last_width = width_data[idx_sorted_by_width_data[k]];
-        j = k - 1;
-        break;
-      }
-    }
-  }
-
-  // copying to the reorganized buffer
-  if (_input->dims().size() == 1) {
-    // _layout_input.reshape_batch_sequence({dim0}, new_offset);
-    LOG(FATAL) << "_input->dims().size() = 1, error.";
-  } else {
-    // _layout_input.reshape_batch_sequence({dim0, dim1}, new_offset);
-    LoD new_lod;
-    new_lod.push_back(new_offset);
-    _layout_input->set_lod(new_lod);
-    _layout_input->Resize({dim0, dim1});
-  }
-
-  auto* new_emb = _layout_input->template mutable_data<T>();
-  for (int i = 0; i < max_width; i++) {
-    int w = new_offset[i + 1] - new_offset[i];
-    auto* emb_start = new_emb + dim1 * new_offset[i];
-    for (int j = 0; j < w; ++j) {
-      memcpy(emb_start + dim1 * j,
-             _input->template data<T>() +
-                 dim1 * offset[idx_sorted_by_width_data[j]] + dim1 * i,
-             dim1 * sizeof(T));
-    }
-  }
-}
-
-template <typename T>
-void SearchGrnnCompute<T>::CopyBack(T* from, T* to, int step) {
-  auto& param = this->Param<param_t>();
-  auto* _input = param.x;
-  auto* _layout_input = param.layout_input;
-  auto* _idx_sorted_by_width = param.idx_sorted_by_width;
-
-  const auto& offset = _input->lod()[0];
-  const auto& new_offset = _layout_input->lod()[0];
-  const auto* idx_sorted_by_width_data =
-      _idx_sorted_by_width->template data<int>();
-  for (size_t i = 0; i < _layout_input->lod()[0].size() - 1; ++i) {
-    int w = new_offset[i + 1] - new_offset[i];
-    for (int j = 0; j < w; j++) {
-      memcpy(to + step * (offset[idx_sorted_by_width_data[j]] + i),
-             from + (new_offset[i] + j) * step,
-             step * sizeof(T));
-    }
-  }
-}
-
 template <typename T>
 void SearchGrnnCompute<T>::Run() {
   auto& context = ctx_->As<X86Context>();
@@ -183,30 +72,39 @@ void SearchGrnnCompute<T>::Run() {
   const auto* dense_e2h = wi->template data<T>();
   const auto* dense_h2h = wh->template data<T>();
 
-  const auto* e2h = dense_e2h;
-  const auto* e2hr = dense_e2h + 1 * _cap_e * _cap_h;
-  const auto* e2hz = dense_e2h + 2 * _cap_e * _cap_h;
-  const auto* h2h = dense_h2h;
-  const auto* h2hr = dense_h2h + 1 * _cap_h * _cap_h;
-  const auto* h2hz = dense_h2h + 2 * _cap_h * _cap_h;
-
-  PrepareLayout(bottom);
-
+  // The recurrence runs on the packed layout shared by the sequence kernels,
+  // the input projections are computed in the original order and read
+  // through the layout index, and the hidden of every step is written back
+  // to the output directly.
+  auto layout = lite::x86::math::GetSeqPackedLayout(offset, false);
+  const auto& new_offset = layout->batch_starts;
+  const auto& seq2batch_idx = layout->seq2batch_idx;
+  int max_width = new_offset.size() - 1;
+
+  // The layout is kept in the outputs for compatibility, the reordered input
+  // is not materialized.
+  auto* _idx_sorted_by_width = param.idx_sorted_by_width;
+  _idx_sorted_by_width->Resize({batch});
+  auto* idx_sorted_by_width_data =
+      _idx_sorted_by_width->template mutable_data<int>();
+  for (int i = 0; i < batch; i++) {
+    idx_sorted_by_width_data[i] = layout->seq_order[i];
+  }
   auto* _layout_input = param.layout_input;
-  auto* new_emb = _layout_input->template mutable_data<T>();
-  const auto& new_offset = _layout_input->lod()[0];
-  int max_width = _layout_input->lod()[0].size() - 1;
+  _layout_input->set_lod({new_offset});
+  _layout_input->Resize(bottom->dims());
+  const auto* emb = bottom->template data<T>();
 
   // this buffer is used for book keeping info which will be used in bp
   // buffer also needed in bp, so make it larger
   _buffer->Resize({20, _cap_l, _cap_h});
   auto* buffer_data = _buffer->template mutable_data<T>();
-  auto* w_x_e = buffer_data + 0 * _cap_l * _cap_h;
-  auto* wr_x_e = buffer_data + 1 * _cap_l * _cap_h;
-  auto* wz_x_e = buffer_data + 2 * _cap_l * _cap_h;
+  // The three gates are stored one after another in Wi and Wh, so each
+  // projection is a single GEMM with 3 * _cap_h columns. The results of
+  // a row are kept together as [w, wr, wz] and [u, ur, uz].
+  int gate_width = 3 * _cap_h;
+  auto* x_e = buffer_data + 0 * _cap_l * _cap_h;
   auto* u_x_h = buffer_data + 3 * _cap_l * _cap_h;
-  auto* ur_x_h = buffer_data + 4 * _cap_l * _cap_h;
-  auto* uz_x_h = buffer_data + 5 * _cap_l * _cap_h;
   auto* r = buffer_data + 6 * _cap_l * _cap_h;
   auto* z = buffer_data + 7 * _cap_l * _cap_h;
   auto* tilde = buffer_data + 8 * _cap_l * _cap_h;
@@ -218,42 +116,30 @@ void SearchGrnnCompute<T>::Run() {
            CblasNoTrans,
            CblasTrans,
            _cap_l,
-           _cap_h,
+           gate_width,
            _cap_e,
            1.0f,
-           new_emb,
-           e2h,
+           emb,
+           dense_e2h,
            0.0f,
-           w_x_e);
-  CallGemm(blas,
-           CblasNoTrans,
-           CblasTrans,
-           _cap_l,
-           _cap_h,
-           _cap_e,
-           1.0f,
-           new_emb,
-           e2hr,
-           0.0f,
-           wr_x_e);
-  CallGemm(blas,
-           CblasNoTrans,
-           CblasTrans,
-           _cap_l,
-           _cap_h,
-           _cap_e,
-           1.0f,
-           new_emb,
-           e2hz,
-           0.0f,
-           wz_x_e);
+           x_e);
 
+  // The rows of a step are independent, they are split across the threads.
   // precompute hidden0
-  for (int i = 0; i < batch * _cap_h; i++) {
-    tilde[i] = std::tanh(w_x_e[i]);
-    z[i] = sigmoid<T>(wz_x_e[i]);
-    hidden[i] = (1. - z[i]) * tilde[i];
-  }
+  lite::x86::RunParallelFor(0, new_offset[1], [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const T* w_x_e = x_e + seq2batch_idx[p] * gate_width;
+      const T* wz_x_e = w_x_e + 2 * _cap_h;
+      T* top_row = top_hidden + seq2batch_idx[p] * _cap_h;
+      for (int k = 0; k < _cap_h; k++) {
+        int j = p * _cap_h + k;
+        tilde[j] = std::tanh(w_x_e[k]);
+        z[j] = sigmoid<T>(wz_x_e[k]);
+        hidden[j] = (1. - z[j]) * tilde[j];
+        top_row[k] = hidden[j];
+      }
+    }
+  });
 
   // recurrence
   for (int i = 1; i < max_width; i++) {
@@ -267,47 +153,37 @@ void SearchGrnnCompute<T>::Run() {
              CblasNoTrans,
              CblasTrans,
              w,
-             _cap_h,
+             gate_width,
              _cap_h,
              1.0f,
              htm1,
-             h2h,
+             dense_h2h,
              0.0f,
-             u_x_h + new_offset[i] * _cap_h);
-    CallGemm(blas,
-             CblasNoTrans,
-             CblasTrans,
-             w,
-             _cap_h,
-             _cap_h,
-             1.0f,
-             htm1,
-             h2hr,
-             0.0f,
-             ur_x_h + new_offset[i] * _cap_h);
-    CallGemm(blas,
-             CblasNoTrans,
-             CblasTrans,
-             w,
-             _cap_h,
-             _cap_h,
-             1.0f,
-             htm1,
-             h2hz,
-             0.0f,
-             uz_x_h + new_offset[i] * _cap_h);
+             u_x_h + new_offset[i] * gate_width);
 
     // compute the gate and hidden
-    for (size_t j = new_offset[i] * _cap_h; j < (new_offset[i] + w) * _cap_h;
-         j++) {
-      r[j] = sigmoid(wr_x_e[j] + ur_x_h[j]);
-      z[j] = sigmoid(wz_x_e[j] + uz_x_h[j]);
-      tilde[j] = std::tanh(w_x_e[j] + r[j] * u_x_h[j]);
-      hidden[j] = z[j] * hidden[j - _cap_h * w_tm1] + (1.0 - z[j]) * tilde[j];
-    }
+    lite::x86::RunParallelFor(
+        new_offset[i], new_offset[i + 1], [&](int64_t begin, int64_t end) {
+          for (int64_t p = begin; p < end; p++) {
+            const T* w_x_e = x_e + seq2batch_idx[p] * gate_width;
+            const T* wr_x_e = w_x_e + _cap_h;
+            const T* wz_x_e = w_x_e + 2 * _cap_h;
+            const T* u = u_x_h + p * gate_width;
+            const T* ur = u + _cap_h;
+            const T* uz = u + 2 * _cap_h;
+            T* top_row = top_hidden + seq2batch_idx[p] * _cap_h;
+            for (int k = 0; k < _cap_h; k++) {
+              int j = p * _cap_h + k;
+              r[j] = sigmoid(wr_x_e[k] + ur[k]);
+              z[j] = sigmoid(wz_x_e[k] + uz[k]);
+              tilde[j] = std::tanh(w_x_e[k] + r[j] * u[k]);
+              hidden[j] =
+                  z[j] * hidden[j - _cap_h * w_tm1] + (1.0 - z[j]) * tilde[j];
+              top_row[k] = hidden[j];
+            }
+          }
+        });
   }
-
-  CopyBack(hidden, top_hidden, _cap_h);
 }
 
 }  // namespace x86
@@ -32,10 +32,6 @@ class SearchGrnnCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   void Run() override;
 
   virtual ~SearchGrnnCompute() = default;
-
- private:
-  void PrepareLayout(const Tensor* input);
-  void CopyBack(T* from, T* to, int step);
 };
 
 }  // namespace x86
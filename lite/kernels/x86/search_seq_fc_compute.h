@@ -13,7 +13,9 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -48,22 +50,42 @@ class SearchSeqFcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     CHECK_EQ(out_dims[0], x_dims[0]) << "Wrong shape: out_dims[0] != x_dims[0]";
     CHECK_EQ(out_dims[1], out_size) << "Wrong shape: out_dims[1] != out_size";
 
-    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-    blas.MatMul(*x, false, *w, true, out);
-
+    int M = x_dims[0];
+    int N = w_dims[0];
+    int K = x_dims[1];
+    const T* x_data = x->template data<T>();
+    const T* w_data = w->template data<T>();
+    T* out_data = out->template mutable_data<T>();
+    T beta = static_cast<T>(0);
     if (b != nullptr) {
       auto b_dims = b->dims();
       CHECK_EQ(b_dims.size(), 1) << "b should be 1-D tensor.";
       CHECK_EQ(b_dims[0], w_dims[0]) << "Wrong shape: b_dims[0] != w_dims[0]";
-      int M = x_dims[0];
-      int N = w_dims[0];
-      for (int i = 0; i < M; i++) {
-        blas.AXPY(N,
-                  static_cast<T>(1),
-                  b->template data<T>(),
-                  out->template mutable_data<T>() + i * N);
-      }
+      // Broadcast the bias into the output, the GEMM then accumulates onto
+      // it instead of adding the bias row by row afterwards.
+      const T* b_data = b->template data<T>();
+      lite::x86::RunParallelFor(0, M, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          std::memcpy(out_data + i * N, b_data, N * sizeof(T));
+        }
+      });
+      beta = static_cast<T>(1);
     }
+
+    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              M,
+              N,
+              K,
+              static_cast<T>(1),
+              x_data,
+              K,
+              w_data,
+              K,
+              beta,
+              out_data,
+              N);
   }
 
   virtual ~SearchSeqFcCompute() = default;
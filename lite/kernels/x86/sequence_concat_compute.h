@@ -13,7 +13,9 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -22,22 +24,13 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
-template <typename T>
-inline LoD ConcatLoD(const std::vector<lite::Tensor*>& xs,
-                     std::vector<lite::Tensor>* xs_in_order) {
-  std::vector<uint64_t> result;
-  result.resize(xs[0]->lod()[0].size());
-
+// The i-th output sequence is made of the i-th sequences of all the inputs.
+inline LoD ConcatLoD(const std::vector<lite::Tensor*>& xs) {
+  std::vector<uint64_t> result(xs[0]->lod()[0].size(), 0);
   for (size_t i = 1; i < result.size(); ++i) {
-    size_t sum = 0;
     for (size_t j = 0; j < xs.size(); ++j) {
-      auto& x_lod = xs[j]->lod()[0];
-      if (x_lod[i - 1] < x_lod[i]) {
-        xs_in_order->emplace_back(xs[j]->Slice<T>(x_lod[i - 1], x_lod[i]));
-      }
-      sum += x_lod[i];
+      result[i] += xs[j]->lod()[0][i];
     }
-    result[i] = sum;
   }
   LoD lod;
   lod.emplace_back(result);
@@ -76,25 +69,26 @@ class SequenceConcatCompute
     param.Out->Resize(out_dims);
 
     T* dout = param.Out->template mutable_data<T>();
+    LoD out_lod = ConcatLoD(param.X);
+    param.Out->set_lod(out_lod);
 
-    std::vector<lite::Tensor> x_in_order;
-    param.Out->set_lod(ConcatLoD<T>(param.X, &x_in_order));
-
-    int num = x_in_order.size();
-    int out_rows = 1;
-
-    std::vector<int64_t> input_cols(num);
-    for (int i = 0; i < num; ++i) {
-      input_cols[i] = x_in_order[i].numel() / out_rows;
-    }
-
-    int col_idx = 0;
-    for (int j = 0; j < num; ++j) {
-      int col_len = input_cols[j];
-      auto input_data = x_in_order[j].data<T>();
-      memcpy(dout + col_idx, input_data, sizeof(T) * col_len);
-      col_idx += col_len;
-    }
+    // Every output sequence is a run of row blocks copied from the inputs,
+    // the sequences are filled in parallel.
+    const auto& out_offset = out_lod[0];
+    lite::x86::RunParallelForByLoD(
+        out_offset, feature_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            T* dst = dout + out_offset[i] * feature_size;
+            for (const auto* x : param.X) {
+              const auto& x_lod = x->lod()[0];
+              int64_t len = (x_lod[i + 1] - x_lod[i]) * feature_size;
+              std::memcpy(dst,
+                          x->template data<T>() + x_lod[i] * feature_size,
+                          len * sizeof(T));
+              dst += len;
+            }
+          }
+        });
   }
 
   virtual ~SequenceConcatCompute() = default;
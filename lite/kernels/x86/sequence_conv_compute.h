@@ -57,7 +57,7 @@ class SequenceConvCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
                                    context_length * sequence_width};
     Tensor col;
     col.Resize(col_shape);
-    col.mutable_data<T>();
+    ctx.AllocWorkspace<T>(&col);
 
     // Because if padding_trainable is false, padding data should be zeros.
     math::SetConstant<TARGET(kX86), T> set_zero;
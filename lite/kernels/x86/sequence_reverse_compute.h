@@ -13,7 +13,9 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -35,22 +37,26 @@ class SequenceReverseCompute : public KernelLite<TARGET(kX86), Ptype> {
     T* dout = output->template mutable_data<T>();
     CHECK_NE(din, dout)
         << "SequenceReverse Op does not support in-place operation";
-    const auto lod = param.X->lod()[param.X->lod().size() - 1];
-    const size_t lod_count = lod.size();
+    const auto& lod = param.X->lod()[param.X->lod().size() - 1];
 
     size_t limit = static_cast<size_t>(param.X->numel());
     size_t row_numel = static_cast<size_t>(limit / param.X->dims()[0]);
 
-    for (size_t idx = 0; idx < lod_count - 1; ++idx) {
-      auto start_pos = lod[idx];
-      auto end_pos = lod[idx + 1];
-      for (auto pos = start_pos; pos < end_pos; ++pos) {
-        auto cur_pos = end_pos - pos - 1 + start_pos;
-        std::memcpy(dout + pos * row_numel,
-                    din + cur_pos * row_numel,
-                    row_numel * sizeof(T));
-      }
-    }
+    // The sequences are reversed independently, the threads split the rows
+    // evenly.
+    lite::x86::RunParallelForByLoD(
+        lod, row_numel, [&](int64_t begin, int64_t end) {
+          for (int64_t idx = begin; idx < end; ++idx) {
+            auto start_pos = lod[idx];
+            auto end_pos = lod[idx + 1];
+            for (auto pos = start_pos; pos < end_pos; ++pos) {
+              auto cur_pos = end_pos - pos - 1 + start_pos;
+              std::memcpy(dout + pos * row_numel,
+                          din + cur_pos * row_numel,
+                          row_numel * sizeof(T));
+            }
+          }
+        });
     output->set_lod(param.X->lod());
   }
 
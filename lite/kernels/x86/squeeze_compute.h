@@ -34,10 +34,13 @@ class SqueezeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto& param = *param_.get_mutable<param_t>();
     auto x = param.X;
     auto output = param.Out;
-    auto x_dims = x->dims();
-    auto* x_data = x->template data<T>();
-    auto* out_data = output->template mutable_data<T>();
-    memcpy(out_data, x_data, x_dims.production() * sizeof(T));
+    auto out_dims = output->dims();
+    if (param.inplace) {
+      output->ShareDataWith(*x);
+    } else {
+      output->CopyDataFrom(*x);
+    }
+    output->Resize(out_dims);
   }
 
   virtual ~SqueezeCompute() = default;
@@ -54,11 +57,16 @@ class Squeeze2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto output = param.Out;
     auto xshape = param.XShape;
     auto x_dims = x->dims();
+    auto out_dims = output->dims();
     auto* x_data = x->template data<T>();
-    auto* out_data = output->template mutable_data<T>();
     auto* xshape_data = xshape->template mutable_data<T>();
-    memcpy(out_data, x_data, x_dims.production() * sizeof(T));
     memcpy(xshape_data, x_data, x_dims.production() * sizeof(T));
+    if (param.inplace) {
+      output->ShareDataWith(*x);
+    } else {
+      output->CopyDataFrom(*x);
+    }
+    output->Resize(out_dims);
   }
 
   virtual ~Squeeze2Compute() = default;
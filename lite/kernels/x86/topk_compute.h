@@ -0,0 +1,112 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Is the candidate (value a, index ia) better than (value b, index ib), the
+// smaller index wins on a tie.
+inline bool TopkBetter(float a, int64_t ia, float b, int64_t ib) {
+  return a > b || (a == b && ia < ib);
+}
+
+// Selects the top k of x[0, n) into values and indices in descending order.
+// The candidates are kept in a min-heap of size k, the blocks of x whose
+// values are all below the smallest kept value are skipped at once.
+inline void TopkRow(const float* x,
+                    int64_t n,
+                    int k,
+                    std::vector<std::pair<float, int64_t>>* heap,
+                    float* values,
+                    int64_t* indices) {
+  constexpr int64_t kBlockSize = 16;
+  auto worse = [](const std::pair<float, int64_t>& a,
+                  const std::pair<float, int64_t>& b) {
+    return TopkBetter(a.first, a.second, b.first, b.second);
+  };
+  heap->clear();
+  if (k <= 0) return;
+  for (int64_t i = 0; i < n && static_cast<int>(heap->size()) < k; ++i) {
+    heap->emplace_back(x[i], i);
+    std::push_heap(heap->begin(), heap->end(), worse);
+  }
+  for (int64_t begin = k; begin < n; begin += kBlockSize) {
+    int64_t end = std::min(begin + kBlockSize, n);
+    // The later candidates never win a tie, so only the strictly larger
+    // values can enter the heap.
+    float threshold = heap->front().first;
+    float max = x[begin];
+    for (int64_t i = begin + 1; i < end; ++i) {
+      max = x[i] > max ? x[i] : max;
+    }
+    if (!(max > threshold)) continue;
+    for (int64_t i = begin; i < end; ++i) {
+      if (x[i] > heap->front().first) {
+        std::pop_heap(heap->begin(), heap->end(), worse);
+        heap->back() = std::make_pair(x[i], i);
+        std::push_heap(heap->begin(), heap->end(), worse);
+      }
+    }
+  }
+  std::sort_heap(heap->begin(), heap->end(), worse);
+  for (size_t i = 0; i < heap->size(); ++i) {
+    values[i] = (*heap)[i].first;
+    indices[i] = (*heap)[i].second;
+  }
+}
+
+class TopkCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::TopkParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::TopkParam>();
+    const float* x_data = param.X->data<float>();
+    float* out_val = param.Out->mutable_data<float>();
+    int64_t* out_ind = param.Indices->mutable_data<int64_t>();
+    DDim x_dims = param.X->dims();
+    int k = param.K;
+    int64_t n = x_dims[x_dims.size() - 1];
+    int64_t m = x_dims.production() / n;
+    CHECK_LE(k, n) << "k should not be larger than the last dim of X";
+
+    // The rows are independent, each worker reuses one heap for its rows.
+    lite::x86::RunParallelFor(0, m, [&](int64_t begin, int64_t end) {
+      std::vector<std::pair<float, int64_t>> heap;
+      heap.reserve(k);
+      for (int64_t i = begin; i < end; ++i) {
+        TopkRow(x_data + i * n, n, k, &heap, out_val + i * k, out_ind + i * k);
+      }
+    });
+  }
+
+  virtual ~TopkCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,84 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/topk_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(topk_x86, retrive_op) {
+  auto topk =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>("top_k");
+  ASSERT_FALSE(topk.empty());
+  ASSERT_TRUE(topk.front());
+}
+
+TEST(topk_x86, run_test) {
+  for (int64_t n : {5, 16, 33, 257}) {
+    for (int k : {0, 1, 2, 5}) {
+      int64_t m = 7;
+      lite::Tensor x, out, indices;
+      x.Resize({m, n});
+      out.Resize({m, k});
+      indices.Resize({m, k});
+      auto* x_data = x.mutable_data<float>();
+      // Few distinct values, so there are plenty of ties.
+      for (int64_t i = 0; i < m * n; i++) {
+        x_data[i] = static_cast<float>((i * 37 + 11) % 23) - 11.f;
+      }
+
+      TopkCompute topk;
+      operators::TopkParam param;
+      param.X = &x;
+      param.Out = &out;
+      param.Indices = &indices;
+      param.K = k;
+      topk.SetParam(param);
+      topk.Run();
+
+      auto* out_data = out.data<float>();
+      auto* indices_data = indices.data<int64_t>();
+      for (int64_t i = 0; i < m; i++) {
+        std::vector<std::pair<float, int64_t>> ref;
+        for (int64_t j = 0; j < n; j++) {
+          ref.emplace_back(x_data[i * n + j], j);
+        }
+        std::stable_sort(ref.begin(),
+                         ref.end(),
+                         [](const std::pair<float, int64_t>& a,
+                            const std::pair<float, int64_t>& b) {
+                           return a.first > b.first;
+                         });
+        for (int q = 0; q < k; q++) {
+          EXPECT_EQ(out_data[i * k + q], ref[q].first);
+          EXPECT_EQ(indices_data[i * k + q], ref[q].second);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(top_k, kX86, kFloat, kNCHW, def);
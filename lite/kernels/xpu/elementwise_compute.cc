@@ -26,7 +26,7 @@ void ElementwiseAddCompute::Run() {
   auto& param = this->Param<param_t>();
   auto& ctx = this->ctx_->As<XPUContext>();
 
-  auto& x_dims = param.X->dims().data();
+  auto x_dims = param.X->dims().Vectorize();
   auto& y_dims = param.Y->dims();
   int axis = param.axis;
   if (param.axis == -1) {
@@ -53,7 +53,7 @@ void ElementwiseSubCompute::Run() {
   auto& param = this->Param<param_t>();
   auto& ctx = this->ctx_->As<XPUContext>();
 
-  auto& x_dims = param.X->dims().data();
+  auto x_dims = param.X->dims().Vectorize();
   auto& y_dims = param.Y->dims();
   int axis = param.axis;
   if (param.axis == -1) {
@@ -116,7 +116,7 @@ int SubgraphEngine::BuildDeviceProgram() {
     device_itensors_[i].ndim = origin_idims_[i].size();
     device_itensors_[i].dtype = subgraph::xpu::CvtDLDataType(precision);
     device_itensors_[i].shape = const_cast<int64_t*>(
-        static_cast<const int64_t*>(origin_idims_[i].data().data()));
+        static_cast<const int64_t*>(origin_idims_[i].data()));
     device_itensors_[i].strides = nullptr;
     device_itensors_[i].byte_offset = 0;
   }
@@ -162,7 +162,7 @@ int SubgraphEngine::BuildDeviceProgram() {
     device_otensors_[i].ndim = origin_odims_[i].size();
     device_otensors_[i].dtype = subgraph::xpu::CvtDLDataType(precision);
     device_otensors_[i].shape = const_cast<int64_t*>(
-        static_cast<const int64_t*>(origin_odims_[i].data().data()));
+        static_cast<const int64_t*>(origin_odims_[i].data()));
     device_otensors_[i].strides = nullptr;
     device_otensors_[i].byte_offset = 0;
   }
@@ -108,6 +108,11 @@ class OpDesc : public OpDescAPI {
   template <typename T>
   void SetAttr(const std::string& name, const T& v);
 
+  void DeleteAttr(const std::string& name) {
+    attrs_.erase(name);
+    attr_types_.erase(name);
+  }
+
   template <typename T>
   T GetAttr(const std::string& name) const;
 
@@ -13,10 +13,18 @@
 // limitations under the License.
 
 #include "lite/model_parser/model_parser.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <set>
+#include <thread>  // NOLINT
 #include "lite/core/scope.h"
 #include "lite/core/tensor.h"
 #include "lite/core/variable.h"
@@ -30,6 +38,7 @@
 #include "lite/model_parser/pb/program_desc.h"
 #include "lite/model_parser/pb/var_desc.h"
 #endif
+#include "lite/utils/env.h"
 #include "lite/utils/io.h"
 
 namespace paddle {
@@ -56,7 +65,16 @@ int SizeOfType(framework::proto::VarType::Type type) {
   return -1;
 }
 
-void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
+namespace {
+
+// Reads the version and the desc of a serialized tensor, resizes and
+// allocates `tensor` accordingly and returns the address its data should be
+// read into. The byte size of the data is written to `data_size`. The desc
+// is parsed from `desc_buf`, which callers reuse across tensors.
+void *TensorMetaFromStream(std::istream &is,
+                           lite::Tensor *tensor,
+                           std::string *desc_buf,
+                           size_t *data_size) {
   using Type = framework::proto::VarType::Type;
   uint32_t version;
   is.read(reinterpret_cast<char *>(&version), sizeof(version));
@@ -68,9 +86,11 @@ void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
     // proto buffer
     int32_t size;
     is.read(reinterpret_cast<char *>(&size), sizeof(size));
-    std::unique_ptr<char[]> buf(new char[size]);
-    is.read(reinterpret_cast<char *>(buf.get()), size);
-    CHECK(desc.ParseFromArray(buf.get(), size)) << "Cannot parse tensor desc";
+    CHECK_GE(size, 0) << "Invalid tensor desc size";
+    desc_buf->resize(size);
+    is.read(&(*desc_buf)[0], size);
+    CHECK(desc.ParseFromArray(desc_buf->data(), size))
+        << "Cannot parse tensor desc";
   }
 
   // read tensor
@@ -80,7 +100,7 @@ void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
   lite::DDim dims(dims_vec);
   tensor->Resize(dims);
   void *buf;
-  size_t size = tensor->dims().production() * SizeOfType(desc.data_type());
+  *data_size = tensor->dims().production() * SizeOfType(desc.data_type());
   // alllocate memory
   switch (static_cast<int>(desc.data_type())) {
 #define SET_TENSOR(desc, type, precision) \
@@ -100,12 +120,15 @@ void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
       LOG(FATAL) << "unknown type " << desc.data_type();
   }
   tensor->set_persistable(true);
-
-  is.read(static_cast<char *>(buf), size);
+  return buf;
 }
 
-void LoadLoDTensor(std::istream &is, Variable *var) {
-  auto *tensor = var->GetMutable<lite::Tensor>();
+// Same as TensorMetaFromStream, but for a LoDTensor, whose LoD information
+// precedes the tensor desc.
+void *LoDTensorMetaFromStream(std::istream &is,
+                              lite::Tensor *tensor,
+                              std::string *desc_buf,
+                              size_t *data_size) {
   uint32_t version{};
   is.read(reinterpret_cast<char *>(&version), sizeof(version));
   VLOG(3) << "model version " << version;
@@ -118,13 +141,132 @@ void LoadLoDTensor(std::istream &is, Variable *var) {
   for (uint64_t i = 0; i < lod_level; ++i) {
     uint64_t size;
     is.read(reinterpret_cast<char *>(&size), sizeof(size));
-    std::vector<uint64_t> tmp(size / sizeof(uint64_t));
-    is.read(reinterpret_cast<char *>(tmp.data()),
+    lod[i].resize(size / sizeof(uint64_t));
+    is.read(reinterpret_cast<char *>(lod[i].data()),
             static_cast<std::streamsize>(size));
-    lod[i] = tmp;
   }
 
-  TensorFromStream(is, tensor);
+  return TensorMetaFromStream(is, tensor, desc_buf, data_size);
+}
+
+#if !defined(_WIN32)
+// A byte range of a parameter file that is read straight into the memory of
+// an already allocated tensor.
+struct ParamReadChunk {
+  int fd;
+  uint64_t offset;
+  size_t size;
+  char *dst;
+};
+
+// Large tensors are split into chunks, so that a single big table (e.g. an
+// embedding) is read by several threads too.
+const size_t kParamReadChunkSize = 8UL << 20;
+const int kMaxParamLoadThreads = 8;
+
+void AppendParamReadChunks(int fd,
+                           uint64_t offset,
+                           size_t size,
+                           void *dst,
+                           std::vector<ParamReadChunk> *chunks) {
+  char *data = static_cast<char *>(dst);
+  for (size_t done = 0; done < size; done += kParamReadChunkSize) {
+    chunks->push_back({fd,
+                       offset + done,
+                       std::min(kParamReadChunkSize, size - done),
+                       data + done});
+  }
+}
+
+void ReadParamChunk(const ParamReadChunk &chunk) {
+  size_t done = 0;
+  while (done < chunk.size) {
+    ssize_t ret = pread(chunk.fd,
+                        chunk.dst + done,
+                        chunk.size - done,
+                        static_cast<off_t>(chunk.offset + done));
+    if (ret < 0 && errno == EINTR) continue;
+    CHECK_GT(ret, 0) << "There is a problem with loading model parameters: "
+                     << (ret < 0 ? strerror(errno) : "unexpected end of file");
+    done += static_cast<size_t>(ret);
+  }
+}
+
+// Reads all the chunks with a few threads. The chunks cover disjoint memory,
+// so the only shared state is the index of the next chunk to read. The number
+// of threads can be overridden by the env LITE_PARAMS_LOAD_THREADS.
+void ReadParamChunks(const std::vector<ParamReadChunk> &chunks) {
+  int num_threads = std::min<int>(
+      kMaxParamLoadThreads,
+      std::max<int>(std::thread::hardware_concurrency(), 1));
+  num_threads = GetIntFromEnv("LITE_PARAMS_LOAD_THREADS", num_threads);
+  num_threads = std::max(
+      1, std::min<int>(num_threads, static_cast<int>(chunks.size())));
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < chunks.size(); i = next++) {
+      ReadParamChunk(chunks[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+// Loads the combined params file in two steps: a sequential scan which only
+// parses the tensor descs, allocates the tensors and records where their data
+// is located, followed by parallel preads of the data.
+void LoadCombinedParamsFromFile(const std::string &path,
+                                lite::Scope *scope,
+                                const std::vector<std::string> &paramlist) {
+  std::ifstream fin(path, std::ios::binary);
+  CHECK(fin.is_open()) << "Cannot open file: " << path;
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Cannot open file: " << path;
+
+  std::vector<ParamReadChunk> chunks;
+  std::string desc_buf;
+  for (size_t i = 0; i < paramlist.size(); ++i) {
+    auto *tensor = scope->Var(paramlist[i])->GetMutable<lite::Tensor>();
+    // Error checking
+    CHECK(static_cast<bool>(fin))
+        << "There is a problem with loading model parameters";
+    size_t data_size = 0;
+    void *data = LoDTensorMetaFromStream(fin, tensor, &desc_buf, &data_size);
+    uint64_t offset = static_cast<uint64_t>(fin.tellg());
+    AppendParamReadChunks(fd, offset, data_size, data, &chunks);
+    fin.seekg(data_size, std::ios::cur);
+  }
+  fin.peek();
+  CHECK(fin.eof()) << "You are not allowed to load partial data via"
+                   << " LoadCombinedParamsPb, use LoadParam instead.";
+
+  ReadParamChunks(chunks);
+  close(fd);
+}
+#endif  // !_WIN32
+
+}  // namespace
+
+void TensorFromStream(std::istream &is, lite::Tensor *tensor) {
+  std::string desc_buf;
+  size_t size = 0;
+  void *buf = TensorMetaFromStream(is, tensor, &desc_buf, &size);
+  is.read(static_cast<char *>(buf), size);
+}
+
+void LoadLoDTensor(std::istream &is, Variable *var) {
+  auto *tensor = var->GetMutable<lite::Tensor>();
+  std::string desc_buf;
+  size_t size = 0;
+  void *buf = LoDTensorMetaFromStream(is, tensor, &desc_buf, &size);
+  is.read(static_cast<char *>(buf), size);
 }
 
 void ReadBinaryFile(const std::string &filename, std::string *contents) {
@@ -206,9 +348,13 @@ void LoadCombinedParamsPb(const std::string &path,
     std::stringstream fin(path, std::ios::in | std::ios::binary);
     load_var_func(fin);
   } else {
+#if !defined(_WIN32)
+    LoadCombinedParamsFromFile(path, scope, paramlist);
+#else
     std::ifstream fin(path, std::ios::binary);
     CHECK(fin.is_open());
     load_var_func(fin);
+#endif
   }
 }
 
@@ -246,6 +392,23 @@ void LoadModelPb(const std::string &model_dir,
     LoadCombinedParamsPb(param_file, scope, *cpp_prog, model_from_memory);
   } else {
     auto main_block = pb_proto_prog.blocks(0);
+#if !defined(_WIN32)
+    // Parse the descs of the weights first, then read their data in
+    // parallel, see LoadCombinedParamsFromFile. The reads are flushed every
+    // kMaxPendingParamFiles files to bound the number of open descriptors.
+    const size_t kMaxPendingParamFiles = 256;
+    std::vector<int> fds;
+    std::vector<ParamReadChunk> chunks;
+    std::string desc_buf;
+    auto flush_reads = [&]() {
+      ReadParamChunks(chunks);
+      for (int fd : fds) {
+        close(fd);
+      }
+      fds.clear();
+      chunks.clear();
+    };
+#endif
     for (auto &var : main_block.vars()) {
       if (var.name() == "feed" || var.name() == "fetch" || !var.persistable())
         continue;
@@ -255,13 +418,30 @@ void LoadModelPb(const std::string &model_dir,
 
       std::ifstream file(file_path, std::ios::binary);
       switch (var.type().type()) {
-        case framework::proto::VarType_Type_LOD_TENSOR:
+        case framework::proto::VarType_Type_LOD_TENSOR: {
+#if !defined(_WIN32)
+          CHECK(file.is_open()) << "Cannot open file: " << file_path;
+          auto *tensor = scope->Var(var.name())->GetMutable<lite::Tensor>();
+          size_t data_size = 0;
+          void *data =
+              LoDTensorMetaFromStream(file, tensor, &desc_buf, &data_size);
+          int fd = open(file_path.c_str(), O_RDONLY);
+          CHECK_GE(fd, 0) << "Cannot open file: " << file_path;
+          fds.push_back(fd);
+          uint64_t offset = static_cast<uint64_t>(file.tellg());
+          AppendParamReadChunks(fd, offset, data_size, data, &chunks);
+          if (fds.size() >= kMaxPendingParamFiles) flush_reads();
+#else
           LoadLoDTensor(file, scope->Var(var.name()));
-          break;
+#endif
+        } break;
         default:
           CHECK(false) << "unknown weight type";
       }
     }
+#if !defined(_WIN32)
+    flush_reads();
+#endif
   }
 
   VLOG(4) << "Load protobuf model in '" << model_dir << "'' successfully";
@@ -15,6 +15,9 @@
 #include "lite/model_parser/model_parser.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
 #include "lite/core/scope.h"
 
 DEFINE_string(model_dir, "", "");
@@ -70,6 +73,108 @@ TEST(ModelParser, LoadModelCombinedPb) {
   std::string param_file_path = FLAGS_model_dir + ".saved.pb.combined/params";
   LoadModelPb(
       model_path, model_file_path, param_file_path, &scope, &prog, true);
+
+  // The params read in parallel from the combined file should be the same
+  // as the ones read one by one from the separate files.
+  auto& main_block = *prog.GetBlock<cpp::BlockDesc>(0);
+  for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+    auto& var_desc = *main_block.GetVar<cpp::VarDesc>(i);
+    if (!var_desc.Persistable() || var_desc.Name() == "feed" ||
+        var_desc.Name() == "fetch")
+      continue;
+    const auto& name = var_desc.Name();
+    Scope origin_scope;
+    LoadParam(FLAGS_model_dir + "/" + name, origin_scope.Var(name));
+    auto* var = scope.FindVar(name);
+    ASSERT_TRUE(var != nullptr) << name;
+    const auto& origin = origin_scope.FindVar(name)->Get<lite::Tensor>();
+    const auto& loaded = var->Get<lite::Tensor>();
+    ASSERT_EQ(origin.dims(), loaded.dims());
+    ASSERT_EQ(origin.lod(), loaded.lod());
+    ASSERT_EQ(origin.memory_size(), loaded.memory_size());
+    EXPECT_EQ(
+        memcmp(origin.raw_data(), loaded.raw_data(), origin.memory_size()), 0);
+  }
+}
+
+// Saves tensors of known values, one of them larger than a read chunk, and
+// loads them back with the parallel readers.
+TEST(ModelParser, LoadParamsPbKnownValues) {
+  setenv("LITE_PARAMS_LOAD_THREADS", "3", 1);
+  cpp::ProgramDesc prog;
+  auto* block = prog.AddBlock<cpp::BlockDesc>();
+  Scope scope;
+  auto add_param = [&](const std::string& name) {
+    auto* var_desc = block->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var_desc->SetPersistable(true);
+    auto* tensor = scope.Var(name)->GetMutable<lite::Tensor>();
+    tensor->set_persistable(true);
+    return tensor;
+  };
+  const int64_t big_size = (9 << 20) / sizeof(float) + 3;
+  auto* big = add_param("big_w");
+  big->Resize(std::vector<int64_t>({big_size}));
+  auto* big_data = big->mutable_data<float>();
+  for (int64_t i = 0; i < big_size; ++i) {
+    big_data[i] = static_cast<float>(i % 1000) * 0.5f;
+  }
+  auto* ids = add_param("ids");
+  ids->Resize(std::vector<int64_t>({5, 1}));
+  ids->set_lod({{0, 2, 5}});
+  auto* ids_data = ids->mutable_data<int64_t>();
+  for (int i = 0; i < 5; ++i) {
+    ids_data[i] = (1LL << 40) + i;
+  }
+  auto* bias = add_param("bias");
+  bias->Resize(std::vector<int64_t>({3}));
+  auto* bias_data = bias->mutable_data<int32_t>();
+  for (int i = 0; i < 3; ++i) {
+    bias_data[i] = -7 * i;
+  }
+
+  auto check = [&](const Scope& loaded) {
+    const auto& big = loaded.FindVar("big_w")->Get<lite::Tensor>();
+    ASSERT_EQ(big.dims().Vectorize(), std::vector<int64_t>({big_size}));
+    const auto* big_data = big.data<float>();
+    for (int64_t i = 0; i < big_size; ++i) {
+      ASSERT_EQ(big_data[i], static_cast<float>(i % 1000) * 0.5f) << i;
+    }
+    const auto& ids = loaded.FindVar("ids")->Get<lite::Tensor>();
+    ASSERT_EQ(ids.dims().Vectorize(), std::vector<int64_t>({5, 1}));
+    ASSERT_EQ(ids.lod(), std::vector<std::vector<uint64_t>>({{0, 2, 5}}));
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(ids.data<int64_t>()[i], (1LL << 40) + i);
+    }
+    const auto& bias = loaded.FindVar("bias")->Get<lite::Tensor>();
+    ASSERT_EQ(bias.dims().Vectorize(), std::vector<int64_t>({3}));
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(bias.data<int32_t>()[i], -7 * i);
+    }
+  };
+
+  const std::string model_dir = "./known_values.pb";
+  SaveModelPb(model_dir, scope, prog);
+  {
+    cpp::ProgramDesc loaded_prog;
+    Scope loaded;
+    LoadModelPb(model_dir, "", "", &loaded, &loaded_prog);
+    check(loaded);
+  }
+  SaveModelPb(model_dir + ".combined", scope, prog, true);
+  {
+    cpp::ProgramDesc loaded_prog;
+    Scope loaded;
+    LoadModelPb(model_dir + ".combined",
+                model_dir + ".combined/model",
+                model_dir + ".combined/params",
+                &loaded,
+                &loaded_prog,
+                true);
+    check(loaded);
+  }
+  unsetenv("LITE_PARAMS_LOAD_THREADS");
 }
 
 TEST(ModelParser, SaveParamNaive) {
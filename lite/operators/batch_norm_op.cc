@@ -116,6 +116,7 @@ bool BatchNormOp::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   std::string data_layout = op_desc.GetAttr<std::string>("data_layout");
   CHECK_EQ(data_layout, "NCHW") << "TODO(hong19860320): Only support NCHW.";
   // param_.data_layout = StringToDataLayout(data_layout);
+  op_param_ = &param_;
   return true;
 }
 
@@ -88,6 +88,9 @@ bool ConcatOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
       }
     }
   }
+  if (param_.axis_tensor == nullptr) {
+    op_param_ = &param_;
+  }
   return true;
 }
 
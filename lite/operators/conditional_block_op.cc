@@ -46,6 +46,7 @@ bool ConditionalBlockOpLite::AttachImpl(const cpp::OpDesc &op_desc,
 
   param_.is_scalar_condition = op_desc.GetAttr<bool>("is_scalar_condition");
   // obtain sub_block in core program.cc
+  param_.program_desc = program_desc_;
   param_.sub_block = sub_block_;
   param_.scope = scope;
 
@@ -128,6 +128,10 @@ class ConvOpLite : public OpLite {
       }
     }
     param_.paddings = std::make_shared<std::vector<int>>(paddings);
+    // "SAME" paddings are computed from the input shape in InferShapeImpl.
+    if (padding_algorithm_ != "SAME") {
+      op_param_ = &param_;
+    }
     return true;
   }
 
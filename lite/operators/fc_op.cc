@@ -109,6 +109,7 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
     if (op_desc.HasAttr("output_scale"))
       param_.output_scale = op_desc.GetAttr<float>("output_scale");
   }
+  op_param_ = &param_;
   return true;
 }
 
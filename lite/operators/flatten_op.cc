@@ -58,10 +58,14 @@ bool FlattenOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   axis_ = opdesc.GetAttr<int>("axis");
 
   param_.inplace = false;
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
 
   CHECK(param_.x) << "Input(X) of FlattenOp should not be null.";
   CHECK(param_.output) << "Output(Out) of FlattenOp should not be null.";
   CHECK_GE(axis_, 0) << "Flatten op axis should >=0.";
+  op_param_ = &param_;
   return true;
 }
 
@@ -47,6 +47,7 @@ bool FusionElementwiseActivationOp::AttachImpl(const cpp::OpDesc& opdesc,
   // TODO(sangoly): support more activation types.
   CHECK(param_.act_type == "relu") << "Only relu activation be supported now";
 
+  op_param_ = &param_;
   return true;
 }
 
@@ -52,6 +52,10 @@ bool LayerNormOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   CHECK(param_.Y);
   CHECK(param_.Mean);
   CHECK(param_.Variance);
+  if (opdesc.HasInput("Residual")) {
+    param_.Residual = scope->FindVar(opdesc.Input("Residual").front())
+                          ->GetMutable<lite::Tensor>();
+  }
   if (opdesc.HasInput("Scale")) {
     param_.Scale = scope->FindVar(opdesc.Input("Scale").front())
                        ->GetMutable<lite::Tensor>();
@@ -32,7 +32,12 @@ bool LookupTableDequantOpLite::CheckShape() const {
 
   CHECK_EQ_OR_FALSE(table_dims.size(), 2);
   CHECK_EQ_OR_FALSE(ids_dims[ids_rank - 1], 1);
-  CHECK_GT_OR_FALSE(table_dims[1], 2);
+  if (param_.quant_bits == 16) {
+    CHECK_GT_OR_FALSE(table_dims[1], 0);
+  } else {
+    CHECK_EQ_OR_FALSE(param_.quant_bits, 8);
+    CHECK_GT_OR_FALSE(table_dims[1], 2);
+  }
   return true;
 }
 
@@ -42,7 +47,11 @@ bool LookupTableDequantOpLite::InferShapeImpl() const {
 
   auto out_dims = ids_dims;
   int ids_rank = ids_dims.size();
-  out_dims[ids_rank - 1] = (table_dims[1] - 2) * 4;
+  if (param_.quant_bits == 16) {
+    out_dims[ids_rank - 1] = table_dims[1] * 2;
+  } else {
+    out_dims[ids_rank - 1] = (table_dims[1] - 2) * 4;
+  }
 
   param_.Out->Resize(out_dims);
   param_.Out->set_lod(param_.Ids->lod());
@@ -60,6 +69,9 @@ bool LookupTableDequantOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   param_.Out = scope->FindVar(out)->GetMutable<lite::Tensor>();
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  if (op_desc.HasAttr("quant_bits")) {
+    param_.quant_bits = op_desc.GetAttr<int>("quant_bits");
+  }
 
   return true;
 }
@@ -57,6 +57,7 @@ class MulOpLite : public OpLite {
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
 
+    op_param_ = &param_;
     return true;
   }
 
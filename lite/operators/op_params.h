@@ -22,6 +22,7 @@
 #include "lite/core/tensor.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
 #include "lite/model_parser/desc_apis.h"
 #include "lite/utils/all.h"
 #include "lite/utils/variant.h"
@@ -35,8 +36,18 @@ namespace operators {
 
 struct ParamBase {
  public:
-  const std::vector<Tensor*>* input_tensor_ptrs() const { return nullptr; }
-  std::vector<Tensor*>* output_tensor_ptrs() { return nullptr; }
+  virtual ~ParamBase() = default;
+  // The tensors the output shapes are inferred from and the tensors whose
+  // shapes are inferred, used by OpLite to cache InferShape results.
+  virtual const std::vector<const Tensor*>* input_tensor_ptrs() {
+    return nullptr;
+  }
+  virtual const std::vector<Tensor*>* output_tensor_ptrs() { return nullptr; }
+  // Drops the lists above, they are rebuilt from the rebound tensors.
+  void ClearTensorPtrsCache() {
+    input_tensor_ptrs_cache_.reset();
+    output_tensor_ptrs_cache_.reset();
+  }
 
  protected:
   std::shared_ptr<std::vector<const Tensor*>> input_tensor_ptrs_cache_{nullptr};
@@ -108,15 +119,15 @@ struct FcParam : ParamBase {
   WITH_INT8_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({input}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -160,15 +171,15 @@ struct MulParam : ParamBase {
   WITH_INT8_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x, y}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -243,15 +254,15 @@ struct ScaleParam : ParamBase {
   bool bias_after_scale{true};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -265,15 +276,15 @@ struct SoftmaxParam : ParamBase {
   int axis{-1};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -292,16 +303,17 @@ struct ReshapeParam : ParamBase {
   bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
-      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(
+          new std::vector<lite::Tensor*>({output, xshape}));
     }
     return output_tensor_ptrs_cache_.get();
   }
@@ -314,8 +326,8 @@ struct ConcatParam : ParamBase {
   int axis{0};
   lite::Tensor* axis_tensor{};
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       std::vector<const Tensor*> vec;
       for (auto in : x) {
         vec.push_back(in);
@@ -325,8 +337,8 @@ struct ConcatParam : ParamBase {
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -406,15 +418,15 @@ struct ConvParam : ParamBase {
 
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -440,16 +452,17 @@ struct BatchNormParam : ParamBase {
   DataLayoutType data_layout{DATALAYOUT(kNCHW)};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
-      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({y}));
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>(
+          {y, mean_out, variance_out, saved_mean, saved_variance}));
     }
     return output_tensor_ptrs_cache_.get();
   }
@@ -479,15 +492,15 @@ struct PoolParam : ParamBase {
   WITH_INT8_CONFIG
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -510,7 +523,7 @@ struct DropoutParam : ParamBase {
 struct SplitParam : ParamBase {
   lite::Tensor* x{};
   std::vector<lite::Tensor*> output{};
-  lite::Tensor* axis_tensor;
+  lite::Tensor* axis_tensor{};
   std::vector<lite::Tensor*> sections_tensor_list{};
 
   int axis{-1};
@@ -518,15 +531,15 @@ struct SplitParam : ParamBase {
   std::vector<int> sections;
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -544,16 +557,17 @@ struct TransposeParam : ParamBase {
   std::string data_format{"AnyLayout"};
   ///////////////////////////////////////////////////////////////////////////////////
   //  // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
-      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({output}));
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(
+          new std::vector<lite::Tensor*>({output, xshape}));
     }
     return output_tensor_ptrs_cache_.get();
   }
@@ -571,15 +585,15 @@ struct ElementwiseParam : ParamBase {
   float y_input_scale{1.0};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X, Y}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -862,11 +876,24 @@ struct LookupTableParam : ParamBase {
   int64_t padding_idx{-1};
 };
 
+// lookup_table followed by sequence_pool(SUM), Out[i] is the sum of the
+// embeddings of the ids in the i-th sequence of Ids.
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  std::string combiner{"sum"};
+};
+
 struct LookupTableDequantParam : ParamBase {
   lite::Tensor* W{nullptr};
   lite::Tensor* Ids{nullptr};
   lite::Tensor* Out{nullptr};
   int64_t padding_idx{-1};
+  // 8: every row of W is [min, max, uint8 x width] packed into floats.
+  // 16: every row of W is float16 x width packed into floats.
+  int quant_bits{8};
 };
 
 struct Im2SequenceParam : ParamBase {
@@ -884,15 +911,15 @@ struct SequenceSoftmaxParam : ParamBase {
   lite::Tensor* Out{};
   ///////////////////////////////////////////////////////////////////////////////////
   //  // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -908,6 +935,9 @@ struct NormParam : ParamBase {
 };
 struct LayerNormParam : ParamBase {
   const lite::Tensor* X{};
+  // Optional, set by lite_elementwise_add_layer_norm_fuse_pass: the second
+  // operand of an elementwise_add(axis=-1) that is folded into X.
+  const lite::Tensor* Residual{};
   const lite::Tensor* Scale{};
   const lite::Tensor* Bias{};
   lite::Tensor* Y{};
@@ -934,7 +964,11 @@ struct CompareParam : ParamBase {
 struct WhileParam : ParamBase {
   Scope* scope{};
   Tensor* cond{};
+  cpp::ProgramDesc* program_desc{};
   cpp::BlockDesc* sub_block{};
+  // The places the ops of the sub block pick their kernels from, empty if
+  // the op was created without valid places, e.g. by the light predictor.
+  std::vector<Place> valid_places{};
   std::vector<Tensor*> x{};
   std::vector<Tensor*> outs{};
 };
@@ -1135,15 +1169,15 @@ struct SliceParam : ParamBase {
   lite::Tensor* EndsTensor{nullptr};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -1195,18 +1229,20 @@ struct SqueezeParam : ParamBase {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
-      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(
+          new std::vector<lite::Tensor*>({Out, XShape}));
     }
     return output_tensor_ptrs_cache_.get();
   }
@@ -1219,18 +1255,20 @@ struct UnsqueezeParam : ParamBase {
   std::vector<int> axes{};
   const lite::Tensor* axes_tensor{};
   std::vector<const lite::Tensor*> axes_tensor_vct{};
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
-      output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
+      output_tensor_ptrs_cache_.reset(
+          new std::vector<lite::Tensor*>({Out, XShape}));
     }
     return output_tensor_ptrs_cache_.get();
   }
@@ -1253,15 +1291,15 @@ struct MatMulParam : ParamBase {
   float alpha{1.0f};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
-  const std::vector<const Tensor*>* input_tensor_ptrs() {
-    if (UNLIKELY(input_tensor_ptrs_cache_)) {
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (UNLIKELY(!input_tensor_ptrs_cache_)) {
       input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({X, Y}));
     }
     return input_tensor_ptrs_cache_.get();
   }
   // get a vector of output tensors
-  const std::vector<Tensor*>* output_tensor_ptrs() {
-    if (UNLIKELY(output_tensor_ptrs_cache_)) {
+  const std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (UNLIKELY(!output_tensor_ptrs_cache_)) {
       output_tensor_ptrs_cache_.reset(new std::vector<lite::Tensor*>({Out}));
     }
     return output_tensor_ptrs_cache_.get();
@@ -1386,9 +1424,12 @@ struct ConditionalBlockParam : ParamBase {
   const lite::Tensor* cond{};
   std::vector<lite::Tensor*> x{};
   std::vector<lite::Tensor*> outs{};
+  cpp::ProgramDesc* program_desc{};
   cpp::BlockDesc* sub_block{};
   Scope* scope{};
   bool is_scalar_condition{};
+  // Same as WhileParam::valid_places.
+  std::vector<Place> valid_places{};
 };
 
 struct CollectFpnProposalsParam : ParamBase {
@@ -84,6 +84,11 @@ class PoolOpLite : public OpLite {
     }
     param_.paddings = std::make_shared<std::vector<int>>(paddings);
 
+    // Global pooling and "SAME" paddings update the param from the input shape
+    // in InferShapeImpl.
+    if (!param_.global_pooling && padding_algorithm_ != "SAME") {
+      op_param_ = &param_;
+    }
     return true;
   }
 
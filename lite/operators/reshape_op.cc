@@ -88,6 +88,9 @@ bool ReshapeOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   if (opdesc.HasAttr("inplace")) {
     param_.inplace = opdesc.GetAttr<bool>("inplace");
   }
+  if (param_.shape_tensor_vct.empty() && param_.shape_tensor == nullptr) {
+    op_param_ = &param_;
+  }
   return true;
 }
 
@@ -39,6 +39,7 @@ bool ScaleOp::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   param_.bias_after_scale = op_desc.GetAttr<bool>("bias_after_scale");
   CHECK(param_.x);
   CHECK(param_.output);
+  op_param_ = &param_;
   return true;
 }
 
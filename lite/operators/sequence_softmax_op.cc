@@ -40,6 +40,7 @@ bool SequenceSoftmaxOp::AttachImpl(const cpp::OpDesc &opdesc,
       scope->FindVar(opdesc.Output("Out").front())->GetMutable<lite::Tensor>();
   CHECK(param_.X);
   CHECK(param_.Out);
+  op_param_ = &param_;
   return true;
 }
 
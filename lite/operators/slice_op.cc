@@ -161,6 +161,10 @@ bool SliceOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
     CHECK_EQ(ends_size, param_.axes.size())
         << "The size of ends must be equal to the size of axes.";
   }
+  if (param_.StartsTensor == nullptr && param_.EndsTensor == nullptr &&
+      param_.StartsTensorList.empty() && param_.EndsTensorList.empty()) {
+    op_param_ = &param_;
+  }
   return true;
 }
 
@@ -50,6 +50,7 @@ bool SoftmaxOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   }
   CHECK(param_.x);
   CHECK(param_.output);
+  op_param_ = &param_;
   return true;
 }
 
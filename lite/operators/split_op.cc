@@ -104,6 +104,9 @@ bool SplitOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
           *(var->GetMutable<std::vector<lite::Tensor *>>());
     }
   }
+  if (param_.axis_tensor == nullptr && param_.sections_tensor_list.empty()) {
+    op_param_ = &param_;
+  }
   return true;
 }
 
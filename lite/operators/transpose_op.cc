@@ -85,6 +85,7 @@ bool TransposeOp::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   if (op_desc.HasAttr("data_format")) {
     param_.data_format = op_desc.GetAttr<std::string>("data_format");
   }
+  op_param_ = &param_;
   return true;
 }
 
@@ -167,6 +168,7 @@ bool Transpose2Op::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
     auto xshape_var = scope->FindVar(op_desc.Output("XShape").front());
     param_.xshape = xshape_var->GetMutable<lite::Tensor>();
   }
+  op_param_ = &param_;
   return true;
 }
 
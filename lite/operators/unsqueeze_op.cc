@@ -99,6 +99,9 @@ bool UnsqueezeOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   if (opdesc.HasAttr("axes")) {
     param_.axes = opdesc.GetAttr<std::vector<int>>("axes");
   }
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
 
   if (opdesc.HasInput("AxesTensor") && opdesc.Input("AxesTensor").size() > 0) {
     auto var = scope->FindVar(opdesc.Input("AxesTensor").front());
@@ -120,6 +123,9 @@ bool UnsqueezeOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   }
   CHECK(param_.X) << "Input(X) of UnsqueezeOp should not be null.";
   CHECK(param_.Out) << "Output(Out) of UnsqueezeOp should not be null.";
+  if (param_.axes_tensor == nullptr && param_.axes_tensor_vct.empty()) {
+    op_param_ = &param_;
+  }
   return true;
 }
 
@@ -39,6 +39,7 @@ bool WhileOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   for (auto var : outs) {
     // param_.outs.push_back(scope->FindVar(var)->GetMutable<lite::Tensor>());
   }
+  param_.program_desc = program_desc_;
   param_.sub_block = sub_block_;
 
   auto condition = op_desc.Input("Condition");
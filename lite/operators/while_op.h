@@ -34,13 +34,20 @@ class WhileOpLite : public OpLite {
 
   bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
 
-  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+  void AttachKernel(KernelBase *kernel) override {
+    // The valid places are set before the kernels are created.
+    param_.valid_places = valid_places_;
+    kernel->SetParam(param_);
+  }
   std::string DebugString() const override { return "while"; }
   void SetSubBlock(cpp::BlockDesc *desc) { sub_block_ = desc; }
+  // The program holding the sub block, for the control flow ops nested in it.
+  void SetProgramDesc(cpp::ProgramDesc *desc) { program_desc_ = desc; }
 
  private:
   mutable WhileParam param_;
-  cpp::BlockDesc *sub_block_;
+  cpp::ProgramDesc *program_desc_{nullptr};
+  cpp::BlockDesc *sub_block_{nullptr};
 };
 
 }  // namespace operators
@@ -321,6 +321,10 @@ class MulticlassNmsComputeTester : public arena::TestCase {
   int background_label_{-1};
   float score_threshold_{0.01f};
   bool normalized_{false};
+  // The images in the boxes and the [M, C] scores, empty for [N, C, M].
+  LoD boxes_lod_{};
+  // Overlapping boxes and tied scores instead of evenly spaced values.
+  bool random_data_{false};
 
  public:
   MulticlassNmsComputeTester(const Place& place,
@@ -333,7 +337,8 @@ class MulticlassNmsComputeTester : public arena::TestCase {
                              int nms_top_k = 1,
                              int background_label = 1,
                              float score_threshold = 0.01f,
-                             bool normalized = false)
+                             bool normalized = false,
+                             const LoD& boxes_lod = {})
       : TestCase(place, alias),
         bboxes_dims_(bboxes_dims),
         scores_dims_(scores_dims),
@@ -343,7 +348,10 @@ class MulticlassNmsComputeTester : public arena::TestCase {
         nms_top_k_(nms_top_k),
         background_label_(background_label),
         score_threshold_(score_threshold),
-        normalized_(normalized) {}
+        normalized_(normalized),
+        boxes_lod_(boxes_lod) {}
+
+  void set_random_data(bool random_data) { random_data_ = random_data; }
 
   void RunBaseline(Scope* scope) override {
     auto* boxes = scope->FindTensor(bboxes_);
@@ -446,15 +454,41 @@ class MulticlassNmsComputeTester : public arena::TestCase {
   }
 
   void PrepareData() override {
+    if (!random_data_) {
+      std::vector<float> bboxes(bboxes_dims_.production());
+      for (int i = 0; i < bboxes_dims_.production(); ++i) {
+        bboxes[i] = i * 1. / bboxes_dims_.production();
+      }
+      SetCommonTensor(bboxes_, bboxes_dims_, bboxes.data());
+
+      std::vector<float> scores(scores_dims_.production());
+      for (int i = 0; i < scores_dims_.production(); ++i) {
+        scores[i] = i * 1. / scores_dims_.production();
+      }
+      SetCommonTensor(scores_, scores_dims_, scores.data());
+      return;
+    }
+    // Small boxes spread over a small area, so many of them overlap.
     std::vector<float> bboxes(bboxes_dims_.production());
-    for (int i = 0; i < bboxes_dims_.production(); ++i) {
-      bboxes[i] = i * 1. / bboxes_dims_.production();
+    fill_data_rand(bboxes.data(), 0.f, 1.f, bboxes.size());
+    for (size_t i = 0; i < bboxes.size(); i += 4) {
+      bboxes[i] *= 20.f;
+      bboxes[i + 1] *= 20.f;
+      bboxes[i + 2] = bboxes[i] + 1.f + bboxes[i + 2] * 6.f;
+      bboxes[i + 3] = bboxes[i + 1] + 1.f + bboxes[i + 3] * 6.f;
+      if (normalized_) {
+        for (int j = 0; j < 4; ++j) {
+          bboxes[i + j] /= 30.f;
+        }
+      }
     }
-    SetCommonTensor(bboxes_, bboxes_dims_, bboxes.data());
+    SetCommonTensor(bboxes_, bboxes_dims_, bboxes.data(), boxes_lod_);
 
+    // Scores on a coarse grid, so there are plenty of ties.
     std::vector<float> scores(scores_dims_.production());
-    for (int i = 0; i < scores_dims_.production(); ++i) {
-      scores[i] = i * 1. / scores_dims_.production();
+    fill_data_rand(scores.data(), 0.f, 1.f, scores.size());
+    for (auto& score : scores) {
+      score = std::floor(score * 20.f) / 20.f;
     }
     SetCommonTensor(scores_, scores_dims_, scores.data());
   }
@@ -473,6 +507,56 @@ void TestMulticlassNms(Place place, float abs_error) {
   }
 }
 
+void TestMulticlassNmsRandom(Place place, float abs_error) {
+  // Both the bitmask suppression, with a fixed threshold, and the adaptive
+  // threshold are compared against the reference, for the [N, C, M] scores
+  // and the [M, C] scores with the images in the LoD of the boxes.
+  const int class_num = 5;
+  const LoD lod{{0, 120, 300, 301}};
+  const int64_t lod_m = 301;
+  for (float nms_eta : {1.f, 0.9f}) {
+    float nms_threshold = nms_eta < 1.f ? 0.7f : 0.45f;
+    for (bool normalized : {false, true}) {
+      for (int nms_top_k : {-1, 100}) {
+        for (int keep_top_k : {-1, 60}) {
+          std::unique_ptr<MulticlassNmsComputeTester> tester(
+              new MulticlassNmsComputeTester(place,
+                                             "def",
+                                             DDim({2, 300, 4}),
+                                             DDim({2, class_num, 300}),
+                                             keep_top_k,
+                                             nms_threshold,
+                                             nms_eta,
+                                             nms_top_k,
+                                             0,
+                                             0.1f,
+                                             normalized));
+          tester->set_random_data(true);
+          arena::Arena arena(std::move(tester), place, abs_error);
+          arena.TestPrecision();
+
+          std::unique_ptr<MulticlassNmsComputeTester> lod_tester(
+              new MulticlassNmsComputeTester(place,
+                                             "def",
+                                             DDim({lod_m, class_num, 4}),
+                                             DDim({lod_m, class_num}),
+                                             keep_top_k,
+                                             nms_threshold,
+                                             nms_eta,
+                                             nms_top_k,
+                                             0,
+                                             0.1f,
+                                             normalized,
+                                             lod));
+          lod_tester->set_random_data(true);
+          arena::Arena lod_arena(std::move(lod_tester), place, abs_error);
+          lod_arena.TestPrecision();
+        }
+      }
+    }
+  }
+}
+
 TEST(multiclass_nms, precision) {
   float abs_error = 2e-5;
   Place place;
@@ -487,5 +571,11 @@ TEST(multiclass_nms, precision) {
   TestMulticlassNms(place, abs_error);
 }
 
+TEST(multiclass_nms, host_random) {
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
+  TestMulticlassNmsRandom(TARGET(kHost), 2e-5);
+#endif
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -89,6 +89,8 @@ TEST(ReadFromArray, precision) {
   float abs_error = 1e-5;
 #ifdef LITE_WITH_ARM
   place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kHost);
 #else
   return;
 #endif
@@ -153,7 +153,7 @@ class SliceComputeTester : public arena::TestCase {
     }
     out->Resize(out_dims);
     auto* out_data = out->mutable_data<float>();
-    slice_ref(input_data, in_dims.data(), axes_, starts_, ends_, out_data);
+    slice_ref(input_data, in_dims.Vectorize(), axes_, starts_, ends_, out_data);
   }
 
   void PrepareOpDesc(cpp::OpDesc* op_desc) {
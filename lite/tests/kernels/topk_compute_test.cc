@@ -111,6 +111,8 @@ TEST(Topk, precision) {
   abs_error = 1e-3;  // Using fp16 in NPU
 #elif defined(LITE_WITH_ARM)
   place = TARGET(kARM);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
 #else
   return;
 #endif